@@ -0,0 +1,102 @@
+/*
+File        : arena.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the per-file arena allocator.
+
+              This file contains the function definitions required to:
+               - Hand out aligned pieces of a chunk
+               - Add a bigger chunk when the current one is full
+               - Reset the arena between files, merging chunks
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "stats.h"
+
+//Function to add a chunk that can hold at least size bytes;
+static ARENACHUNK *arena_grow(ARENA *arena, size_t size)
+{
+    size_t chunk_size = arena -> chunk ? arena -> chunk -> size * 2 : ARENA_MIN_CHUNK;
+    while(chunk_size < size)
+    {
+        chunk_size *= 2;
+    }
+    ARENACHUNK *chunk = malloc(sizeof(ARENACHUNK) + chunk_size);
+    STATS_COUNT(stat_mallocs, 1);
+    if(chunk == NULL)
+    {
+        return NULL;
+    }
+    chunk -> next = arena -> chunk;
+    chunk -> size = chunk_size;
+    chunk -> used = 0;
+    arena -> chunk = chunk;
+    arena -> total += chunk_size;
+    return chunk;
+}
+
+//Function to take size bytes from the arena;
+void *arena_alloc(ARENA *arena, size_t size)
+{
+    ARENACHUNK *chunk = arena -> chunk;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    STATS_COUNT(stat_arena_allocs, 1);
+
+    if(chunk == NULL || chunk -> size - chunk -> used < size)
+    {
+        chunk = arena_grow(arena, size);
+        if(chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+    void *ptr = chunk -> data + chunk -> used;
+    chunk -> used += size;
+    return ptr;
+}
+
+//Function to take size zeroed bytes from the arena;
+void *arena_calloc(ARENA *arena, size_t size)
+{
+    void *ptr = arena_alloc(arena, size);
+    if(ptr != NULL)
+    {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+//Function to make all memory of the arena available again;
+void arena_reset(ARENA *arena)
+{
+    if(arena -> chunk == NULL)
+    {
+        return;
+    }
+    if(arena -> chunk -> next != NULL)
+    {
+        // the last file needed several chunks: keep one that fits all of it
+        size_t total = arena -> total;
+        arena_free(arena);
+        if(arena_grow(arena, total) == NULL)
+        {
+            return;
+        }
+    }
+    arena -> chunk -> used = 0;
+}
+
+//Function to give the memory of the arena back to the system;
+void arena_free(ARENA *arena)
+{
+    ARENACHUNK *chunk = arena -> chunk;
+    while(chunk != NULL)
+    {
+        ARENACHUNK *next = chunk -> next;
+        free(chunk);
+        chunk = next;
+    }
+    arena -> chunk = NULL;
+    arena -> total = 0;
+}
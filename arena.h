@@ -0,0 +1,56 @@
+/*
+File        : arena.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the per-file arena allocator.
+
+              All memory needed while one file is parsed or edited (the
+              tag body, the frame table, the rebuilt tag) is taken from
+              an ARENA by bumping a pointer. Nothing is freed one by one;
+              the arena is reset before the next file and its memory is
+              reused, so the hot path does no heap allocation at all once
+              the arena has grown to the size of the largest tag.
+
+              Key Components:
+               - ARENACHUNK : One block of memory handed out in pieces.
+               - ARENA      : List of chunks, newest first.
+
+              Notes:
+               - When a file needed more than one chunk, reset replaces
+                 them by a single chunk of the combined size.
+               - An ARENA is not thread safe; every worker owns one.
+*/
+#ifndef arena_h
+#define arena_h
+#include <stddef.h>
+
+#define ARENA_MIN_CHUNK (64 * 1024)
+#define ARENA_ALIGN 16
+
+typedef struct arena_chunk
+{
+	struct arena_chunk *next;    // older chunk
+	size_t size;                 // bytes in data
+	size_t used;                 // bytes already handed out
+	unsigned char data[];
+}ARENACHUNK;
+
+typedef struct arena
+{
+	ARENACHUNK *chunk;           // chunk allocations are taken from
+	size_t total;                // size of all chunks together
+}ARENA;
+
+//Function to take size bytes from the arena;
+void *arena_alloc(ARENA *arena, size_t size);
+
+//Function to take size zeroed bytes from the arena;
+void *arena_calloc(ARENA *arena, size_t size);
+
+//Function to make all memory of the arena available again;
+void arena_reset(ARENA *arena);
+
+//Function to give the memory of the arena back to the system;
+void arena_free(ARENA *arena);
+
+#endif
@@ -0,0 +1,221 @@
+/*
+File        : gencorpus.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Synthetic MP3 corpus generator for the benchmarks.
+
+              Writes <count> ID3v2.3 tagged files below <dir>, 1000 files
+              per sub directory. Everything is drawn from a seeded
+              xorshift generator, so the same seed always gives the same
+              corpus byte for byte.
+
+              Per file the generator varies:
+               - the order of the six tags read by the viewer
+               - the length of every text value
+               - the number of extra TXXX frames (frame count)
+               - an optional APIC frame of up to -p KiB
+               - the padding after the last frame
+               - the audio length (MPEG-1 Layer III frames, 128 kbit/s)
+
+              Usage:
+                  gencorpus -n <count> [-s <seed>] [-a <max audio KiB>]
+                            [-p <max APIC KiB>] <dir>
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define MPEG_FRAME_SIZE 417     // 128 kbit/s, 44100 Hz, no padding bit
+
+static unsigned long long rng_state;
+
+//Function to get the next pseudo random number;
+static unsigned int next_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned int)(rng_state >> 32);
+}
+
+//Function to get a pseudo random number in [low, high];
+static unsigned int random_range(unsigned int low, unsigned int high)
+{
+    return low + next_random() % (high - low + 1);
+}
+
+//Function to write a 32 bit value as big endian (or syncsafe);
+static void put_size(unsigned char *ptr, unsigned int size, int syncsafe)
+{
+    int shift = syncsafe ? 7 : 8;
+    unsigned int mask = syncsafe ? 0x7F : 0xFF;
+    ptr[0] = (size >> (3 * shift)) & mask;
+    ptr[1] = (size >> (2 * shift)) & mask;
+    ptr[2] = (size >> shift) & mask;
+    ptr[3] = size & mask;
+}
+
+//Function to append one frame header to the tag buffer;
+static unsigned char *put_frame_header(unsigned char *ptr, const char *id, unsigned int size)
+{
+    memcpy(ptr, id, 4);
+    put_size(ptr + 4, size, 0);
+    ptr[8] = ptr[9] = 0;
+    return ptr + 10;
+}
+
+//Function to append a text frame with a random printable value;
+static unsigned char *put_text_frame(unsigned char *ptr, const char *id, unsigned int length)
+{
+    unsigned int i;
+    ptr = put_frame_header(ptr, id, length + 1);
+    *ptr++ = 0;    // ISO-8859-1
+    for(i = 0; i < length; i++)
+    {
+        *ptr++ = 'a' + next_random() % 26;
+    }
+    return ptr;
+}
+
+//Function to generate one file;
+static int write_mp3file(const char *fname, unsigned int max_audio, unsigned int max_apic)
+{
+    static const char *tags[6] = {"TIT2", "TPE1", "TALB", "TYER", "TCON", "COMM"};
+    int order[6] = {0, 1, 2, 3, 4, 5};
+    unsigned int i;
+
+    unsigned int extra = random_range(0, 32);
+    unsigned int apic = (max_apic > 0 && next_random() % 4 == 0) ? random_range(1024, max_apic * 1024) : 0;
+    unsigned int padding = next_random() % 2 ? random_range(0, 4096) : 0;
+    unsigned int audio = random_range(1, max_audio * 1024 / MPEG_FRAME_SIZE);
+
+    unsigned char *tag = malloc(10 + 6 * 75 + extra * 60 + apic + 64 + padding);
+    if(tag == NULL)
+    {
+        return -1;
+    }
+
+    // shuffle the order of the tags
+    for(i = 5; i > 0; i--)
+    {
+        unsigned int j = next_random() % (i + 1);
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+
+    unsigned char *ptr = tag + 10;
+    for(i = 0; i < 6; i++)
+    {
+        const char *id = tags[order[i]];
+        if(strcmp(id, "TYER") == 0)
+        {
+            ptr = put_frame_header(ptr, id, 5);
+            ptr += sprintf((char *)ptr, "%c%u", 0, random_range(1950, 2025));
+        }
+        else if(strcmp(id, "COMM") == 0)
+        {
+            unsigned int length = random_range(0, 60);
+            ptr = put_frame_header(ptr, id, 5 + length);
+            memcpy(ptr, "\0eng\0", 5);
+            ptr += 5;
+            while(length--)
+            {
+                *ptr++ = 'a' + next_random() % 26;
+            }
+        }
+        else
+        {
+            ptr = put_text_frame(ptr, id, random_range(1, 60));
+        }
+    }
+    for(i = 0; i < extra; i++)
+    {
+        ptr = put_text_frame(ptr, "TXXX", random_range(2, 48));
+    }
+    if(apic > 0)
+    {
+        ptr = put_frame_header(ptr, "APIC", apic);
+        memcpy(ptr, "\0image/jpeg\0\3\0", 14);
+        memset(ptr + 14, 0xA5, apic - 14);
+        ptr += apic;
+    }
+    memset(ptr, 0, padding);
+    ptr += padding;
+
+    memcpy(tag, "ID3\3\0\0", 6);
+    put_size(tag + 6, (unsigned int)(ptr - tag) - 10, 1);
+
+    FILE *fptr = fopen(fname, "wb");
+    if(fptr == NULL)
+    {
+        free(tag);
+        return -1;
+    }
+    fwrite(tag, 1, ptr - tag, fptr);
+    free(tag);
+
+    unsigned char frame[MPEG_FRAME_SIZE] = {0xFF, 0xFB, 0x90, 0x64};
+    for(i = 0; i < audio; i++)
+    {
+        fwrite(frame, 1, sizeof(frame), fptr);
+    }
+    return fclose(fptr) == 0 ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long count = 0, i;
+    unsigned long long seed = 1;
+    unsigned int max_audio = 256, max_apic = 64;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:s:a:p:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': count = strtoul(optarg, NULL, 10); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'a': max_audio = (unsigned int)strtoul(optarg, NULL, 10); break;
+            case 'p': max_apic = (unsigned int)strtoul(optarg, NULL, 10); break;
+            default: count = 0; break;
+        }
+    }
+    if(count == 0 || optind != argc - 1 || max_audio == 0)
+    {
+        fprintf(stderr, "Usage : gencorpus -n <count> [-s <seed>] [-a <max audio KiB>] [-p <max APIC KiB>] <dir>\n");
+        return 1;
+    }
+    rng_state = seed * 0x9E3779B97F4A7C15ULL + 1;
+
+    const char *dir = argv[optind];
+    char fname[4096];
+    if(mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        perror(dir);
+        return 1;
+    }
+    for(i = 0; i < count; i++)
+    {
+        if(i % 1000 == 0)
+        {
+            snprintf(fname, sizeof(fname), "%s/%04lu", dir, i / 1000);
+            if(mkdir(fname, 0755) != 0 && errno != EEXIST)
+            {
+                perror(fname);
+                return 1;
+            }
+        }
+        snprintf(fname, sizeof(fname), "%s/%04lu/%06lu.mp3", dir, i / 1000, i);
+        if(write_mp3file(fname, max_audio, max_apic) != 0)
+        {
+            perror(fname);
+            return 1;
+        }
+    }
+    printf("%lu files written to %s (seed %llu)\n", count, dir, seed);
+    return 0;
+}
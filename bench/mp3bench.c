@@ -0,0 +1,242 @@
+/*
+File        : mp3bench.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Throughput benchmark for the view and edit paths.
+
+              All .mp3 files below <dir> are collected once (see
+              collect_mp3files()), then every path is run over the whole
+              list and reported as files/sec and MB/sec, where MB is the
+              total size of the files touched:
+
+               - view       : Mp3View() with its display sent to /dev/null
+               - edit-1     : edit_tag_data() replacing TIT2
+               - edit-3     : edit_tag_data() replacing TIT2, TPE1, TALB
+
+              Every path is measured twice:
+               - cold : the page cache of every file is dropped with
+                        posix_fadvise(POSIX_FADV_DONTNEED) before the run
+               - warm : the files were read just before the run
+
+              The edits write a value of the same length as the current
+              one, so the corpus keeps its layout across rounds and runs.
+              They are made durable like a batch run (-e -b): files are
+              queued in a COMMITGROUP that is flushed before the clock
+              of the round stops.
+
+              Usage:
+                  mp3bench [-r <rounds>] <dir>
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3edit.h"
+#include "mp3scan.h"
+
+typedef status (*BENCHFUNC)(const char *fname, unsigned int round);
+
+static unsigned long failures;
+static COMMITGROUP commit;      // edits are synced together, like a batch run
+
+//Function to get the current time in seconds;
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Function to view one file;
+static status bench_view(const char *fname, unsigned int round)
+{
+    MP3VIEW mp3view = {0};
+    (void)round;
+    mp3view.sample_mp3_fname = (char *)fname;
+    return Mp3View(&mp3view);
+}
+
+/* Function to replace <count> frames with a value of the same length;
+   the value is derived from the round so every run really writes */
+static status bench_edit(const char *fname, unsigned int round, unsigned int count)
+{
+    static const char *edit_tags[3] = {"TIT2", "TPE1", "TALB"};
+    MP3VIEW mp3view = {0};
+    MP3EDIT mp3edit = {0};
+    char values[3][64];
+    unsigned int i;
+
+    mp3view.sample_mp3_fname = (char *)fname;
+    if(parse_mp3file(&mp3view) != E_SUCCESS)
+    {
+        close_mp3file(&mp3view);
+        return E_FAILURE;
+    }
+    for(i = 0; i < count; i++)
+    {
+        unsigned int length = mp3view.mp3viewinfo[i].length;
+        if(length >= sizeof(values[i]))
+        {
+            length = sizeof(values[i]) - 1;
+        }
+        memset(values[i], 'a' + round % 26, length);
+        values[i][length] = '\0';
+        add_frame_edit(&mp3edit, edit_tags[i], values[i]);
+    }
+    close_mp3file(&mp3view);
+
+    mp3edit.input_file = (char *)fname;
+    mp3edit.commit = &commit;
+    if(open_files(&mp3edit) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    return edit_tag_data(&mp3edit);
+}
+
+static status bench_edit_single(const char *fname, unsigned int round)
+{
+    return bench_edit(fname, round, 1);
+}
+
+static status bench_edit_multi(const char *fname, unsigned int round)
+{
+    return bench_edit(fname, round, 3);
+}
+
+//Function to drop (cold) or load (warm) the page cache of every file;
+static void prepare_cache(MP3SCAN *mp3scan, int cold)
+{
+    static char buffer[1 << 16];
+    size_t i;
+
+    if(cold)
+    {
+        sync();     // dirty pages are not dropped
+    }
+    for(i = 0; i < mp3scan -> count; i++)
+    {
+        int fd = open(mp3scan -> files[i], O_RDONLY);
+        if(fd < 0)
+        {
+            continue;
+        }
+        if(cold)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        else
+        {
+            while(read(fd, buffer, sizeof(buffer)) > 0)
+            {
+            }
+        }
+        close(fd);
+    }
+}
+
+//Function to run one path over all files and report the throughput;
+static void run_bench(FILE *report, MP3SCAN *mp3scan, const char *name, BENCHFUNC func,
+                      unsigned int rounds, int cold, unsigned long long bytes)
+{
+    static unsigned int round;
+    double best = 0;
+    unsigned int r;
+    size_t i;
+
+    for(r = 0; r < rounds; r++)
+    {
+        prepare_cache(mp3scan, cold);
+        round++;
+        double start = now();
+        for(i = 0; i < mp3scan -> count; i++)
+        {
+            if(func(mp3scan -> files[i], round) != E_SUCCESS)
+            {
+                failures++;
+            }
+        }
+        if(commit_group_flush(&commit) != E_SUCCESS)
+        {
+            failures++;
+        }
+        double elapsed = now() - start;
+        if(r == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    fprintf(report, "%-8s %-5s %10zu %12.0f %10.1f %10.3f\n", name, cold ? "cold" : "warm",
+            mp3scan -> count, mp3scan -> count / best, bytes / best / 1e6, best);
+    fflush(report);
+}
+
+int main(int argc, char *argv[])
+{
+    MP3SCAN mp3scan = {0};
+    unsigned int rounds = 3;
+    unsigned long long bytes = 0;
+    size_t i;
+    int opt;
+
+    while((opt = getopt(argc, argv, "r:")) != -1)
+    {
+        if(opt != 'r' || (rounds = (unsigned int)strtoul(optarg, NULL, 10)) == 0)
+        {
+            rounds = 0;
+            break;
+        }
+    }
+    if(rounds == 0 || optind != argc - 1)
+    {
+        fprintf(stderr, "Usage : mp3bench [-r <rounds>] <dir>\n");
+        return 1;
+    }
+    if(collect_mp3files(&mp3scan, argv[optind]) != E_SUCCESS || mp3scan.count == 0)
+    {
+        fprintf(stderr, "No mp3 files found below %s\n", argv[optind]);
+        free_scan(&mp3scan);
+        return 1;
+    }
+    for(i = 0; i < mp3scan.count; i++)
+    {
+        struct stat st;
+        if(stat(mp3scan.files[i], &st) == 0)
+        {
+            bytes += st.st_size;
+        }
+    }
+
+    // the report keeps the real stdout, the viewer output goes to /dev/null
+    FILE *report = fdopen(dup(STDOUT_FILENO), "w");
+    if(report == NULL || freopen("/dev/null", "w", stdout) == NULL)
+    {
+        perror("stdout");
+        return 1;
+    }
+
+    commit_group_init(&commit, COMMIT_GROUP_SIZE);
+    fprintf(report, "%zu files, %.1f MB, best of %u rounds\n", mp3scan.count, bytes / 1e6, rounds);
+    fprintf(report, "%-8s %-5s %10s %12s %10s %10s\n", "path", "cache", "files", "files/sec", "MB/sec", "seconds");
+    run_bench(report, &mp3scan, "view", bench_view, rounds, 1, bytes);
+    run_bench(report, &mp3scan, "view", bench_view, rounds, 0, bytes);
+    run_bench(report, &mp3scan, "edit-1", bench_edit_single, rounds, 1, bytes);
+    run_bench(report, &mp3scan, "edit-1", bench_edit_single, rounds, 0, bytes);
+    run_bench(report, &mp3scan, "edit-3", bench_edit_multi, rounds, 1, bytes);
+    run_bench(report, &mp3scan, "edit-3", bench_edit_multi, rounds, 0, bytes);
+    if(failures > 0)
+    {
+        fprintf(report, "%lu file operations failed\n", failures);
+    }
+
+    commit_group_free(&commit);
+    fclose(report);
+    free_scan(&mp3scan);
+    return failures > 0 ? 1 : 0;
+}
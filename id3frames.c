@@ -0,0 +1,42 @@
+/*
+File        : id3frames.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the table of known ID3v2 frame ids.
+
+              This file contains the lookups into the generated perfect
+              hash of id3frametable.h (see tools/genframes.c).
+
+              Notes:
+               - A lookup is one multiply, one load and one compare; no
+                 string is compared and nothing is probed.
+*/
+#include <stddef.h>
+#include "id3frames.h"
+#include "id3frametable.h"
+
+//Function to find a frame id in the table (NULL when it is not known);
+const FRAMESLOT *frame_lookup(unsigned int id)
+{
+    const FRAMESLOT *slot = &frame_slots[(id * FRAME_HASH_MULTIPLIER) >> FRAME_HASH_SHIFT];
+    return slot -> id == id && id != 0 ? slot : NULL;
+}
+
+//Function to get the details of a known frame;
+const FRAMEDETAIL *frame_detail(const FRAMESLOT *slot)
+{
+    return &frame_details[slot -> detail];
+}
+
+/* Function to check that the editor can rewrite a frame: text frames
+   ([encoding][text]) and comments ([encoding][language][description][text]);
+   an unknown T*** id is a text frame by the rules of the standard */
+int frame_is_editable(unsigned int id)
+{
+    const FRAMESLOT *slot = frame_lookup(id);
+    if(slot == NULL)
+    {
+        return (id >> 24) == 'T' && id != FRAME_ID('T', 'X', 'X', 'X');
+    }
+    return slot -> kind == frame_text || slot -> kind == frame_comment;
+}
@@ -0,0 +1,79 @@
+/*
+File        : id3frames.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the table of known ID3v2 frame ids.
+
+              This file contains the structure definitions and function
+              prototypes used to go from a frame id, read as a 32 bit
+              integer (see frame_id() and FRAME_ID() in id3tag.h), to what
+              the program knows about the frame, without comparing any
+              strings.
+
+              Key Components:
+               - FRAMESLOT  : One slot of the perfect hash: the frame id,
+                              the tag versions that define it and how its
+                              payload is decoded (FrameKind). 8 bytes, so
+                              the whole table stays in a few cache lines
+                              per lookup.
+               - FRAMEDETAIL: The rarely needed rest: the id as text, the
+                              v2.3/v2.4 equivalent of a v2.2 id and the
+                              label of the viewer.
+
+              Lookup:
+               slot = (id * FRAME_HASH_MULTIPLIER) >> FRAME_HASH_SHIFT
+               The id is known if the slot holds the same id. The table
+               and the multiplier are generated by tools/genframes.c into
+               id3frametable.h, which make rebuilds when the generator
+               changes.
+
+              Notes:
+               - v2.2 ids are 3 characters; their integer is the three
+                 characters and a zero byte (FRAME_ID('T', 'T', '2', 0)).
+               - Unknown ids (experimental or misspelt frames) are not an
+                 error, frame_lookup() just returns NULL for them.
+*/
+#ifndef id3frames_h
+#define id3frames_h
+#include "types.h"
+#include "id3tag.h"
+
+#define ID3_V22 0x01
+#define ID3_V23 0x02
+#define ID3_V24 0x04
+
+typedef enum
+{
+	frame_binary,        // not text (APIC, PRIV, ...)
+	frame_text,          // encoding byte, text (T*** but TXXX)
+	frame_user_text,     // encoding byte, description, text (TXXX)
+	frame_url,           // ISO-8859-1 URL without encoding byte (W*** but WXXX)
+	frame_user_url,      // encoding byte, description, ISO-8859-1 URL (WXXX)
+	frame_comment        // encoding byte, language, description, text (COMM, USLT)
+}FrameKind;
+
+typedef struct frameslot
+{
+	unsigned int id;              // frame id as an integer, 0 for an empty slot
+	unsigned char versions;       // ID3_V22 | ID3_V23 | ID3_V24
+	unsigned char kind;           // FrameKind
+	unsigned short detail;        // index into the details
+}FRAMESLOT;
+
+typedef struct framedetail
+{
+	const char *name;             // the id as text
+	unsigned int canonical;       // v2.3/v2.4 id with the same meaning (the id itself unless v2.2)
+	const char *label;            // label shown by the viewer, NULL to show the id
+}FRAMEDETAIL;
+
+//Function to find a frame id in the table (NULL when it is not known);
+const FRAMESLOT *frame_lookup(unsigned int id);
+
+//Function to get the details of a known frame;
+const FRAMEDETAIL *frame_detail(const FRAMESLOT *slot);
+
+//Function to check that the editor can rewrite a frame (text and comment frames);
+int frame_is_editable(unsigned int id);
+
+#endif
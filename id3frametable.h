@@ -0,0 +1,372 @@
+/*
+File        : id3frametable.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Frame id table, generated by tools/genframes.c; do not edit.
+
+              173 frame ids in a perfect hash of 1024 slots:
+               slot = (id * FRAME_HASH_MULTIPLIER) >> FRAME_HASH_SHIFT
+              Included by id3frames.c only.
+*/
+#ifndef id3frametable_h
+#define id3frametable_h
+
+#define FRAME_HASH_MULTIPLIER 0x642679C9U
+#define FRAME_HASH_SHIFT 22
+#define FRAME_HASH_SIZE 1024
+
+static const FRAMEDETAIL frame_details[173] =
+{
+    {"AENC", FRAME_ID('A', 'E', 'N', 'C'), NULL},
+    {"APIC", FRAME_ID('A', 'P', 'I', 'C'), NULL},
+    {"COMM", FRAME_ID('C', 'O', 'M', 'M'), "COMMENT"},
+    {"COMR", FRAME_ID('C', 'O', 'M', 'R'), NULL},
+    {"ENCR", FRAME_ID('E', 'N', 'C', 'R'), NULL},
+    {"ETCO", FRAME_ID('E', 'T', 'C', 'O'), NULL},
+    {"GEOB", FRAME_ID('G', 'E', 'O', 'B'), NULL},
+    {"GRID", FRAME_ID('G', 'R', 'I', 'D'), NULL},
+    {"LINK", FRAME_ID('L', 'I', 'N', 'K'), NULL},
+    {"MCDI", FRAME_ID('M', 'C', 'D', 'I'), NULL},
+    {"MLLT", FRAME_ID('M', 'L', 'L', 'T'), NULL},
+    {"OWNE", FRAME_ID('O', 'W', 'N', 'E'), NULL},
+    {"PCNT", FRAME_ID('P', 'C', 'N', 'T'), NULL},
+    {"POPM", FRAME_ID('P', 'O', 'P', 'M'), NULL},
+    {"POSS", FRAME_ID('P', 'O', 'S', 'S'), NULL},
+    {"PRIV", FRAME_ID('P', 'R', 'I', 'V'), NULL},
+    {"RBUF", FRAME_ID('R', 'B', 'U', 'F'), NULL},
+    {"RVRB", FRAME_ID('R', 'V', 'R', 'B'), NULL},
+    {"SYLT", FRAME_ID('S', 'Y', 'L', 'T'), NULL},
+    {"SYTC", FRAME_ID('S', 'Y', 'T', 'C'), NULL},
+    {"TALB", FRAME_ID('T', 'A', 'L', 'B'), "ALBUM"},
+    {"TBPM", FRAME_ID('T', 'B', 'P', 'M'), NULL},
+    {"TCOM", FRAME_ID('T', 'C', 'O', 'M'), NULL},
+    {"TCON", FRAME_ID('T', 'C', 'O', 'N'), "MUSIC"},
+    {"TCOP", FRAME_ID('T', 'C', 'O', 'P'), NULL},
+    {"TDLY", FRAME_ID('T', 'D', 'L', 'Y'), NULL},
+    {"TENC", FRAME_ID('T', 'E', 'N', 'C'), NULL},
+    {"TEXT", FRAME_ID('T', 'E', 'X', 'T'), NULL},
+    {"TFLT", FRAME_ID('T', 'F', 'L', 'T'), NULL},
+    {"TIT1", FRAME_ID('T', 'I', 'T', '1'), NULL},
+    {"TIT2", FRAME_ID('T', 'I', 'T', '2'), "TITLE"},
+    {"TIT3", FRAME_ID('T', 'I', 'T', '3'), NULL},
+    {"TKEY", FRAME_ID('T', 'K', 'E', 'Y'), NULL},
+    {"TLAN", FRAME_ID('T', 'L', 'A', 'N'), NULL},
+    {"TLEN", FRAME_ID('T', 'L', 'E', 'N'), NULL},
+    {"TMED", FRAME_ID('T', 'M', 'E', 'D'), NULL},
+    {"TOAL", FRAME_ID('T', 'O', 'A', 'L'), NULL},
+    {"TOFN", FRAME_ID('T', 'O', 'F', 'N'), NULL},
+    {"TOLY", FRAME_ID('T', 'O', 'L', 'Y'), NULL},
+    {"TOPE", FRAME_ID('T', 'O', 'P', 'E'), NULL},
+    {"TOWN", FRAME_ID('T', 'O', 'W', 'N'), NULL},
+    {"TPE1", FRAME_ID('T', 'P', 'E', '1'), "ARTIST"},
+    {"TPE2", FRAME_ID('T', 'P', 'E', '2'), NULL},
+    {"TPE3", FRAME_ID('T', 'P', 'E', '3'), NULL},
+    {"TPE4", FRAME_ID('T', 'P', 'E', '4'), NULL},
+    {"TPOS", FRAME_ID('T', 'P', 'O', 'S'), NULL},
+    {"TPUB", FRAME_ID('T', 'P', 'U', 'B'), NULL},
+    {"TRCK", FRAME_ID('T', 'R', 'C', 'K'), NULL},
+    {"TRSN", FRAME_ID('T', 'R', 'S', 'N'), NULL},
+    {"TRSO", FRAME_ID('T', 'R', 'S', 'O'), NULL},
+    {"TSRC", FRAME_ID('T', 'S', 'R', 'C'), NULL},
+    {"TSSE", FRAME_ID('T', 'S', 'S', 'E'), NULL},
+    {"TXXX", FRAME_ID('T', 'X', 'X', 'X'), NULL},
+    {"UFID", FRAME_ID('U', 'F', 'I', 'D'), NULL},
+    {"USER", FRAME_ID('U', 'S', 'E', 'R'), NULL},
+    {"USLT", FRAME_ID('U', 'S', 'L', 'T'), NULL},
+    {"WCOM", FRAME_ID('W', 'C', 'O', 'M'), NULL},
+    {"WCOP", FRAME_ID('W', 'C', 'O', 'P'), NULL},
+    {"WOAF", FRAME_ID('W', 'O', 'A', 'F'), NULL},
+    {"WOAR", FRAME_ID('W', 'O', 'A', 'R'), NULL},
+    {"WOAS", FRAME_ID('W', 'O', 'A', 'S'), NULL},
+    {"WORS", FRAME_ID('W', 'O', 'R', 'S'), NULL},
+    {"WPAY", FRAME_ID('W', 'P', 'A', 'Y'), NULL},
+    {"WPUB", FRAME_ID('W', 'P', 'U', 'B'), NULL},
+    {"WXXX", FRAME_ID('W', 'X', 'X', 'X'), NULL},
+    {"EQUA", FRAME_ID('E', 'Q', 'U', 'A'), NULL},
+    {"IPLS", FRAME_ID('I', 'P', 'L', 'S'), NULL},
+    {"RVAD", FRAME_ID('R', 'V', 'A', 'D'), NULL},
+    {"TDAT", FRAME_ID('T', 'D', 'A', 'T'), NULL},
+    {"TIME", FRAME_ID('T', 'I', 'M', 'E'), NULL},
+    {"TORY", FRAME_ID('T', 'O', 'R', 'Y'), NULL},
+    {"TRDA", FRAME_ID('T', 'R', 'D', 'A'), NULL},
+    {"TSIZ", FRAME_ID('T', 'S', 'I', 'Z'), NULL},
+    {"TYER", FRAME_ID('T', 'Y', 'E', 'R'), "YEAR"},
+    {"ASPI", FRAME_ID('A', 'S', 'P', 'I'), NULL},
+    {"EQU2", FRAME_ID('E', 'Q', 'U', '2'), NULL},
+    {"RVA2", FRAME_ID('R', 'V', 'A', '2'), NULL},
+    {"SEEK", FRAME_ID('S', 'E', 'E', 'K'), NULL},
+    {"SIGN", FRAME_ID('S', 'I', 'G', 'N'), NULL},
+    {"TDEN", FRAME_ID('T', 'D', 'E', 'N'), NULL},
+    {"TDOR", FRAME_ID('T', 'D', 'O', 'R'), NULL},
+    {"TDRC", FRAME_ID('T', 'D', 'R', 'C'), NULL},
+    {"TDRL", FRAME_ID('T', 'D', 'R', 'L'), NULL},
+    {"TDTG", FRAME_ID('T', 'D', 'T', 'G'), NULL},
+    {"TIPL", FRAME_ID('T', 'I', 'P', 'L'), NULL},
+    {"TMCL", FRAME_ID('T', 'M', 'C', 'L'), NULL},
+    {"TMOO", FRAME_ID('T', 'M', 'O', 'O'), NULL},
+    {"TPRO", FRAME_ID('T', 'P', 'R', 'O'), NULL},
+    {"TSOA", FRAME_ID('T', 'S', 'O', 'A'), NULL},
+    {"TSOP", FRAME_ID('T', 'S', 'O', 'P'), NULL},
+    {"TSOT", FRAME_ID('T', 'S', 'O', 'T'), NULL},
+    {"TSST", FRAME_ID('T', 'S', 'S', 'T'), NULL},
+    {"GRP1", FRAME_ID('G', 'R', 'P', '1'), NULL},
+    {"MVIN", FRAME_ID('M', 'V', 'I', 'N'), NULL},
+    {"MVNM", FRAME_ID('M', 'V', 'N', 'M'), NULL},
+    {"PCST", FRAME_ID('P', 'C', 'S', 'T'), NULL},
+    {"TCAT", FRAME_ID('T', 'C', 'A', 'T'), NULL},
+    {"TCMP", FRAME_ID('T', 'C', 'M', 'P'), NULL},
+    {"TDES", FRAME_ID('T', 'D', 'E', 'S'), NULL},
+    {"TGID", FRAME_ID('T', 'G', 'I', 'D'), NULL},
+    {"TKWD", FRAME_ID('T', 'K', 'W', 'D'), NULL},
+    {"TSO2", FRAME_ID('T', 'S', 'O', '2'), NULL},
+    {"TSOC", FRAME_ID('T', 'S', 'O', 'C'), NULL},
+    {"WFED", FRAME_ID('W', 'F', 'E', 'D'), NULL},
+    {"BUF", FRAME_ID('R', 'B', 'U', 'F'), NULL},
+    {"CNT", FRAME_ID('P', 'C', 'N', 'T'), NULL},
+    {"COM", FRAME_ID('C', 'O', 'M', 'M'), NULL},
+    {"CRA", FRAME_ID('A', 'E', 'N', 'C'), NULL},
+    {"CRM", FRAME_ID('C', 'R', 'M', 0), NULL},
+    {"EQU", FRAME_ID('E', 'Q', 'U', 'A'), NULL},
+    {"ETC", FRAME_ID('E', 'T', 'C', 'O'), NULL},
+    {"GEO", FRAME_ID('G', 'E', 'O', 'B'), NULL},
+    {"IPL", FRAME_ID('I', 'P', 'L', 'S'), NULL},
+    {"LNK", FRAME_ID('L', 'I', 'N', 'K'), NULL},
+    {"MCI", FRAME_ID('M', 'C', 'D', 'I'), NULL},
+    {"MLL", FRAME_ID('M', 'L', 'L', 'T'), NULL},
+    {"PIC", FRAME_ID('A', 'P', 'I', 'C'), NULL},
+    {"POP", FRAME_ID('P', 'O', 'P', 'M'), NULL},
+    {"REV", FRAME_ID('R', 'V', 'R', 'B'), NULL},
+    {"RVA", FRAME_ID('R', 'V', 'A', 'D'), NULL},
+    {"SLT", FRAME_ID('S', 'Y', 'L', 'T'), NULL},
+    {"STC", FRAME_ID('S', 'Y', 'T', 'C'), NULL},
+    {"TAL", FRAME_ID('T', 'A', 'L', 'B'), NULL},
+    {"TBP", FRAME_ID('T', 'B', 'P', 'M'), NULL},
+    {"TCM", FRAME_ID('T', 'C', 'O', 'M'), NULL},
+    {"TCO", FRAME_ID('T', 'C', 'O', 'N'), NULL},
+    {"TCP", FRAME_ID('T', 'C', 'M', 'P'), NULL},
+    {"TCR", FRAME_ID('T', 'C', 'O', 'P'), NULL},
+    {"TDA", FRAME_ID('T', 'D', 'A', 'T'), NULL},
+    {"TDY", FRAME_ID('T', 'D', 'L', 'Y'), NULL},
+    {"TEN", FRAME_ID('T', 'E', 'N', 'C'), NULL},
+    {"TFT", FRAME_ID('T', 'F', 'L', 'T'), NULL},
+    {"TIM", FRAME_ID('T', 'I', 'M', 'E'), NULL},
+    {"TKE", FRAME_ID('T', 'K', 'E', 'Y'), NULL},
+    {"TLA", FRAME_ID('T', 'L', 'A', 'N'), NULL},
+    {"TLE", FRAME_ID('T', 'L', 'E', 'N'), NULL},
+    {"TMT", FRAME_ID('T', 'M', 'E', 'D'), NULL},
+    {"TOA", FRAME_ID('T', 'O', 'P', 'E'), NULL},
+    {"TOF", FRAME_ID('T', 'O', 'F', 'N'), NULL},
+    {"TOL", FRAME_ID('T', 'O', 'L', 'Y'), NULL},
+    {"TOR", FRAME_ID('T', 'O', 'R', 'Y'), NULL},
+    {"TOT", FRAME_ID('T', 'O', 'A', 'L'), NULL},
+    {"TP1", FRAME_ID('T', 'P', 'E', '1'), NULL},
+    {"TP2", FRAME_ID('T', 'P', 'E', '2'), NULL},
+    {"TP3", FRAME_ID('T', 'P', 'E', '3'), NULL},
+    {"TP4", FRAME_ID('T', 'P', 'E', '4'), NULL},
+    {"TPA", FRAME_ID('T', 'P', 'O', 'S'), NULL},
+    {"TPB", FRAME_ID('T', 'P', 'U', 'B'), NULL},
+    {"TRC", FRAME_ID('T', 'S', 'R', 'C'), NULL},
+    {"TRD", FRAME_ID('T', 'R', 'D', 'A'), NULL},
+    {"TRK", FRAME_ID('T', 'R', 'C', 'K'), NULL},
+    {"TS2", FRAME_ID('T', 'S', 'O', '2'), NULL},
+    {"TSA", FRAME_ID('T', 'S', 'O', 'A'), NULL},
+    {"TSC", FRAME_ID('T', 'S', 'O', 'C'), NULL},
+    {"TSI", FRAME_ID('T', 'S', 'I', 'Z'), NULL},
+    {"TSP", FRAME_ID('T', 'S', 'O', 'P'), NULL},
+    {"TSS", FRAME_ID('T', 'S', 'S', 'E'), NULL},
+    {"TST", FRAME_ID('T', 'S', 'O', 'T'), NULL},
+    {"TT1", FRAME_ID('T', 'I', 'T', '1'), NULL},
+    {"TT2", FRAME_ID('T', 'I', 'T', '2'), NULL},
+    {"TT3", FRAME_ID('T', 'I', 'T', '3'), NULL},
+    {"TXT", FRAME_ID('T', 'E', 'X', 'T'), NULL},
+    {"TXX", FRAME_ID('T', 'X', 'X', 'X'), NULL},
+    {"TYE", FRAME_ID('T', 'Y', 'E', 'R'), NULL},
+    {"UFI", FRAME_ID('U', 'F', 'I', 'D'), NULL},
+    {"ULT", FRAME_ID('U', 'S', 'L', 'T'), NULL},
+    {"WAF", FRAME_ID('W', 'O', 'A', 'F'), NULL},
+    {"WAR", FRAME_ID('W', 'O', 'A', 'R'), NULL},
+    {"WAS", FRAME_ID('W', 'O', 'A', 'S'), NULL},
+    {"WCM", FRAME_ID('W', 'C', 'O', 'M'), NULL},
+    {"WCP", FRAME_ID('W', 'C', 'O', 'P'), NULL},
+    {"WPB", FRAME_ID('W', 'P', 'U', 'B'), NULL},
+    {"WXX", FRAME_ID('W', 'X', 'X', 'X'), NULL},
+};
+
+static const FRAMESLOT frame_slots[FRAME_HASH_SIZE] =
+{
+    [2] = {FRAME_ID('T', 'K', 'E', 0), ID3_V22, frame_text, 133},
+    [10] = {FRAME_ID('U', 'F', 'I', 0), ID3_V22, frame_binary, 164},
+    [22] = {FRAME_ID('P', 'C', 'S', 'T'), ID3_V23 | ID3_V24, frame_binary, 95},
+    [33] = {FRAME_ID('T', 'R', 'C', 0), ID3_V22, frame_text, 148},
+    [35] = {FRAME_ID('M', 'L', 'L', 0), ID3_V22, frame_binary, 115},
+    [37] = {FRAME_ID('T', 'O', 'A', 'L'), ID3_V23 | ID3_V24, frame_text, 36},
+    [43] = {FRAME_ID('T', 'X', 'X', 0), ID3_V22, frame_user_text, 162},
+    [45] = {FRAME_ID('W', 'O', 'A', 'F'), ID3_V23 | ID3_V24, frame_url, 58},
+    [46] = {FRAME_ID('E', 'Q', 'U', '2'), ID3_V24, frame_binary, 75},
+    [51] = {FRAME_ID('L', 'N', 'K', 0), ID3_V22, frame_binary, 113},
+    [57] = {FRAME_ID('T', 'O', 'F', 0), ID3_V22, frame_text, 138},
+    [64] = {FRAME_ID('T', 'S', 'T', 0), ID3_V22, frame_text, 157},
+    [65] = {FRAME_ID('R', 'V', 'A', 0), ID3_V22, frame_binary, 119},
+    [73] = {FRAME_ID('T', 'D', 'A', 0), ID3_V22, frame_text, 128},
+    [83] = {FRAME_ID('S', 'I', 'G', 'N'), ID3_V24, frame_binary, 78},
+    [104] = {FRAME_ID('A', 'S', 'P', 'I'), ID3_V24, frame_binary, 74},
+    [111] = {FRAME_ID('M', 'C', 'D', 'I'), ID3_V23 | ID3_V24, frame_binary, 9},
+    [114] = {FRAME_ID('E', 'T', 'C', 'O'), ID3_V23 | ID3_V24, frame_binary, 5},
+    [120] = {FRAME_ID('T', 'A', 'L', 'B'), ID3_V23 | ID3_V24, frame_text, 20},
+    [128] = {FRAME_ID('T', 'O', 'W', 'N'), ID3_V23 | ID3_V24, frame_text, 40},
+    [133] = {FRAME_ID('W', 'O', 'A', 'S'), ID3_V23 | ID3_V24, frame_url, 60},
+    [135] = {FRAME_ID('O', 'W', 'N', 'E'), ID3_V23 | ID3_V24, frame_binary, 11},
+    [136] = {FRAME_ID('R', 'E', 'V', 0), ID3_V22, frame_binary, 118},
+    [146] = {FRAME_ID('T', 'D', 'E', 'S'), ID3_V23 | ID3_V24, frame_text, 98},
+    [154] = {FRAME_ID('T', 'C', 'R', 0), ID3_V22, frame_text, 127},
+    [163] = {FRAME_ID('T', 'O', 'T', 0), ID3_V22, frame_text, 141},
+    [177] = {FRAME_ID('T', 'S', 'O', 'T'), ID3_V24, frame_text, 90},
+    [183] = {FRAME_ID('W', 'C', 'O', 'M'), ID3_V23 | ID3_V24, frame_url, 56},
+    [186] = {FRAME_ID('T', 'R', 'D', 0), ID3_V22, frame_text, 149},
+    [191] = {FRAME_ID('T', 'D', 'E', 'N'), ID3_V24, frame_text, 79},
+    [192] = {FRAME_ID('C', 'R', 'M', 0), ID3_V22, frame_binary, 108},
+    [203] = {FRAME_ID('S', 'T', 'C', 0), ID3_V22, frame_binary, 121},
+    [210] = {FRAME_ID('W', 'C', 'P', 0), ID3_V22, frame_url, 170},
+    [211] = {FRAME_ID('E', 'T', 'C', 0), ID3_V22, frame_binary, 110},
+    [212] = {FRAME_ID('T', 'S', 'A', 0), ID3_V22, frame_text, 152},
+    [213] = {FRAME_ID('T', 'M', 'T', 0), ID3_V22, frame_text, 136},
+    [219] = {FRAME_ID('T', 'C', 'O', 'N'), ID3_V23 | ID3_V24, frame_text, 23},
+    [220] = {FRAME_ID('M', 'V', 'N', 'M'), ID3_V23 | ID3_V24, frame_text, 94},
+    [240] = {FRAME_ID('T', 'R', 'K', 0), ID3_V22, frame_text, 150},
+    [246] = {FRAME_ID('T', 'P', 'R', 'O'), ID3_V24, frame_text, 87},
+    [253] = {FRAME_ID('T', 'I', 'M', 'E'), ID3_V23, frame_text, 69},
+    [259] = {FRAME_ID('T', 'I', 'M', 0), ID3_V22, frame_text, 132},
+    [261] = {FRAME_ID('T', 'D', 'O', 'R'), ID3_V24, frame_text, 80},
+    [263] = {FRAME_ID('T', 'I', 'T', '3'), ID3_V23 | ID3_V24, frame_text, 31},
+    [270] = {FRAME_ID('G', 'E', 'O', 'B'), ID3_V23 | ID3_V24, frame_binary, 6},
+    [273] = {FRAME_ID('I', 'P', 'L', 'S'), ID3_V23, frame_text, 66},
+    [277] = {FRAME_ID('P', 'C', 'N', 'T'), ID3_V23 | ID3_V24, frame_binary, 12},
+    [282] = {FRAME_ID('A', 'P', 'I', 'C'), ID3_V23 | ID3_V24, frame_binary, 1},
+    [285] = {FRAME_ID('T', 'T', '1', 0), ID3_V22, frame_text, 158},
+    [292] = {FRAME_ID('W', 'P', 'B', 0), ID3_V22, frame_url, 171},
+    [304] = {FRAME_ID('T', 'A', 'L', 0), ID3_V22, frame_text, 122},
+    [309] = {FRAME_ID('M', 'C', 'I', 0), ID3_V22, frame_binary, 114},
+    [310] = {FRAME_ID('T', 'G', 'I', 'D'), ID3_V23 | ID3_V24, frame_text, 99},
+    [311] = {FRAME_ID('T', 'O', 'A', 0), ID3_V22, frame_text, 137},
+    [317] = {FRAME_ID('T', 'K', 'W', 'D'), ID3_V23 | ID3_V24, frame_text, 100},
+    [337] = {FRAME_ID('G', 'R', 'I', 'D'), ID3_V23 | ID3_V24, frame_binary, 7},
+    [341] = {FRAME_ID('T', 'P', 'E', '3'), ID3_V23 | ID3_V24, frame_text, 43},
+    [344] = {FRAME_ID('C', 'N', 'T', 0), ID3_V22, frame_binary, 105},
+    [347] = {FRAME_ID('P', 'O', 'S', 'S'), ID3_V23 | ID3_V24, frame_binary, 14},
+    [350] = {FRAME_ID('T', 'R', 'S', 'O'), ID3_V23 | ID3_V24, frame_text, 49},
+    [351] = {FRAME_ID('S', 'Y', 'T', 'C'), ID3_V23 | ID3_V24, frame_binary, 19},
+    [360] = {FRAME_ID('W', 'C', 'O', 'P'), ID3_V23 | ID3_V24, frame_url, 57},
+    [363] = {FRAME_ID('T', 'P', 'O', 'S'), ID3_V23 | ID3_V24, frame_text, 45},
+    [367] = {FRAME_ID('T', 'D', 'R', 'L'), ID3_V24, frame_text, 82},
+    [371] = {FRAME_ID('T', 'M', 'O', 'O'), ID3_V24, frame_text, 86},
+    [382] = {FRAME_ID('T', 'R', 'C', 'K'), ID3_V23 | ID3_V24, frame_text, 47},
+    [383] = {FRAME_ID('T', 'B', 'P', 0), ID3_V22, frame_text, 123},
+    [384] = {FRAME_ID('T', 'P', '1', 0), ID3_V22, frame_text, 142},
+    [393] = {FRAME_ID('C', 'R', 'A', 0), ID3_V22, frame_binary, 107},
+    [395] = {FRAME_ID('T', 'M', 'C', 'L'), ID3_V24, frame_text, 85},
+    [401] = {FRAME_ID('T', 'L', 'A', 'N'), ID3_V23 | ID3_V24, frame_text, 33},
+    [407] = {FRAME_ID('W', 'X', 'X', 0), ID3_V22, frame_user_url, 172},
+    [408] = {FRAME_ID('T', 'C', 'M', 0), ID3_V22, frame_text, 124},
+    [419] = {FRAME_ID('T', 'S', 'I', 0), ID3_V22, frame_text, 154},
+    [428] = {FRAME_ID('P', 'O', 'P', 0), ID3_V22, frame_binary, 117},
+    [438] = {FRAME_ID('T', 'T', '2', 0), ID3_V22, frame_text, 159},
+    [441] = {FRAME_ID('E', 'N', 'C', 'R'), ID3_V23 | ID3_V24, frame_binary, 4},
+    [447] = {FRAME_ID('T', 'I', 'P', 'L'), ID3_V24, frame_text, 84},
+    [448] = {FRAME_ID('P', 'R', 'I', 'V'), ID3_V23 | ID3_V24, frame_binary, 15},
+    [449] = {FRAME_ID('R', 'V', 'R', 'B'), ID3_V23 | ID3_V24, frame_binary, 17},
+    [452] = {FRAME_ID('T', 'X', 'T', 0), ID3_V22, frame_text, 161},
+    [455] = {FRAME_ID('G', 'E', 'O', 0), ID3_V22, frame_binary, 111},
+    [468] = {FRAME_ID('T', 'C', 'A', 'T'), ID3_V23 | ID3_V24, frame_text, 96},
+    [472] = {FRAME_ID('T', 'S', 'P', 0), ID3_V22, frame_text, 155},
+    [474] = {FRAME_ID('L', 'I', 'N', 'K'), ID3_V23 | ID3_V24, frame_binary, 8},
+    [480] = {FRAME_ID('T', 'X', 'X', 'X'), ID3_V23 | ID3_V24, frame_user_text, 52},
+    [486] = {FRAME_ID('T', 'I', 'T', '1'), ID3_V23 | ID3_V24, frame_text, 29},
+    [489] = {FRAME_ID('T', 'L', 'E', 0), ID3_V22, frame_text, 135},
+    [496] = {FRAME_ID('E', 'Q', 'U', 0), ID3_V22, frame_binary, 109},
+    [509] = {FRAME_ID('T', 'B', 'P', 'M'), ID3_V23 | ID3_V24, frame_text, 21},
+    [513] = {FRAME_ID('T', 'E', 'N', 0), ID3_V22, frame_text, 130},
+    [519] = {FRAME_ID('U', 'S', 'L', 'T'), ID3_V23 | ID3_V24, frame_comment, 55},
+    [520] = {FRAME_ID('T', 'S', 'C', 0), ID3_V22, frame_text, 153},
+    [530] = {FRAME_ID('U', 'L', 'T', 0), ID3_V22, frame_comment, 165},
+    [535] = {FRAME_ID('T', 'S', 'O', 'C'), ID3_V23 | ID3_V24, frame_text, 102},
+    [538] = {FRAME_ID('T', 'P', '2', 0), ID3_V22, frame_text, 143},
+    [550] = {FRAME_ID('T', 'F', 'L', 'T'), ID3_V23 | ID3_V24, frame_text, 28},
+    [554] = {FRAME_ID('P', 'O', 'P', 'M'), ID3_V23 | ID3_V24, frame_binary, 13},
+    [555] = {FRAME_ID('T', 'D', 'L', 'Y'), ID3_V23 | ID3_V24, frame_text, 25},
+    [564] = {FRAME_ID('T', 'P', 'E', '1'), ID3_V23 | ID3_V24, frame_text, 41},
+    [565] = {FRAME_ID('T', 'O', 'P', 'E'), ID3_V23 | ID3_V24, frame_text, 39},
+    [568] = {FRAME_ID('W', 'A', 'R', 0), ID3_V22, frame_url, 167},
+    [570] = {FRAME_ID('T', 'M', 'E', 'D'), ID3_V23 | ID3_V24, frame_text, 35},
+    [584] = {FRAME_ID('T', 'O', 'F', 'N'), ID3_V23 | ID3_V24, frame_text, 37},
+    [592] = {FRAME_ID('T', 'T', '3', 0), ID3_V22, frame_text, 160},
+    [596] = {FRAME_ID('W', 'F', 'E', 'D'), ID3_V23 | ID3_V24, frame_url, 103},
+    [620] = {FRAME_ID('T', 'P', 'U', 'B'), ID3_V23 | ID3_V24, frame_text, 46},
+    [623] = {FRAME_ID('T', 'S', 'O', 'P'), ID3_V24, frame_text, 89},
+    [624] = {FRAME_ID('P', 'I', 'C', 0), ID3_V22, frame_binary, 116},
+    [626] = {FRAME_ID('T', 'R', 'D', 'A'), ID3_V23, frame_text, 71},
+    [627] = {FRAME_ID('U', 'F', 'I', 'D'), ID3_V23 | ID3_V24, frame_binary, 53},
+    [633] = {FRAME_ID('T', 'S', 'I', 'Z'), ID3_V23, frame_text, 72},
+    [639] = {FRAME_ID('R', 'V', 'A', '2'), ID3_V24, frame_binary, 76},
+    [678] = {FRAME_ID('T', 'Y', 'E', 0), ID3_V22, frame_text, 163},
+    [682] = {FRAME_ID('R', 'V', 'A', 'D'), ID3_V23, frame_binary, 67},
+    [689] = {FRAME_ID('U', 'S', 'E', 'R'), ID3_V23 | ID3_V24, frame_binary, 54},
+    [692] = {FRAME_ID('T', 'P', '3', 0), ID3_V22, frame_text, 144},
+    [693] = {FRAME_ID('T', 'O', 'R', 'Y'), ID3_V23, frame_text, 70},
+    [694] = {FRAME_ID('T', 'D', 'Y', 0), ID3_V22, frame_text, 129},
+    [702] = {FRAME_ID('W', 'O', 'R', 'S'), ID3_V23 | ID3_V24, frame_url, 61},
+    [713] = {FRAME_ID('T', 'C', 'M', 'P'), ID3_V23 | ID3_V24, frame_text, 97},
+    [716] = {FRAME_ID('T', 'C', 'O', 0), ID3_V22, frame_text, 125},
+    [720] = {FRAME_ID('T', 'D', 'T', 'G'), ID3_V24, frame_text, 83},
+    [721] = {FRAME_ID('S', 'E', 'E', 'K'), ID3_V24, frame_binary, 77},
+    [722] = {FRAME_ID('W', 'A', 'S', 0), ID3_V22, frame_url, 168},
+    [729] = {FRAME_ID('T', 'E', 'N', 'C'), ID3_V23 | ID3_V24, frame_text, 26},
+    [741] = {FRAME_ID('T', 'P', 'E', '4'), ID3_V23 | ID3_V24, frame_text, 44},
+    [757] = {FRAME_ID('W', 'O', 'A', 'R'), ID3_V23 | ID3_V24, frame_url, 59},
+    [758] = {FRAME_ID('T', 'S', 'O', 'A'), ID3_V24, frame_text, 88},
+    [760] = {FRAME_ID('T', 'Y', 'E', 'R'), ID3_V23, frame_text, 73},
+    [769] = {FRAME_ID('W', 'A', 'F', 0), ID3_V22, frame_url, 166},
+    [772] = {FRAME_ID('W', 'C', 'M', 0), ID3_V22, frame_url, 169},
+    [778] = {FRAME_ID('C', 'O', 'M', 0), ID3_V22, frame_comment, 106},
+    [793] = {FRAME_ID('T', 'S', 'S', 'T'), ID3_V24, frame_text, 91},
+    [794] = {FRAME_ID('T', 'O', 'L', 'Y'), ID3_V23 | ID3_V24, frame_text, 38},
+    [796] = {FRAME_ID('B', 'U', 'F', 0), ID3_V22, frame_binary, 104},
+    [798] = {FRAME_ID('T', 'P', 'A', 0), ID3_V22, frame_text, 146},
+    [810] = {FRAME_ID('S', 'Y', 'L', 'T'), ID3_V23 | ID3_V24, frame_binary, 18},
+    [813] = {FRAME_ID('A', 'E', 'N', 'C'), ID3_V23 | ID3_V24, frame_binary, 0},
+    [815] = {FRAME_ID('I', 'P', 'L', 0), ID3_V22, frame_text, 112},
+    [840] = {FRAME_ID('T', 'K', 'E', 'Y'), ID3_V23 | ID3_V24, frame_text, 32},
+    [843] = {FRAME_ID('T', 'C', 'O', 'M'), ID3_V23 | ID3_V24, frame_text, 22},
+    [844] = {FRAME_ID('W', 'X', 'X', 'X'), ID3_V23 | ID3_V24, frame_user_url, 64},
+    [846] = {FRAME_ID('T', 'P', '4', 0), ID3_V22, frame_text, 145},
+    [857] = {FRAME_ID('T', 'D', 'R', 'C'), ID3_V24, frame_text, 81},
+    [859] = {FRAME_ID('C', 'O', 'M', 'R'), ID3_V23 | ID3_V24, frame_binary, 3},
+    [870] = {FRAME_ID('T', 'C', 'P', 0), ID3_V22, frame_text, 126},
+    [875] = {FRAME_ID('M', 'V', 'I', 'N'), ID3_V23 | ID3_V24, frame_text, 93},
+    [880] = {FRAME_ID('T', 'O', 'R', 0), ID3_V22, frame_text, 140},
+    [886] = {FRAME_ID('T', 'E', 'X', 'T'), ID3_V23 | ID3_V24, frame_text, 27},
+    [887] = {FRAME_ID('T', 'I', 'T', '2'), ID3_V23 | ID3_V24, frame_text, 30},
+    [893] = {FRAME_ID('T', 'S', 'O', '2'), ID3_V23 | ID3_V24, frame_text, 101},
+    [898] = {FRAME_ID('T', 'L', 'A', 0), ID3_V22, frame_text, 134},
+    [899] = {FRAME_ID('T', 'F', 'T', 0), ID3_V22, frame_text, 131},
+    [904] = {FRAME_ID('C', 'O', 'M', 'M'), ID3_V23 | ID3_V24, frame_comment, 2},
+    [917] = {FRAME_ID('M', 'L', 'L', 'T'), ID3_V23 | ID3_V24, frame_binary, 10},
+    [928] = {FRAME_ID('T', 'S', 'S', 'E'), ID3_V23 | ID3_V24, frame_text, 51},
+    [934] = {FRAME_ID('T', 'S', 'S', 0), ID3_V22, frame_text, 156},
+    [935] = {FRAME_ID('E', 'Q', 'U', 'A'), ID3_V23, frame_binary, 65},
+    [952] = {FRAME_ID('T', 'P', 'B', 0), ID3_V22, frame_text, 147},
+    [955] = {FRAME_ID('T', 'D', 'A', 'T'), ID3_V23, frame_text, 68},
+    [963] = {FRAME_ID('R', 'B', 'U', 'F'), ID3_V23 | ID3_V24, frame_binary, 16},
+    [964] = {FRAME_ID('T', 'P', 'E', '2'), ID3_V23 | ID3_V24, frame_text, 42},
+    [970] = {FRAME_ID('S', 'L', 'T', 0), ID3_V22, frame_binary, 120},
+    [971] = {FRAME_ID('G', 'R', 'P', '1'), ID3_V23 | ID3_V24, frame_text, 92},
+    [974] = {FRAME_ID('T', 'R', 'S', 'N'), ID3_V23 | ID3_V24, frame_text, 48},
+    [975] = {FRAME_ID('T', 'S', '2', 0), ID3_V22, frame_text, 151},
+    [976] = {FRAME_ID('W', 'P', 'A', 'Y'), ID3_V23 | ID3_V24, frame_url, 62},
+    [980] = {FRAME_ID('T', 'O', 'L', 0), ID3_V22, frame_text, 139},
+    [984] = {FRAME_ID('W', 'P', 'U', 'B'), ID3_V23 | ID3_V24, frame_url, 63},
+    [996] = {FRAME_ID('T', 'S', 'R', 'C'), ID3_V23 | ID3_V24, frame_text, 50},
+    [1016] = {FRAME_ID('T', 'L', 'E', 'N'), ID3_V23 | ID3_V24, frame_text, 34},
+    [1020] = {FRAME_ID('T', 'C', 'O', 'P'), ID3_V23 | ID3_V24, frame_text, 24},
+};
+
+#endif
@@ -0,0 +1,490 @@
+/*
+File        : id3tag.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for low level ID3v2 tag block helpers.
+
+              This file contains the function definitions required to:
+               - Read the 10 byte ID3v2 header and decode the tag size
+               - Load the whole tag body into memory
+               - Skip the optional extended header
+               - Find where the frames stop and the padding starts
+               - Index every frame in a hash table keyed by frame id
+               - Encode sizes back into syncsafe / big endian form
+
+              Notes:
+               - Only the tag region is touched, the audio data that
+                 follows it is never read here.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "id3tag.h"
+#include "mp3view.h"
+#include "stats.h"
+#include "mp3sync.h"
+
+//Function to read the tag header and the tag body from the start of a file;
+status id3_read_tag(int fd, ID3TAG *id3tag)
+{
+    if(id3_read_header(fd, id3tag) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    return id3_read_body(fd, id3tag);
+}
+
+//Function to read and validate the 10 byte tag header;
+status id3_read_header(int fd, ID3TAG *id3tag)
+{
+    id3tag -> buffer = NULL;
+    id3tag -> map = NULL;
+    id3tag -> offset = 0;
+    ssize_t bytes = pread(fd, id3tag -> header, ID3_HEADER_SIZE, 0);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes != ID3_HEADER_SIZE || !id3_valid_header(id3tag -> header, "ID3"))
+    {
+        // not at the start: leading junk or an appended tag
+        if(id3_locate_tag(fd, id3tag) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+    }
+    id3tag -> size = bigendian_to_littleendian(id3tag -> header + 6);
+    return E_SUCCESS;
+}
+
+//Function to check a 10 byte tag header with the given marker ("ID3");
+int id3_valid_header(const unsigned char *ptr, const char *marker)
+{
+    return memcmp(ptr, marker, 3) == 0 && ptr[3] != 0xFF && ptr[4] != 0xFF &&
+           ((ptr[6] | ptr[7] | ptr[8] | ptr[9]) & 0x80) == 0;
+}
+
+//Function to search a buffer for a valid header whose tag ends at end (or anywhere if end is 0);
+static long find_tag_header(const unsigned char *buffer, size_t length, off_t base, off_t end)
+{
+    size_t pos = 0;
+    while(pos + ID3_HEADER_SIZE <= length)
+    {
+        pos += sync_find_id3(buffer + pos, length - pos);
+        if(pos + ID3_HEADER_SIZE > length)
+        {
+            break;
+        }
+        if(id3_valid_header(buffer + pos, "ID3") &&
+           (end == 0 || base + (off_t)pos + ID3_HEADER_SIZE + bigendian_to_littleendian(buffer + pos + 6) == end))
+        {
+            return (long)pos;
+        }
+        pos++;
+    }
+    return -1;
+}
+
+//Function to get the end of the file without an ID3v1 tag and an APEv2 tag;
+off_t id3_strip_tails(int fd, off_t end)
+{
+    unsigned char tail[APE_FOOTER_SIZE];
+    if(end >= ID3V1_SIZE && pread(fd, tail, 3, end - ID3V1_SIZE) == 3 && memcmp(tail, "TAG", 3) == 0)
+    {
+        end -= ID3V1_SIZE;
+    }
+    if(end >= APE_FOOTER_SIZE && pread(fd, tail, APE_FOOTER_SIZE, end - APE_FOOTER_SIZE) == APE_FOOTER_SIZE &&
+       memcmp(tail, "APETAGEX", 8) == 0)
+    {
+        // size (little endian) counts the items and the footer, the flags tell if a header precedes them
+        off_t ape_size = tail[12] | tail[13] << 8 | tail[14] << 16 | (off_t)tail[15] << 24;
+        end -= ape_size + ((tail[23] & 0x80) ? APE_FOOTER_SIZE : 0);
+    }
+    return end < 0 ? 0 : end;
+}
+
+/* Function to find a tag that does not start at byte 0: first a header
+   in the leading window, then an appended tag in front of the ID3v1 and
+   APEv2 tails by scanning the tail; only ID3v2.3 tags are read, and they
+   have no "3DI" footer to jump to */
+status id3_locate_tag(int fd, ID3TAG *id3tag)
+{
+    struct stat st;
+    unsigned char window[ID3_SCAN_WINDOW];
+
+    if(fstat(fd, &st) != 0)
+    {
+        return E_FAILURE;
+    }
+    ssize_t bytes = pread(fd, window, sizeof(window), 0);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes < ID3_HEADER_SIZE)
+    {
+        return E_FAILURE;
+    }
+    long pos = find_tag_header(window, bytes, 0, 0);
+    if(pos >= 0)
+    {
+        id3tag -> offset = pos;
+        memcpy(id3tag -> header, window + pos, ID3_HEADER_SIZE);
+        return E_SUCCESS;
+    }
+
+    // strip the tails that may follow an appended tag
+    off_t end = id3_strip_tails(fd, st.st_size);
+    if(end < ID3_HEADER_SIZE)
+    {
+        return E_FAILURE;
+    }
+
+    // a header whose tag ends exactly where the tails begin
+    off_t base = end > (off_t)sizeof(window) ? end - (off_t)sizeof(window) : 0;
+    bytes = pread(fd, window, end - base, base);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes != end - base)
+    {
+        return E_FAILURE;
+    }
+    pos = find_tag_header(window, bytes, base, end);
+    if(pos < 0)
+    {
+        return E_FAILURE;
+    }
+    id3tag -> offset = base + pos;
+    memcpy(id3tag -> header, window + pos, ID3_HEADER_SIZE);
+    return E_SUCCESS;
+}
+
+//Function to read the whole tag body with a single pread;
+status id3_read_body(int fd, ID3TAG *id3tag)
+{
+    id3tag -> map = NULL;
+    if(id3tag -> arena != NULL)
+    {
+        id3tag -> buffer = arena_alloc(id3tag -> arena, id3tag -> size ? id3tag -> size : 1);
+    }
+    else
+    {
+        id3tag -> buffer = malloc(id3tag -> size ? id3tag -> size : 1);
+        STATS_COUNT(stat_mallocs, 1);
+    }
+    if(id3tag -> buffer == NULL)
+    {
+        return E_FAILURE;
+    }
+    ssize_t bytes = pread(fd, id3tag -> buffer, id3tag -> size, id3tag -> offset + ID3_HEADER_SIZE);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes != (ssize_t)id3tag -> size)
+    {
+        id3_free_tag(id3tag);
+        return E_FAILURE;
+    }
+    if(id3_parse_layout(id3tag) != E_SUCCESS)
+    {
+        id3_free_tag(id3tag);
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to make sure bytes [start, end) of the body are loaded, [*loaded_start, *loaded_end) already are;
+static status load_range(int fd, ID3TAG *id3tag, unsigned int start, unsigned int end,
+                         unsigned int *loaded_start, unsigned int *loaded_end)
+{
+    if(start >= *loaded_start && end <= *loaded_end)
+    {
+        return E_SUCCESS;
+    }
+    if(start < *loaded_start || start > *loaded_end)
+    {
+        // not adjacent to what is loaded: start a new window here
+        *loaded_start = *loaded_end = start;
+    }
+    // read at least a chunk so the following frame headers come with it
+    unsigned int want = end - *loaded_end;
+    if(want < ID3_LAZY_CHUNK)
+    {
+        want = ID3_LAZY_CHUNK;
+    }
+    if(want > id3tag -> size - *loaded_end)
+    {
+        want = id3tag -> size - *loaded_end;
+    }
+    ssize_t bytes = pread(fd, id3tag -> buffer + *loaded_end, want, id3tag -> offset + ID3_HEADER_SIZE + *loaded_end);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes < 0 || *loaded_end + (unsigned int)bytes < end)
+    {
+        return E_FAILURE;
+    }
+    *loaded_end += bytes;
+    return E_SUCCESS;
+}
+
+/* Function to read only the frames with the given ids; the body buffer
+   has the size of the whole tag so offsets stay the same as in a full
+   read, but only the frame headers on the way and the requested frames
+   are filled in. found[i].id stays 0 for an id that is not in the tag */
+status id3_read_frames(int fd, ID3TAG *id3tag, const unsigned int *ids, unsigned int count, ID3FRAME *found)
+{
+    unsigned int loaded_start = 0, loaded_end = 0, missing = count, i;
+
+    id3tag -> map = NULL;
+    if(id3tag -> arena != NULL)
+    {
+        id3tag -> buffer = arena_alloc(id3tag -> arena, id3tag -> size ? id3tag -> size : 1);
+    }
+    else
+    {
+        id3tag -> buffer = malloc(id3tag -> size ? id3tag -> size : 1);
+        STATS_COUNT(stat_mallocs, 1);
+    }
+    if(id3tag -> buffer == NULL)
+    {
+        return E_FAILURE;
+    }
+    memset(found, 0, count * sizeof(ID3FRAME));
+
+    id3tag -> frames_start = 0;
+    if((id3tag -> header[5] & 0x40) && id3tag -> size >= 4)
+    {
+        if(load_range(fd, id3tag, 0, 4, &loaded_start, &loaded_end) != E_SUCCESS)
+        {
+            id3_free_tag(id3tag);
+            return E_FAILURE;
+        }
+        // same check as id3_parse_layout(): the extended header has to fit into the tag
+        const unsigned char *p = id3tag -> buffer;
+        unsigned long long ext_size = ((unsigned long long)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]) + 4;
+        if(ext_size > id3tag -> size)
+        {
+            id3_free_tag(id3tag);
+            return E_FAILURE;
+        }
+        id3tag -> frames_start = ext_size;
+    }
+
+    unsigned int pos = id3tag -> frames_start;
+    id3tag -> nframes = 0;
+    while(missing > 0 && pos + FRAME_HEADER_SIZE <= id3tag -> size)
+    {
+        if(load_range(fd, id3tag, pos, pos + FRAME_HEADER_SIZE, &loaded_start, &loaded_end) != E_SUCCESS)
+        {
+            break;
+        }
+        const unsigned char *frame = id3tag -> buffer + pos;
+        unsigned int frame_size = id3_frame_size(frame);
+        if(frame[0] == 0 || frame_size > id3tag -> size - pos - FRAME_HEADER_SIZE)
+        {
+            break;      // padding, or a broken frame
+        }
+        unsigned int id = frame_id(frame);
+        for(i = 0; i < count; i++)
+        {
+            if(ids[i] == id && found[i].id == 0)
+            {
+                if(load_range(fd, id3tag, pos, pos + FRAME_HEADER_SIZE + frame_size, &loaded_start, &loaded_end) != E_SUCCESS)
+                {
+                    id3_free_tag(id3tag);
+                    return E_FAILURE;
+                }
+                found[i].id = id;
+                found[i].flags = frame[8] << 8 | frame[9];
+                found[i].offset = pos;
+                found[i].size = frame_size;
+                missing--;
+            }
+        }
+        id3tag -> nframes++;
+        pos += FRAME_HEADER_SIZE + frame_size;
+    }
+    id3tag -> used = pos;
+    return E_SUCCESS;
+}
+
+//Function to map the tag region read-only instead of copying it;
+status id3_map_body(int fd, ID3TAG *id3tag)
+{
+    struct stat st;
+    // mappings start on a page boundary, the tag may not
+    off_t start = id3tag -> offset & ~(off_t)(sysconf(_SC_PAGESIZE) - 1);
+    size_t skip = id3tag -> offset - start;
+    size_t length = skip + ID3_HEADER_SIZE + id3tag -> size;
+
+    // a tag that claims to run past EOF would fault (SIGBUS) when touched
+    if(fstat(fd, &st) != 0 || (size_t)(st.st_size - start) < length)
+    {
+        return E_FAILURE;
+    }
+    void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, start);
+    STATS_COUNT(stat_syscalls, 2);      // fstat and mmap
+    if(map == MAP_FAILED)
+    {
+        return E_FAILURE;
+    }
+    id3tag -> map = map;
+    id3tag -> map_length = length;
+    id3tag -> buffer = id3tag -> map + skip + ID3_HEADER_SIZE;
+    if(id3_parse_layout(id3tag) != E_SUCCESS)
+    {
+        id3_free_tag(id3tag);
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to find the first frame and the start of padding in a loaded body;
+status id3_parse_layout(ID3TAG *id3tag)
+{
+    // extended header (flag bit 6): its 4 byte size does not include itself in v2.3
+    id3tag -> frames_start = 0;
+    if((id3tag -> header[5] & 0x40) && id3tag -> size >= 4)
+    {
+        const unsigned char *p = id3tag -> buffer;
+        unsigned long long ext_size = ((unsigned long long)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]) + 4;
+        if(ext_size > id3tag -> size)
+        {
+            return E_FAILURE;
+        }
+        id3tag -> frames_start = ext_size;
+    }
+    id3tag -> used = id3_frames_end(id3tag, &id3tag -> nframes);
+    return E_SUCCESS;
+}
+
+//Function to release the tag body;
+void id3_free_tag(ID3TAG *id3tag)
+{
+    if(id3tag -> map != NULL)
+    {
+        munmap(id3tag -> map, id3tag -> map_length);
+        id3tag -> map = NULL;
+    }
+    else if(id3tag -> arena == NULL)
+    {
+        free(id3tag -> buffer);
+    }
+    id3tag -> buffer = NULL;
+}
+
+//Function to locate the first byte of padding in the tag body and count the frames;
+unsigned int id3_frames_end(const ID3TAG *id3tag, unsigned int *nframes)
+{
+    const unsigned char *buf = id3tag -> buffer;
+    unsigned int pos = id3tag -> frames_start;
+    unsigned int count = 0;
+
+    while(pos + FRAME_HEADER_SIZE <= id3tag -> size && buf[pos] != 0x00)
+    {
+        unsigned int frame_size = id3_frame_size(buf + pos);
+        if(frame_size > id3tag -> size - pos - FRAME_HEADER_SIZE)
+        {
+            break;   // corrupt frame, treat the rest as padding
+        }
+        pos += FRAME_HEADER_SIZE + frame_size;
+        count++;
+    }
+    if(nframes != NULL)
+    {
+        *nframes = count;
+    }
+    return pos;
+}
+
+//Function to read a 4 character frame id as an integer;
+unsigned int frame_id(const unsigned char *ptr)
+{
+    return FRAME_ID(ptr[0], ptr[1], ptr[2], ptr[3]);
+}
+
+//Function to spread frame ids over the hash slots (Fibonacci hashing);
+static unsigned int frame_slot(unsigned int id, unsigned int mask)
+{
+    unsigned int hash = id * 2654435769U;
+    return (hash ^ hash >> 16) & mask;
+}
+
+//Function to index every frame of a loaded tag in one pass;
+status id3_index_frames(const ID3TAG *id3tag, ARENA *arena, FRAMETABLE *table)
+{
+    unsigned int slots = 16;
+    unsigned int pos = id3tag -> frames_start;
+
+    // at least twice as many slots as frames keeps the probe chains short
+    while(slots < 2 * id3tag -> nframes)
+    {
+        slots *= 2;
+    }
+    table -> frames = arena_alloc(arena, (id3tag -> nframes ? id3tag -> nframes : 1) * sizeof(ID3FRAME));
+    table -> slots = arena_calloc(arena, slots * sizeof(unsigned int));
+    if(table -> frames == NULL || table -> slots == NULL)
+    {
+        return E_FAILURE;
+    }
+    table -> mask = slots - 1;
+    table -> count = 0;
+
+    while(pos < id3tag -> used && table -> count < id3tag -> nframes)
+    {
+        const unsigned char *frame = id3tag -> buffer + pos;
+        ID3FRAME *entry = &table -> frames[table -> count];
+        entry -> id = frame_id(frame);
+        entry -> size = id3_frame_size(frame);
+        entry -> flags = frame[8] << 8 | frame[9];
+        entry -> offset = pos;
+        table -> count++;
+
+        // only the first frame of an id goes into the hash
+        unsigned int slot = frame_slot(entry -> id, table -> mask);
+        while(table -> slots[slot] != 0 && table -> frames[table -> slots[slot] - 1].id != entry -> id)
+        {
+            slot = (slot + 1) & table -> mask;
+        }
+        if(table -> slots[slot] == 0)
+        {
+            table -> slots[slot] = table -> count;
+        }
+        pos += FRAME_HEADER_SIZE + entry -> size;
+    }
+    return E_SUCCESS;
+}
+
+//Function to find the first frame with an id in O(1);
+const ID3FRAME *id3_find_frame(const FRAMETABLE *table, unsigned int id)
+{
+    unsigned int slot = frame_slot(id, table -> mask);
+    while(table -> slots[slot] != 0)
+    {
+        const ID3FRAME *frame = &table -> frames[table -> slots[slot] - 1];
+        if(frame -> id == id)
+        {
+            return frame;
+        }
+        slot = (slot + 1) & table -> mask;
+    }
+    return NULL;
+}
+
+//Function to decode the 4 byte big endian size of a v2.3 frame;
+unsigned int id3_frame_size(const unsigned char *frame)
+{
+    return (unsigned int)frame[4] << 24 | frame[5] << 16 | frame[6] << 8 | frame[7];
+}
+
+//Function to convert an integer to the 28 bit syncsafe format;
+void int_to_syncsafe(unsigned int value, unsigned char *ptr)
+{
+    ptr[0] = (value >> 21) & 0x7F;
+    ptr[1] = (value >> 14) & 0x7F;
+    ptr[2] = (value >> 7) & 0x7F;
+    ptr[3] = value & 0x7F;
+}
+
+//Function to store an integer as 4 big endian bytes;
+void int_to_bigendian(unsigned int value, unsigned char *ptr)
+{
+    ptr[0] = (value >> 24) & 0xFF;
+    ptr[1] = (value >> 16) & 0xFF;
+    ptr[2] = (value >> 8) & 0xFF;
+    ptr[3] = value & 0xFF;
+}
@@ -0,0 +1,152 @@
+/*
+File        : id3tag.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for low level ID3v2 tag block helpers.
+
+              This file contains the structure definition and function
+              prototypes used to load the complete ID3v2 tag block of an
+              MP3 file and to work on it in memory.
+
+              Key Components:
+               - ID3TAG : Holds the raw 10 byte tag header, the tag size
+                          decoded from it, the number of bytes taken by
+                          frames and the tag body itself.
+
+              Tag Layout (ID3v2.3):
+               | "ID3" | ver(2) | flags(1) | size(4, syncsafe) | frames ... | padding |
+               The size field counts everything after the 10 byte header,
+               including the zero padding that follows the last frame.
+
+               - FRAMETABLE : Every frame of the tag (id, flags, offset,
+                              size) plus a small hash on the frame id, so
+                              any frame is found in O(1) no matter where
+                              it appears. Built in one pass, memory comes
+                              from the per-file ARENA.
+
+               - Tag locator : A tag is normally at byte 0. When it is
+                              not, the first ID3_SCAN_WINDOW bytes are
+                              scanned for a valid header (leading junk)
+                              and then the end of the file is checked for
+                              an appended tag, before any ID3v1 ("TAG")
+                              and APEv2 ("APETAGEX") tail, found by
+                              scanning the tail for a header whose tag
+                              ends where the tails begin. Only ID3v2.3
+                              tags are read, so there is no v2.4 "3DI"
+                              footer to follow.
+                              id3tag -> offset is where the header starts.
+
+               - Lazy reader : id3_read_frames() walks the frame headers
+                              with small preads, skips every frame that
+                              was not asked for by its size and stops as
+                              soon as all requested frames are in; the
+                              rest of the tag is never read.
+
+              Notes:
+               - The body can either be copied into a heap buffer (pread)
+                 or mapped (mmap); in the second case nothing is copied and
+                 pages of large frames (e.g. APIC) are never touched unless
+                 their contents are actually used.
+               - Padding is what allows a tag to be edited in place: as long
+                 as the new frames fit into size bytes, the audio data never
+                 has to move.
+*/
+#ifndef id3tag_h
+#define id3tag_h
+#include <sys/types.h>
+#include "types.h"
+#include "arena.h"
+
+#define ID3_HEADER_SIZE 10
+#define FRAME_HEADER_SIZE 10
+#define FRAME_FORMAT_FLAGS 0xE0   // second flag byte: compression, encryption, grouping
+#define ID3_GROW_PADDING 1024     // padding added when a tag has to grow
+#define ID3_SCAN_WINDOW 65536     // bytes searched for a misplaced tag at each end
+#define ID3_LAZY_CHUNK 4096       // bytes read at a time by the lazy frame reader
+#define ID3V1_SIZE 128
+#define APE_FOOTER_SIZE 32
+
+typedef struct id3tag
+{
+	unsigned char header[ID3_HEADER_SIZE]; // raw tag header as stored in the file
+	off_t offset;              // position of the header in the file (0 unless located)
+	unsigned int size;        // tag size from the header (without the header itself)
+	unsigned int frames_start; // offset of the first frame (after any extended header)
+	unsigned int used;         // offset where the padding starts
+	unsigned char *buffer;     // tag body, size bytes (heap copy or view into map)
+	unsigned char *map;        // start of the mmap'ed tag region, NULL when read with pread
+	size_t map_length;         // length of the mapping
+	unsigned int nframes;      // number of frames before the padding
+	ARENA *arena;              // if set, a pread body is taken from here instead of malloc
+}ID3TAG;
+
+typedef struct id3frame
+{
+	unsigned int id;           // frame id as big endian integer ("TIT2" -> 0x54495432)
+	unsigned int flags;        // the 2 flag bytes
+	unsigned int offset;       // offset of the frame header in the tag body
+	unsigned int size;         // frame size without the header
+}ID3FRAME;
+
+typedef struct frametable
+{
+	ID3FRAME *frames;          // every frame of the tag, in tag order
+	unsigned int count;        // number of frames
+	unsigned int *slots;       // hash of frame ids: index + 1 into frames, 0 = empty
+	unsigned int mask;         // number of slots - 1
+}FRAMETABLE;
+
+#define FRAME_ID(a, b, c, d) ((unsigned int)(a) << 24 | (unsigned int)(b) << 16 | (unsigned int)(c) << 8 | (unsigned int)(d))
+
+//Function to read the tag header and the tag body from the start of a file;
+status id3_read_tag(int fd, ID3TAG *id3tag);
+
+//Function to read and validate the 10 byte tag header;
+status id3_read_header(int fd, ID3TAG *id3tag);
+
+//Function to check a 10 byte tag header with the given marker ("ID3");
+int id3_valid_header(const unsigned char *ptr, const char *marker);
+
+//Function to get the end of the file without an ID3v1 tag and an APEv2 tag;
+off_t id3_strip_tails(int fd, off_t end);
+
+//Function to find a tag that does not start at byte 0;
+status id3_locate_tag(int fd, ID3TAG *id3tag);
+
+//Function to read the whole tag body with a single pread;
+status id3_read_body(int fd, ID3TAG *id3tag);
+
+//Function to read only the frames with the given ids, stopping once all are found;
+status id3_read_frames(int fd, ID3TAG *id3tag, const unsigned int *ids, unsigned int count, ID3FRAME *found);
+
+//Function to map the tag region read-only instead of copying it;
+status id3_map_body(int fd, ID3TAG *id3tag);
+
+//Function to find the first frame and the start of padding in a loaded body;
+status id3_parse_layout(ID3TAG *id3tag);
+
+//Function to decode the 4 byte big endian size of a v2.3 frame;
+unsigned int id3_frame_size(const unsigned char *frame);
+
+//Function to release the tag body;
+void id3_free_tag(ID3TAG *id3tag);
+
+//Function to locate the first byte of padding in the tag body and count the frames;
+unsigned int id3_frames_end(const ID3TAG *id3tag, unsigned int *nframes);
+
+//Function to index every frame of a loaded tag in one pass;
+status id3_index_frames(const ID3TAG *id3tag, ARENA *arena, FRAMETABLE *table);
+
+//Function to find the first frame with an id in O(1);
+const ID3FRAME *id3_find_frame(const FRAMETABLE *table, unsigned int id);
+
+//Function to read a 4 character frame id as an integer;
+unsigned int frame_id(const unsigned char *ptr);
+
+//Function to convert an integer to the 28 bit syncsafe format;
+void int_to_syncsafe(unsigned int value, unsigned char *ptr);
+
+//Function to store an integer as 4 big endian bytes;
+void int_to_bigendian(unsigned int value, unsigned char *ptr);
+
+#endif
@@ -10,8 +10,24 @@ Description : Main driver program for the MP3 Tag Viewer and Editor.
 
               Functionalities:
                - View existing MP3 tag information (-v option)
-               - Edit specific tags using tag options (-e option)
+               - View the tags of a whole directory tree with a pool of
+                 worker threads (-v -r option)
+               - Edit specific tags using tag options (-e option); any number
+                 of tags can be changed in one run with a single file write
+               - Read or edit the tags of an MP3 stream: "-" as the file
+                 name views stdin, or edits stdin into stdout in one pass
+               - Apply a CSV/TSV manifest of (path, frame, value) rows with
+                 a pool of worker threads, each file written once (-e -b)
                - Display help information (--help option)
+               - Report per phase timings and I/O counters (--stats)
+               - Print one JSON Lines or TSV record per file for other
+                 programs to load (--format=jsonl, --format=tsv)
+               - Keep a library indexed in memory, follow its changes and
+                 answer lookups on a Unix socket (-w option)
+               - Find files that hold the same audio under different tags
+                 (-d option)
+               - Find files by artist, album, genre and year through
+                 inverted indexes (-f option)
 
               Supported tag edit options:
                -t : Title
@@ -22,9 +38,20 @@ Description : Main driver program for the MP3 Tag Viewer and Editor.
                -c : Composer
 
               Usage:
-                To view : ./a.out -v <mp3filename>
-                To edit : ./a.out -e -t/-a/-A/-y/-m/-c "new_text" <mp3filename>
+                To view : ./a.out -v [--fields <id,id,...>] <mp3filename>
+                To scan : ./a.out -v -r <directory> [-j <threads>] [-a [-q <depth>]] [-i <index>]
+                          [-o <frame|file>] [--fields <id,id,...>]
+                To edit : ./a.out -e -t/-a/-A/-y/-m/-c "new_text" [more option/text pairs] <mp3filename>
+                Stream  : ./a.out -v - < in.mp3,  ./a.out -e -t "new_text" [...] - < in.mp3 > out.mp3
+                Batch   : ./a.out -e -b <manifest.csv|.tsv> [-j <threads>]
+                Watch   : ./a.out -w <directory> -s <socket> [-i <index>]
+                Dups    : ./a.out -d <directory> [-j <threads>]
+                Query   : ./a.out -f <directory> [-j <threads>] [-i <index>] ["TPE1=x && TYER=1998" ...]
                 Help    : ./a.out --help
+                Stats   : --stats or --stats=json anywhere on the command
+                          line prints per phase latencies and counters to
+                          stderr at exit
+                Format  : --format=jsonl or --format=tsv anywhere with -v, -d or -f
 
               Notes:
                - Only files with the ".mp3" extension are supported.
@@ -32,14 +59,62 @@ Description : Main driver program for the MP3 Tag Viewer and Editor.
                - Invalid arguments or missing parameters will display usage help.
 */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "mp3view.h"
 #include "mp3edit.h"
+#include "mp3scan.h"
+#include "mp3batch.h"
+#include "mp3format.h"
+#include "mp3watch.h"
+#include "mp3dup.h"
+#include "mp3query.h"
+#include "mp3stream.h"
 #include "types.h"
+#include "stats.h"
 
 int main(int argc, char *argv[])
 {
     MP3VIEW mp3view = {0};
     MP3EDIT mp3edit = {0};
+    MP3SCAN mp3scan = {0};
+    MP3BATCH mp3batch = {0};
+    MP3WATCH mp3watch = {0};
+    MP3DUP mp3dup = {0};
+    MP3QUERY mp3query = {0};
+    FIELDSET fields = {0};
+    OutputFormat format = format_text;
+
+    // --stats may appear anywhere, the report goes to stderr at exit
+    argc = stats_parse_args(argc, argv);
+    if(stats_mode != stats_off)
+    {
+        atexit(stats_print_at_exit);
+    }
+
+    // --fields may appear anywhere after -v
+    argc = parse_fields_arg(argc, argv, &fields);
+    if(argc < 0)
+    {
+        return 1;
+    }
+    if(fields.count > 0)
+    {
+        mp3view.fields = &fields;
+        mp3scan.fields = &fields;
+        mp3query.scan.fields = &fields;
+    }
+
+    // --format=<text|jsonl|tsv> may appear anywhere after -v
+    argc = parse_format_arg(argc, argv, &format);
+    if(argc < 0)
+    {
+        return 1;
+    }
+    mp3scan.format = format;
+    mp3dup.scan.format = format;
+    mp3query.scan.format = format;
 
     OperationType operation = check_Operation_Type(argc, argv);
 
@@ -47,9 +122,17 @@ int main(int argc, char *argv[])
     {
         printf("ERROR: ./a.out : INVALID ARGUMENTS\n");
         printf("USAGE : \n");
-        printf("To view : ./a.out -v mp3filename\n");
-        printf("To edit : ./a.out -e -t/-a/-A/-m/-y/-c change_text mp3filename\n");
+        printf("To view : ./a.out -v [--fields TIT2,TPE1,...] mp3filename\n");
+        printf("To scan : ./a.out -v -r directory [-j threads] [-a [-q depth]] [-i index] [-o frame] [--fields TIT2,...]\n");
+        printf("To edit : ./a.out -e -t/-a/-A/-m/-y/-c change_text [-t/-a/... change_text ...] mp3filename\n");
+        printf("Stream  : ./a.out -v - < in.mp3, ./a.out -e -t change_text [...] - < in.mp3 > out.mp3\n");
+        printf("Batch   : ./a.out -e -b manifest.csv [-j threads]\n");
+        printf("Watch   : ./a.out -w directory -s socket [-i index]\n");
+        printf("Dups    : ./a.out -d directory [-j threads]\n");
+        printf("Query   : ./a.out -f directory [-j threads] [-i index] [\"TPE1=artist && TYER=1998\" ...]\n");
         printf("Help    : ./a.out --help\n");
+        printf("Stats   : add --stats (or --stats=json) to any of the above\n");
+        printf("Format  : add --format=jsonl or --format=tsv to view, scan, dups or query\n");
     }
     else if(operation == Help_menu)
     {
@@ -64,13 +147,33 @@ int main(int argc, char *argv[])
         }
         if(check_for_extension(argv, &mp3view) == E_SUCCESS)
         {
-            Mp3View(&mp3view);
+            if(format == format_text)
+            {
+                Mp3View(&mp3view);
+            }
+            else if(Mp3ViewRecord(&mp3view, format) != E_SUCCESS)
+            {
+                return 1;
+            }
         }
         else
         {
             printf("Error: mp3 file extension should be .mp3\n");
         }
     }
+    else if(operation == scan_mp3tags)
+    {
+        if(check_scan_args(argc, argv, &mp3scan) != E_SUCCESS)
+        {
+            return 1;
+        }
+        status ret = Mp3Scan(&mp3scan);
+        free_scan(&mp3scan);
+        if(ret != E_SUCCESS)
+        {
+            return 1;
+        }
+    }
     else if(operation == edit_mp3tags)
     {
 	      if(argc < 3)
@@ -82,10 +185,83 @@ int main(int argc, char *argv[])
 		    
              if(mp3_edit(&mp3edit, argv) != E_SUCCESS)// rename function for clarity
              return 1;
+             if(strcmp(mp3edit.input_file, "-") == 0)
+             {
+                 // stdout carries the file, so the messages go to stderr
+                 if(stream_edit(&mp3edit, STDIN_FILENO, STDOUT_FILENO) != E_SUCCESS)
+                 {
+                     fprintf(stderr, "%s\n", mp3edit.error);
+                     return 1;
+                 }
+                 unsigned int i;
+                 for(i = 0; i < mp3edit.count; i++)
+                 {
+                     if(!mp3edit.edits[i].found)
+                     {
+                         fprintf(stderr, "Frame '%s' not found. No changes made.\n", mp3edit.edits[i].tag);
+                     }
+                 }
+                 return 0;
+             }
              if(open_files(&mp3edit) != E_SUCCESS)
-             return 1;
+             {
+                 perror(mp3edit.error);
+                 return 1;
+             }
+             printf("The input file was opened successfully\n");
 
-             edit_tag_data(&mp3edit);
+             if(edit_tag_data(&mp3edit) != E_SUCCESS)
+             {
+                 printf("%s\n", mp3edit.error);
+                 return 1;
+             }
+             display_edit_result(&mp3edit);
+    }
+    else if(operation == batch_edit_mp3tags)
+    {
+        if(check_batch_args(argc, argv, &mp3batch) != E_SUCCESS)
+        {
+            return 1;
+        }
+        status ret = Mp3Batch(&mp3batch);
+        free_batch(&mp3batch);
+        if(ret != E_SUCCESS)
+        {
+            return 1;
+        }
+    }
+    else if(operation == watch_mp3tags)
+    {
+        if(check_watch_args(argc, argv, &mp3watch) != E_SUCCESS || Mp3Watch(&mp3watch) != E_SUCCESS)
+        {
+            return 1;
+        }
+    }
+    else if(operation == dup_mp3files)
+    {
+        if(check_dup_args(argc, argv, &mp3dup) != E_SUCCESS)
+        {
+            return 1;
+        }
+        status ret = Mp3Dup(&mp3dup);
+        free_dup(&mp3dup);
+        if(ret != E_SUCCESS)
+        {
+            return 1;
+        }
+    }
+    else if(operation == query_mp3tags)
+    {
+        if(check_query_args(argc, argv, &mp3query) != E_SUCCESS)
+        {
+            return 1;
+        }
+        status ret = Mp3Query(&mp3query);
+        free_query(&mp3query);
+        if(ret != E_SUCCESS)
+        {
+            return 1;
+        }
     }
     else
     {
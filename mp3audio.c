@@ -0,0 +1,336 @@
+/*
+File        : mp3audio.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for duration and bitrate extraction.
+
+              This file contains the function definitions required to:
+               - Decode MPEG audio frame headers (version, layer, bitrate,
+                 sample rate, padding, channel mode)
+               - Find the first frame after the tag
+               - Read the Xing/Info and VBRI headers of the first frame
+               - Walk all frame headers when neither header is present
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "id3tag.h"
+#include "mp3audio.h"
+#include "mp3sync.h"
+#include "stats.h"
+
+typedef struct
+{
+	unsigned int version;
+	unsigned int layer;
+	unsigned int bitrate;      // kbit/s
+	unsigned int sample_rate;
+	unsigned int channels;
+	unsigned int length;       // frame length in bytes, header included
+	unsigned int samples;      // samples per frame
+	unsigned int side_info;    // Layer III side information size
+}FRAMEHEADER;
+
+static const unsigned short bitrates[2][3][15] =
+{
+	{   // MPEG 1, layer I, II, III
+		{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+		{0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320}
+	},
+	{   // MPEG 2 and 2.5, layer I, II, III
+		{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+		{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+		{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}
+	}
+};
+
+static const unsigned int sample_rates[3] = {44100, 48000, 32000};
+
+//Function to decode a 4 byte frame header, returns 0 when it is not valid;
+static int parse_frame_header(const unsigned char *ptr, FRAMEHEADER *header)
+{
+    if(ptr[0] != 0xFF || (ptr[1] & 0xE0) != 0xE0)
+    {
+        return 0;
+    }
+    unsigned int version_bits = (ptr[1] >> 3) & 3;
+    unsigned int layer_bits = (ptr[1] >> 1) & 3;
+    unsigned int bitrate_index = ptr[2] >> 4;
+    unsigned int rate_index = (ptr[2] >> 2) & 3;
+    unsigned int padding = (ptr[2] >> 1) & 1;
+
+    // 01 is a reserved version, 00 a reserved layer, 1111 a bad bitrate, 0000 free format
+    if(version_bits == 1 || layer_bits == 0 || bitrate_index == 0 || bitrate_index == 15 || rate_index == 3)
+    {
+        return 0;
+    }
+    header -> version = version_bits == 3 ? 10 : version_bits == 2 ? 20 : 25;
+    header -> layer = 4 - layer_bits;
+    header -> bitrate = bitrates[header -> version != 10][header -> layer - 1][bitrate_index];
+    header -> sample_rate = sample_rates[rate_index] >> (header -> version == 10 ? 0 : header -> version == 20 ? 1 : 2);
+    header -> channels = (ptr[3] >> 6) == 3 ? 1 : 2;
+
+    if(header -> layer == 1)
+    {
+        header -> samples = 384;
+        header -> length = (12 * header -> bitrate * 1000 / header -> sample_rate + padding) * 4;
+    }
+    else
+    {
+        int half = header -> layer == 3 && header -> version != 10;    // 576 samples
+        header -> samples = half ? 576 : 1152;
+        header -> length = (half ? 72 : 144) * header -> bitrate * 1000 / header -> sample_rate + padding;
+    }
+    if(header -> version == 10)
+    {
+        header -> side_info = header -> channels == 1 ? 17 : 32;
+    }
+    else
+    {
+        header -> side_info = header -> channels == 1 ? 9 : 17;
+    }
+    return 1;
+}
+
+//Function to read a 32 bit big endian value;
+static unsigned int read_be32(const unsigned char *ptr)
+{
+    return (unsigned int)ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3];
+}
+
+/* Function to find the first frame in [start, end): a sync candidate is
+   only taken when the frame after it starts with a sync of the same kind */
+static off_t find_first_frame(int fd, off_t start, off_t end, unsigned char *buffer, FRAMEHEADER *header)
+{
+    off_t base = start;
+    off_t limit = start + AUDIO_SEARCH_LIMIT < end ? start + AUDIO_SEARCH_LIMIT : end;
+    while(base + 4 <= limit)
+    {
+        size_t want = end - base < AUDIO_PROBE_SIZE ? end - base : AUDIO_PROBE_SIZE;
+        ssize_t bytes = pread(fd, buffer, want, base);
+        STATS_IO(stat_bytes_read, bytes);
+        if(bytes < 4)
+        {
+            return -1;
+        }
+        size_t pos = 0;
+        while((pos += sync_find_frame(buffer + pos, bytes - pos)) + 4 <= (size_t)bytes)
+        {
+            FRAMEHEADER next;
+            unsigned char probe[4];
+            if(parse_frame_header(buffer + pos, header))
+            {
+                off_t next_offset = base + pos + header -> length;
+                if(next_offset + 4 > end)
+                {
+                    return base + pos;       // a single frame is all there is
+                }
+                const unsigned char *next_ptr = probe;
+                if(pos + header -> length + 4 <= (size_t)bytes)
+                {
+                    next_ptr = buffer + pos + header -> length;
+                }
+                else if(pread(fd, probe, 4, next_offset) != 4)
+                {
+                    return -1;
+                }
+                if(parse_frame_header(next_ptr, &next) && next.version == header -> version &&
+                   next.layer == header -> layer && next.sample_rate == header -> sample_rate)
+                {
+                    return base + pos;
+                }
+            }
+            pos++;
+        }
+        if(base + bytes >= end)
+        {
+            break;
+        }
+        // keep the last 3 bytes, a header may straddle the boundary
+        base += bytes - 3;
+    }
+    return -1;
+}
+
+//Function to take frame and byte counts from a Xing/Info or VBRI header;
+static int read_vbr_header(const unsigned char *frame, size_t length, const FRAMEHEADER *header, AUDIOINFO *audioinfo)
+{
+    size_t xing = 4 + header -> side_info;
+    if(header -> layer == 3 && xing + 16 <= length &&
+       (memcmp(frame + xing, "Xing", 4) == 0 || memcmp(frame + xing, "Info", 4) == 0))
+    {
+        unsigned int flags = read_be32(frame + xing + 4);
+        const unsigned char *field = frame + xing + 8;
+        if(!(flags & 1))
+        {
+            return 0;               // no frame count, cannot give a duration
+        }
+        audioinfo -> frames = read_be32(field);
+        field += 4;
+        if(flags & 2)
+        {
+            audioinfo -> bytes = read_be32(field);
+        }
+        audioinfo -> vbr = frame[xing] == 'X';
+        audioinfo -> source = audioinfo -> vbr ? "Xing" : "Info";
+        return 1;
+    }
+    if(36 + 18 <= length && memcmp(frame + 36, "VBRI", 4) == 0)
+    {
+        audioinfo -> bytes = read_be32(frame + 36 + 10);
+        audioinfo -> frames = read_be32(frame + 36 + 14);
+        audioinfo -> vbr = 1;
+        audioinfo -> source = "VBRI";
+        return 1;
+    }
+    return 0;
+}
+
+/* Function to walk every frame header in [start, end); damaged data is
+   skipped by resynchronising on the next frame sync */
+static status walk_frames(int fd, off_t start, off_t end, AUDIOINFO *audioinfo)
+{
+    unsigned char *buffer = malloc(AUDIO_CHUNK_SIZE);
+    off_t base = start, pos = start;
+    size_t have = 0;
+    unsigned long long bitrate_sum = 0;
+    unsigned int first_bitrate = 0;
+    FRAMEHEADER header;
+
+    STATS_COUNT(stat_mallocs, 1);
+    if(buffer == NULL)
+    {
+        return E_FAILURE;
+    }
+    audioinfo -> frames = 0;
+    audioinfo -> bytes = 0;
+    audioinfo -> vbr = 0;
+    while(pos + 4 <= end)
+    {
+        if(pos < base || pos + 4 > base + (off_t)have)
+        {
+            size_t want = end - pos < AUDIO_CHUNK_SIZE ? end - pos : AUDIO_CHUNK_SIZE;
+            ssize_t bytes = pread(fd, buffer, want, pos);
+            STATS_IO(stat_bytes_read, bytes);
+            if(bytes < 4)
+            {
+                break;
+            }
+            base = pos;
+            have = bytes;
+        }
+        const unsigned char *ptr = buffer + (pos - base);
+        if(parse_frame_header(ptr, &header) && header.sample_rate == audioinfo -> sample_rate &&
+           header.layer == audioinfo -> layer)
+        {
+            if(audioinfo -> frames == 0)
+            {
+                first_bitrate = header.bitrate;
+            }
+            else if(header.bitrate != first_bitrate)
+            {
+                audioinfo -> vbr = 1;
+            }
+            audioinfo -> frames++;
+            audioinfo -> bytes += header.length;
+            bitrate_sum += header.bitrate;
+            pos += header.length;
+            continue;
+        }
+        // resync: next candidate in the buffered data, or refill after it
+        size_t offset = pos - base + 1;
+        size_t found = sync_find_frame(buffer + offset, have - offset);
+        if(offset + found + 4 <= have)
+        {
+            pos = base + offset + found;
+        }
+        else
+        {
+            pos = base + (off_t)have - 3;     // a sync may straddle the end of the buffer
+            have = 0;                          // refill at pos
+        }
+    }
+    free(buffer);
+    if(audioinfo -> frames == 0)
+    {
+        return E_FAILURE;
+    }
+    audioinfo -> bitrate = (unsigned int)(bitrate_sum / audioinfo -> frames);
+    audioinfo -> source = "scan";
+    return E_SUCCESS;
+}
+
+/* Function to find where the audio starts and ends around a tag (NULL: no
+   tag); it follows the tag and its v2.4 footer, unless the tag was
+   appended, and stops before any ID3v1 or APEv2 tail */
+void audio_range(int fd, const ID3TAG *id3tag, off_t file_size, off_t *start, off_t *end)
+{
+    *end = id3_strip_tails(fd, file_size);
+    *start = 0;
+    if(id3tag == NULL)
+    {
+        return;
+    }
+    *start = id3tag -> offset + ID3_HEADER_SIZE + id3tag -> size + ((id3tag -> header[5] & 0x10) ? ID3_HEADER_SIZE : 0);
+    if(id3tag -> offset > 0 && *start >= *end)
+    {
+        *end = id3tag -> offset;
+        *start = 0;
+    }
+    if(*start > *end)
+    {
+        *start = *end;      // a tag that claims more than the file holds
+    }
+}
+
+//Function to find the duration and bitrate of the audio behind (or before) a tag;
+status read_audio_info(int fd, const ID3TAG *id3tag, AUDIOINFO *audioinfo)
+{
+    struct stat st;
+    unsigned char buffer[AUDIO_PROBE_SIZE];
+    FRAMEHEADER header;
+
+    memset(audioinfo, 0, sizeof(*audioinfo));
+    if(fstat(fd, &st) != 0)
+    {
+        return E_FAILURE;
+    }
+
+    off_t start, end;
+    audio_range(fd, id3tag, st.st_size, &start, &end);
+
+    off_t first = find_first_frame(fd, start, end, buffer, &header);
+    if(first < 0)
+    {
+        return E_FAILURE;
+    }
+    audioinfo -> version = header.version;
+    audioinfo -> layer = header.layer;
+    audioinfo -> sample_rate = header.sample_rate;
+    audioinfo -> channels = header.channels;
+
+    ssize_t bytes = pread(fd, buffer, sizeof(buffer), first);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes > 0 && read_vbr_header(buffer, bytes, &header, audioinfo))
+    {
+        if(audioinfo -> bytes == 0)
+        {
+            audioinfo -> bytes = end - first;
+        }
+        audioinfo -> duration = (double)audioinfo -> frames * header.samples / header.sample_rate;
+        audioinfo -> bitrate = audioinfo -> duration > 0 ?
+                               (unsigned int)(audioinfo -> bytes * 8 / audioinfo -> duration / 1000 + 0.5) : header.bitrate;
+        return E_SUCCESS;
+    }
+
+    if(walk_frames(fd, first, end, audioinfo) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    audioinfo -> duration = (double)audioinfo -> frames * header.samples / header.sample_rate;
+    return E_SUCCESS;
+}
@@ -0,0 +1,55 @@
+/*
+File        : mp3audio.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for duration and bitrate extraction.
+
+              Key Components:
+               - AUDIOINFO : MPEG version, layer, sample rate, channels,
+                             number of audio frames, audio bytes, duration,
+                             (average) bitrate and where they came from.
+
+              How It Works:
+               1. The audio starts right after the ID3v2 tag (or at byte 0
+                  when the tag is appended) and ends before any ID3v1 or
+                  APEv2 tail.
+               2. The first frame header is found with sync_find_frame()
+                  and confirmed by the header of the frame after it.
+               3. A Xing/Info header (after the side information) or a
+                  VBRI header (32 bytes after the frame header) gives the
+                  frame count and byte count directly: one small read.
+               4. Without such a header the frames are walked in 1 MiB
+                  chunks, jumping from header to header by frame length
+                  and resynchronising with the vectorized scanner after
+                  a damaged frame. Nothing is decoded either way.
+*/
+#ifndef mp3audio_h
+#define mp3audio_h
+#include "types.h"
+#include "id3tag.h"
+
+#define AUDIO_CHUNK_SIZE (1 << 20)    // bytes per read of the frame walk
+#define AUDIO_PROBE_SIZE 4096         // bytes read around the first frame
+#define AUDIO_SEARCH_LIMIT (256 * 1024) // junk allowed in front of the first frame
+
+typedef struct audioinfo
+{
+	unsigned int version;      // 10 = MPEG 1, 20 = MPEG 2, 25 = MPEG 2.5
+	unsigned int layer;        // 1, 2 or 3
+	unsigned int sample_rate;  // Hz
+	unsigned int channels;     // 1 or 2
+	unsigned long frames;      // audio frames
+	unsigned long long bytes;  // audio bytes
+	double duration;           // seconds
+	unsigned int bitrate;      // kbit/s, average for VBR
+	int vbr;                   // bitrate changes between frames
+	const char *source;        // "Xing", "Info", "VBRI" or "scan"
+}AUDIOINFO;
+
+//Function to find where the audio starts and ends around a tag (NULL: no tag);
+void audio_range(int fd, const ID3TAG *id3tag, off_t file_size, off_t *start, off_t *end);
+
+//Function to find the duration and bitrate of the audio behind (or before) a tag;
+status read_audio_info(int fd, const ID3TAG *id3tag, AUDIOINFO *audioinfo);
+
+#endif
@@ -0,0 +1,479 @@
+/*
+File        : mp3batch.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the manifest driven bulk edit mode.
+
+              This file contains the function definitions required to:
+               - Read a CSV or TSV manifest and split it into rows in place
+               - Group the rows by file so every file is written once
+               - Edit the files with a bounded pool of worker threads,
+                 using the same MP3EDIT / edit_tag_data() path as "-e",
+                 with the syncs of many files done together
+               - Report the outcome of every row in manifest order
+
+              Notes:
+               - Rows of different files never share state, so workers
+                 only synchronise on the atomic group counter and on the
+                 commit queue.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3edit.h"
+#include "mp3batch.h"
+#include "mp3scan.h"
+#include "outbuf.h"
+#include "id3frames.h"
+
+//Function to read the batch options (-b <manifest> [-j <threads>]);
+status check_batch_args(int argc, char *argv[], MP3BATCH *mp3batch)
+{
+    int i;
+
+    mp3batch -> manifest = NULL;
+    mp3batch -> threads = default_threads();
+    for(i = 2; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            mp3batch -> manifest = argv[++i];
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            int threads = atoi(argv[++i]);
+            if(threads < 1 || threads > MAX_SCAN_THREADS)
+            {
+                printf("Error: thread count should be between 1 and %d\n", MAX_SCAN_THREADS);
+                return E_FAILURE;
+            }
+            mp3batch -> threads = threads;
+        }
+        else
+        {
+            printf("Error: unknown batch option '%s'\n", argv[i]);
+            return E_FAILURE;
+        }
+    }
+    if(mp3batch -> manifest == NULL)
+    {
+        printf("Error: missing manifest file name\n");
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+/* Function to cut the next field out of the manifest text in place;
+   *end_of_line is set when the field was the last one of its line */
+static char *next_field(char **cursor, char delimiter, int *end_of_line)
+{
+    char *read = *cursor, *write = *cursor, *field = *cursor;
+
+    if(delimiter == ',' && *read == '"')
+    {
+        // quoted CSV field: "" is a literal quote, delimiters and newlines are data
+        read++;
+        while(*read != '\0')
+        {
+            if(*read == '"' && read[1] == '"')
+            {
+                *write++ = '"';
+                read += 2;
+            }
+            else if(*read == '"')
+            {
+                read++;
+                break;
+            }
+            else
+            {
+                *write++ = *read++;
+            }
+        }
+    }
+    while(*read != '\0' && *read != delimiter && *read != '\n')
+    {
+        *write++ = *read++;
+    }
+    *end_of_line = *read != delimiter;
+    if(*read != '\0')
+    {
+        read++;
+    }
+    if(write > field && write[-1] == '\r')
+    {
+        write--;
+    }
+    *write = '\0';
+    *cursor = read;
+    return field;
+}
+
+//Function to turn the frame column into a frame id;
+static const char *column_to_tag(const char *frame)
+{
+    const char *tag = option_to_tag(frame);
+    if(tag != NULL)
+    {
+        return tag;
+    }
+    if(strlen(frame) != 4)
+    {
+        return NULL;
+    }
+    int i;
+    for(i = 0; i < 4; i++)
+    {
+        if(!isupper((unsigned char)frame[i]) && !isdigit((unsigned char)frame[i]))
+        {
+            return NULL;
+        }
+    }
+    return frame;
+}
+
+//Function to read and split the manifest into rows;
+status read_manifest(MP3BATCH *mp3batch)
+{
+    FILE *fptr = fopen(mp3batch -> manifest, "rb");
+    if(fptr == NULL)
+    {
+        perror("Error: Unable to open the manifest");
+        return E_FAILURE;
+    }
+
+    // read to EOF into a growing buffer: a pipe or a FIFO has no size to seek to
+    size_t size = 0, capacity = 0;
+    while(1)
+    {
+        if(size + 1 >= capacity)
+        {
+            size_t grown = capacity ? capacity * 2 : 65536;
+            char *text = realloc(mp3batch -> text, grown);
+            if(text == NULL)
+            {
+                break;
+            }
+            mp3batch -> text = text;
+            capacity = grown;
+        }
+        size_t bytes = fread(mp3batch -> text + size, 1, capacity - size - 1, fptr);
+        size += bytes;
+        if(bytes == 0)
+        {
+            break;
+        }
+    }
+    if(mp3batch -> text == NULL || size + 1 >= capacity || ferror(fptr))
+    {
+        printf("Error: Unable to read the manifest\n");
+        fclose(fptr);
+        return E_FAILURE;
+    }
+    fclose(fptr);
+    mp3batch -> text[size] = '\0';
+
+    // a tab on the first line makes it a TSV manifest
+    char *first_newline = strchr(mp3batch -> text, '\n');
+    char *first_tab = strchr(mp3batch -> text, '\t');
+    char delimiter = (first_tab != NULL && (first_newline == NULL || first_tab < first_newline)) ? '\t' : ',';
+
+    char *cursor = mp3batch -> text;
+    unsigned int line = 0;
+    struct stat st;
+    while(*cursor != '\0')
+    {
+        char *fields[3] = {NULL, NULL, NULL};
+        int columns = 0, end_of_line = 0;
+        line++;
+        while(!end_of_line)
+        {
+            char *field = next_field(&cursor, delimiter, &end_of_line);
+            if(columns < 3)
+            {
+                fields[columns] = field;
+            }
+            columns++;
+        }
+        if(columns == 1 && fields[0][0] == '\0')
+        {
+            continue;     // empty line
+        }
+        if(line == 1 && columns >= 2 && strcasecmp(fields[1], "frame") == 0)
+        {
+            continue;     // header row
+        }
+
+        if(mp3batch -> count == mp3batch -> capacity)
+        {
+            size_t capacity = mp3batch -> capacity ? mp3batch -> capacity * 2 : 256;
+            BATCHROW *rows = realloc(mp3batch -> rows, capacity * sizeof(BATCHROW));
+            if(rows == NULL)
+            {
+                return E_FAILURE;
+            }
+            mp3batch -> rows = rows;
+            mp3batch -> capacity = capacity;
+        }
+        BATCHROW *row = &mp3batch -> rows[mp3batch -> count++];
+        row -> line = line;
+        row -> path = fields[0];
+        row -> frame = fields[1] ? fields[1] : "";
+        row -> value = fields[2];
+        row -> tag = NULL;
+        row -> result = E_FAILURE;
+        if(columns != 3)
+        {
+            row -> message = "ERROR: expected path, frame and value";
+        }
+        else if((row -> tag = column_to_tag(row -> frame)) == NULL)
+        {
+            row -> message = "ERROR: unknown frame";
+        }
+        else if(!frame_is_editable(frame_id((const unsigned char *)row -> tag)))
+        {
+            row -> tag = NULL;
+            row -> message = "ERROR: only text and comment frames can be set";
+        }
+        else if(!has_mp3_extension(row -> path))
+        {
+            row -> tag = NULL;
+            row -> message = "ERROR: file extension should be .mp3";
+        }
+        else if(stat(row -> path, &st) != 0)
+        {
+            row -> tag = NULL;
+            row -> message = "Error: Unable to open The input file";
+        }
+        else
+        {
+            row -> dev = st.st_dev;
+            row -> ino = st.st_ino;
+            row -> message = NULL;
+        }
+    }
+    return E_SUCCESS;
+}
+
+/* Function to order rows by file and then by manifest line; the file is
+   its device and inode, so every spelling of one path lands in one group */
+static int compare_rows(const void *a, const void *b)
+{
+    const BATCHROW *row_a = *(BATCHROW * const *)a, *row_b = *(BATCHROW * const *)b;
+    if(row_a -> dev != row_b -> dev)
+    {
+        return row_a -> dev < row_b -> dev ? -1 : 1;
+    }
+    if(row_a -> ino != row_b -> ino)
+    {
+        return row_a -> ino < row_b -> ino ? -1 : 1;
+    }
+    return (row_a -> line > row_b -> line) - (row_a -> line < row_b -> line);
+}
+
+//Function to group the rows by file;
+status group_rows(MP3BATCH *mp3batch)
+{
+    size_t i, valid = 0;
+
+    mp3batch -> order = malloc((mp3batch -> count + 1) * sizeof(BATCHROW *));
+    mp3batch -> groups = malloc((mp3batch -> count + 1) * sizeof(size_t));
+    if(mp3batch -> order == NULL || mp3batch -> groups == NULL)
+    {
+        return E_FAILURE;
+    }
+    for(i = 0; i < mp3batch -> count; i++)
+    {
+        if(mp3batch -> rows[i].tag != NULL)
+        {
+            mp3batch -> order[valid++] = &mp3batch -> rows[i];
+        }
+    }
+    qsort(mp3batch -> order, valid, sizeof(BATCHROW *), compare_rows);
+
+    mp3batch -> ngroups = 0;
+    for(i = 0; i < valid; i++)
+    {
+        if(i == 0 || mp3batch -> order[i] -> dev != mp3batch -> order[i - 1] -> dev ||
+           mp3batch -> order[i] -> ino != mp3batch -> order[i - 1] -> ino)
+        {
+            mp3batch -> groups[mp3batch -> ngroups++] = i;
+        }
+    }
+    mp3batch -> groups[mp3batch -> ngroups] = valid;
+    return E_SUCCESS;
+}
+
+//Function to edit all files of one group;
+void edit_group(MP3BATCH *mp3batch, size_t group, ARENA *arena)
+{
+    BATCHROW **rows = mp3batch -> order + mp3batch -> groups[group];
+    size_t count = mp3batch -> groups[group + 1] - mp3batch -> groups[group];
+    MP3EDIT mp3edit = {0};
+    size_t i;
+    unsigned int j;
+
+    // later rows for the same frame win, like repeated options on the command line
+    mp3edit.input_file = rows[0] -> path;
+    mp3edit.arena = arena;
+    mp3edit.commit = &mp3batch -> commit;
+    mp3edit.commit_failed = &mp3batch -> commit_failed[group];
+    for(i = 0; i < count; i++)
+    {
+        if(add_frame_edit(&mp3edit, rows[i] -> tag, rows[i] -> value) != E_SUCCESS)
+        {
+            rows[i] -> message = "ERROR: too many frames for one file";
+            rows[i] -> tag = NULL;
+        }
+    }
+
+    status ret = open_files(&mp3edit);
+    if(ret == E_SUCCESS)
+    {
+        ret = edit_tag_data(&mp3edit);
+    }
+    for(i = 0; i < count; i++)
+    {
+        if(rows[i] -> tag == NULL)
+        {
+            continue;
+        }
+        if(ret != E_SUCCESS)
+        {
+            rows[i] -> message = mp3edit.error;
+            continue;
+        }
+        unsigned int id = frame_id((const unsigned char *)rows[i] -> tag);
+        for(j = 0; j < mp3edit.count; j++)
+        {
+            if(mp3edit.edits[j].id == id)
+            {
+                break;
+            }
+        }
+        if(j < mp3edit.count && mp3edit.edits[j].found)
+        {
+            rows[i] -> result = E_SUCCESS;
+            rows[i] -> message = "OK";
+        }
+        else
+        {
+            rows[i] -> message = "NOT FOUND";
+        }
+    }
+}
+
+//Function run by every worker thread;
+void *batch_worker(void *arg)
+{
+    MP3BATCH *mp3batch = arg;
+    ARENA arena = {0};
+    while(1)
+    {
+        size_t group = __atomic_fetch_add(&mp3batch -> next, 1, __ATOMIC_RELAXED);
+        if(group >= mp3batch -> ngroups)
+        {
+            break;
+        }
+        edit_group(mp3batch, group, &arena);
+        arena_reset(&arena);
+    }
+    arena_free(&arena);
+    return NULL;
+}
+
+//Function to run a whole manifest;
+status Mp3Batch(MP3BATCH *mp3batch)
+{
+    pthread_t workers[MAX_SCAN_THREADS];
+    unsigned int i, started = 0;
+    size_t row, group, failed = 0;
+
+    if(read_manifest(mp3batch) != E_SUCCESS || group_rows(mp3batch) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    if(mp3batch -> threads > mp3batch -> ngroups)
+    {
+        mp3batch -> threads = mp3batch -> ngroups ? mp3batch -> ngroups : 1;
+    }
+    mp3batch -> commit_failed = calloc(mp3batch -> ngroups + 1, sizeof(int));
+    if(mp3batch -> commit_failed == NULL || commit_group_init(&mp3batch -> commit, COMMIT_GROUP_SIZE) != E_SUCCESS)
+    {
+        printf("Error: out of memory\n");
+        return E_FAILURE;
+    }
+    for(i = 0; i < mp3batch -> threads; i++)
+    {
+        if(pthread_create(&workers[i], NULL, batch_worker, mp3batch) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if(started == 0)
+    {
+        batch_worker(mp3batch);
+    }
+    for(i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    // the last partial group; a file that could not be renamed fails all its rows
+    commit_group_free(&mp3batch -> commit);
+    for(group = 0; group < mp3batch -> ngroups; group++)
+    {
+        if(!mp3batch -> commit_failed[group])
+        {
+            continue;
+        }
+        for(row = mp3batch -> groups[group]; row < mp3batch -> groups[group + 1]; row++)
+        {
+            if(mp3batch -> order[row] -> result == E_SUCCESS)
+            {
+                mp3batch -> order[row] -> result = E_FAILURE;
+                mp3batch -> order[row] -> message = "Error replacing the original file";
+            }
+        }
+    }
+
+    // one result line per row, in manifest order
+    OUTBUF outbuf;
+    fflush(stdout);
+    outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL);
+    for(row = 0; row < mp3batch -> count; row++)
+    {
+        const BATCHROW *batchrow = &mp3batch -> rows[row];
+        outbuf_printf(&outbuf, "%u\t%s\t%s\t%s\n", batchrow -> line, batchrow -> path,
+                      batchrow -> frame, batchrow -> message);
+        outbuf_maybe_flush(&outbuf);
+        failed += batchrow -> result != E_SUCCESS;
+    }
+    outbuf_free(&outbuf);
+    printf("Processed %zu rows for %zu files with %u threads, %zu failed\n",
+           mp3batch -> count, mp3batch -> ngroups, mp3batch -> threads, failed);
+    return failed ? E_FAILURE : E_SUCCESS;
+}
+
+//Function to release the manifest and the rows;
+void free_batch(MP3BATCH *mp3batch)
+{
+    free(mp3batch -> text);
+    free(mp3batch -> rows);
+    free(mp3batch -> order);
+    free(mp3batch -> groups);
+    free(mp3batch -> commit_failed);
+    mp3batch -> commit_failed = NULL;
+    mp3batch -> text = NULL;
+    mp3batch -> rows = NULL;
+    mp3batch -> order = NULL;
+    mp3batch -> groups = NULL;
+}
@@ -0,0 +1,92 @@
+/*
+File        : mp3batch.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the manifest driven bulk edit mode.
+
+              This file contains the structure definitions and function
+              prototypes required to apply a whole CSV/TSV manifest of
+              (path, frame, value) rows with one process.
+
+              Key Components:
+               - BATCHROW : One manifest row and its result.
+               - MP3BATCH : All rows, the rows grouped by file and the
+                            worker settings.
+
+              Batch Workflow:
+               1. User runs "./a.out -e -b <manifest> [-j <threads>]".
+               2. The manifest is read; rows are "path,frame,value" (CSV,
+                  double quotes allowed) or "path<TAB>frame<TAB>value"
+                  (TSV). The frame is the id of a text or comment frame
+                  (TIT2, TPE1, COMM, ...) or an edit option (-t, -a, ...);
+                  other frames (APIC, TXXX, W***) are refused per row.
+                  A header row is skipped.
+               3. Rows are grouped by file (device and inode, taken when
+                  the manifest is read, so "x.mp3" and "./x.mp3" are one
+                  file), and every file gets all of its assignments in one
+                  MP3EDIT and is written at most once.
+               4. Worker threads edit the files, at most "-j" at a time.
+                  Written files are committed in groups (see COMMITGROUP
+                  in mp3edit.h): one syncfs() for up to COMMIT_GROUP_SIZE
+                  files before they are renamed and one after.
+               5. A result line is printed for every row, in manifest order.
+*/
+#ifndef mp3batch_h
+#define mp3batch_h
+#include <stddef.h>
+#include <sys/types.h>
+#include "types.h"
+#include "arena.h"
+#include "mp3edit.h"
+
+typedef struct batch_row
+{
+	unsigned int line;       // line number in the manifest
+	char *path;              // file to edit
+	dev_t dev;               // device and inode of the file, the
+	ino_t ino;               // rows of one file are grouped by them
+	char *frame;             // frame column as written in the manifest
+	const char *tag;         // frame id, NULL when the column is invalid
+	char *value;             // new content
+	status result;           // outcome of the row
+	const char *message;     // "OK", "NOT FOUND" or the error
+}BATCHROW;
+
+typedef struct mp3batch
+{
+	char *manifest;          // manifest file name
+	char *text;              // manifest contents, rows point into it
+	unsigned int threads;    // number of worker threads
+	BATCHROW *rows;          // rows in manifest order
+	size_t count;            // number of rows
+	size_t capacity;         // allocated rows
+	BATCHROW **order;        // valid rows sorted by file
+	size_t *groups;          // start of every file group in order, plus the end
+	size_t ngroups;          // number of files
+	size_t next;             // next group to hand out (atomic)
+	COMMITGROUP commit;      // written files waiting for the next group sync
+	int *commit_failed;      // per file group: set when its file could not be committed
+}MP3BATCH;
+
+//Function to read the batch options (-b <manifest> [-j <threads>]);
+status check_batch_args(int argc, char *argv[], MP3BATCH *mp3batch);
+
+//Function to run a whole manifest;
+status Mp3Batch(MP3BATCH *mp3batch);
+
+//Function to read and split the manifest into rows;
+status read_manifest(MP3BATCH *mp3batch);
+
+//Function to group the rows by file;
+status group_rows(MP3BATCH *mp3batch);
+
+//Function to edit all files of one group;
+void edit_group(MP3BATCH *mp3batch, size_t group, ARENA *arena);
+
+//Function run by every worker thread;
+void *batch_worker(void *arg);
+
+//Function to release the manifest and the rows;
+void free_batch(MP3BATCH *mp3batch);
+
+#endif
@@ -0,0 +1,441 @@
+/*
+File        : mp3catalog.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the in-memory tag catalogue of a library.
+
+              This file contains the function definitions required to:
+               - Intern strings into a pool, each distinct string once
+               - Append the tags of a parsed file as a row of string ids
+               - Read back values and paths of a row
+               - Order the rows by any column
+
+              Notes:
+               - Column arrays and the pool grow by doubling, so adding a
+                 row is amortised O(1) plus one hash probe per value.
+*/
+#define _GNU_SOURCE          // qsort_r()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3catalog.h"
+
+#define STRPOOL_MIN_SLOTS 1024
+#define STRPOOL_MIN_DATA (64 * 1024)
+
+//Function to hash a string (FNV-1a);
+static unsigned long long hash_text(const char *text, size_t length)
+{
+    unsigned long long hash = 1469598103934665603ULL;
+    while(length--)
+    {
+        hash = (hash ^ (unsigned char)*text++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+//Function to double the hash of the pool once it is half full;
+static status grow_slots(STRPOOL *pool)
+{
+    unsigned int nslots = pool -> slots ? (pool -> mask + 1) * 2 : STRPOOL_MIN_SLOTS;
+    unsigned int *slots = calloc(nslots, sizeof(unsigned int));
+    unsigned int i;
+
+    if(slots == NULL)
+    {
+        return E_FAILURE;
+    }
+    for(i = 0; i < pool -> count; i++)
+    {
+        unsigned int slot = hash_text(pool -> data + pool -> offsets[i], pool -> lengths[i]) & (nslots - 1);
+        while(slots[slot] != 0)
+        {
+            slot = (slot + 1) & (nslots - 1);
+        }
+        slots[slot] = i + 1;
+    }
+    free(pool -> slots);
+    pool -> slots = slots;
+    pool -> mask = nslots - 1;
+    return E_SUCCESS;
+}
+
+//Function to store a new string at the end of the pool;
+static status append_text(STRPOOL *pool, const char *text, size_t length)
+{
+    if(pool -> used + length + 1 > pool -> size)
+    {
+        size_t size = pool -> size ? pool -> size : STRPOOL_MIN_DATA;
+        while(pool -> used + length + 1 > size)
+        {
+            size *= 2;
+        }
+        char *data = realloc(pool -> data, size);
+        if(data == NULL)
+        {
+            return E_FAILURE;
+        }
+        pool -> data = data;
+        pool -> size = size;
+    }
+    if(pool -> count == pool -> capacity)
+    {
+        unsigned int capacity = pool -> capacity ? pool -> capacity * 2 : STRPOOL_MIN_SLOTS;
+        size_t *offsets = realloc(pool -> offsets, capacity * sizeof(size_t));
+        if(offsets == NULL)
+        {
+            return E_FAILURE;
+        }
+        pool -> offsets = offsets;
+        unsigned int *lengths = realloc(pool -> lengths, capacity * sizeof(unsigned int));
+        if(lengths == NULL)
+        {
+            return E_FAILURE;
+        }
+        pool -> lengths = lengths;
+        pool -> capacity = capacity;
+    }
+    memcpy(pool -> data + pool -> used, text, length);
+    pool -> data[pool -> used + length] = '\0';
+    pool -> offsets[pool -> count] = pool -> used;
+    pool -> lengths[pool -> count] = length;
+    pool -> used += length + 1;
+    return E_SUCCESS;
+}
+
+//Function to set up an empty pool holding only the empty string;
+status strpool_init(STRPOOL *pool)
+{
+    memset(pool, 0, sizeof(*pool));
+    return strpool_intern(pool, "", 0) == 0 ? E_SUCCESS : E_FAILURE;
+}
+
+//Function to get the id of a string without adding it (UINT_MAX: not in the pool);
+unsigned int strpool_find(const STRPOOL *pool, const char *text, size_t length)
+{
+    unsigned int slot = hash_text(text, length) & pool -> mask;
+    while(pool -> slots[slot] != 0)
+    {
+        unsigned int id = pool -> slots[slot] - 1;
+        if(pool -> lengths[id] == length && memcmp(pool -> data + pool -> offsets[id], text, length) == 0)
+        {
+            return id;
+        }
+        slot = (slot + 1) & pool -> mask;
+    }
+    return UINT_MAX;
+}
+
+//Function to get the id of a string, adding it when it is new (UINT_MAX: out of memory);
+unsigned int strpool_intern(STRPOOL *pool, const char *text, size_t length)
+{
+    if(length > UINT_MAX || pool -> count == UINT_MAX - 1)
+    {
+        return UINT_MAX;
+    }
+    if((pool -> count + 1) * 2 > (pool -> slots ? pool -> mask + 1 : 0) && grow_slots(pool) != E_SUCCESS)
+    {
+        return UINT_MAX;
+    }
+    unsigned int id = strpool_find(pool, text, length);
+    if(id != UINT_MAX)
+    {
+        return id;
+    }
+    unsigned int slot = hash_text(text, length) & pool -> mask;
+    while(pool -> slots[slot] != 0)
+    {
+        slot = (slot + 1) & pool -> mask;
+    }
+    if(append_text(pool, text, length) != E_SUCCESS)
+    {
+        return UINT_MAX;
+    }
+    pool -> slots[slot] = ++pool -> count;
+    return pool -> count - 1;
+}
+
+//Function to get a string of the pool by its id;
+const char *strpool_get(const STRPOOL *pool, unsigned int id, unsigned int *length)
+{
+    if(length != NULL)
+    {
+        *length = pool -> lengths[id];
+    }
+    return pool -> data + pool -> offsets[id];
+}
+
+//Function to release the pool;
+void strpool_free(STRPOOL *pool)
+{
+    free(pool -> data);
+    free(pool -> offsets);
+    free(pool -> lengths);
+    free(pool -> slots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+//Function to set up an empty catalogue with the six tags or the --fields frames;
+status catalog_init(MP3CATALOG *catalog, const FIELDSET *fields)
+{
+    static const char *ids[MAX_TAGS] = {"TIT2", "TPE1", "TALB", "TYER", "TCON", "COMM"};
+    unsigned int i;
+
+    memset(catalog, 0, sizeof(*catalog));
+    catalog -> ncolumns = fields != NULL ? fields -> count : MAX_TAGS;
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        snprintf(catalog -> ids[i], MAX_LEN, "%s", fields != NULL ? fields -> names[i] : ids[i]);
+    }
+    if(strpool_init(&catalog -> pool) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    pthread_mutex_init(&catalog -> lock, NULL);
+    return E_SUCCESS;
+}
+
+//Function to make room for one more row in every column;
+static status grow_rows(MP3CATALOG *catalog)
+{
+    size_t capacity = catalog -> capacity ? catalog -> capacity * 2 : 4096;
+    unsigned int **arrays[MAX_FIELDS + 2];
+    unsigned int i, narrays = 0;
+
+    arrays[narrays++] = &catalog -> dirs;
+    arrays[narrays++] = &catalog -> names;
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        arrays[narrays++] = &catalog -> columns[i];
+    }
+    for(i = 0; i < narrays; i++)
+    {
+        unsigned int *array = realloc(*arrays[i], capacity * sizeof(unsigned int));
+        if(array == NULL)
+        {
+            return E_FAILURE;
+        }
+        *arrays[i] = array;
+    }
+    catalog -> capacity = capacity;
+    return E_SUCCESS;
+}
+
+//Function to append one row, the caller holds the lock;
+static status add_row(MP3CATALOG *catalog, const MP3VIEW *mp3view)
+{
+    const char *path = mp3view -> sample_mp3_fname;
+    const char *slash = strrchr(path, '/');
+    size_t dir_length = slash != NULL ? (size_t)(slash - path) + 1 : 0;
+    unsigned int i;
+
+    if(catalog -> count == catalog -> capacity && grow_rows(catalog) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    size_t row = catalog -> count;
+    // the directory keeps its trailing '/', so dir + name is the path again
+    unsigned int dir = strpool_intern(&catalog -> pool, path, dir_length);
+    unsigned int name = strpool_intern(&catalog -> pool, path + dir_length, strlen(path + dir_length));
+    if(dir == UINT_MAX || name == UINT_MAX)
+    {
+        return E_FAILURE;
+    }
+    catalog -> dirs[row] = dir;
+    catalog -> names[row] = name;
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        const MP3VIEWINFO *info = mp3view -> fields != NULL ? &mp3view -> fieldinfo[i] : &mp3view -> mp3viewinfo[i];
+        const char *value = mp3view -> fields != NULL ? field_value(mp3view, i) : tag_value(mp3view, i);
+        unsigned int id = strpool_intern(&catalog -> pool, value, info -> length);
+        if(id == UINT_MAX)
+        {
+            return E_FAILURE;
+        }
+        catalog -> columns[i][row] = id;
+    }
+    catalog -> count++;
+    return E_SUCCESS;
+}
+
+//Function to add the tags of one parsed file as a new row;
+status catalog_add(MP3CATALOG *catalog, const MP3VIEW *mp3view)
+{
+    pthread_mutex_lock(&catalog -> lock);
+    status ret = add_row(catalog, mp3view);
+    pthread_mutex_unlock(&catalog -> lock);
+    return ret;
+}
+
+//Function to find the column of a frame id ("file" for the path, -1 if unknown);
+int catalog_column(const MP3CATALOG *catalog, const char *id)
+{
+    unsigned int i;
+    if(strcmp(id, "file") == 0)
+    {
+        return CATALOG_FILE_COLUMN;
+    }
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        if(strcmp(catalog -> ids[i], id) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//Function to get the value of one frame of one row;
+const char *catalog_value(const MP3CATALOG *catalog, size_t row, unsigned int column, unsigned int *length)
+{
+    return strpool_get(&catalog -> pool, catalog -> columns[column][row], length);
+}
+
+//Function to write the full path of one row into a buffer;
+size_t catalog_path(const MP3CATALOG *catalog, size_t row, char *buffer, size_t size)
+{
+    unsigned int dir_length, name_length;
+    const char *dir = strpool_get(&catalog -> pool, catalog -> dirs[row], &dir_length);
+    const char *name = strpool_get(&catalog -> pool, catalog -> names[row], &name_length);
+    return snprintf(buffer, size, "%.*s%.*s", (int)dir_length, dir, (int)name_length, name);
+}
+
+//Function to order two strings of the pool by their bytes;
+int strpool_compare(const STRPOOL *pool, unsigned int x, unsigned int y)
+{
+    unsigned int xlength = pool -> lengths[x], ylength = pool -> lengths[y];
+    int ret = memcmp(pool -> data + pool -> offsets[x], pool -> data + pool -> offsets[y], xlength < ylength ? xlength : ylength);
+    return ret != 0 ? ret : (xlength > ylength) - (xlength < ylength);
+}
+
+//Function to order two pool ids by their strings, for qsort_r();
+static int compare_strings(const void *a, const void *b, void *arg)
+{
+    return strpool_compare(arg, *(const unsigned int *)a, *(const unsigned int *)b);
+}
+
+//Function to order two 64 bit keys;
+static int compare_keys(const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+//Function to give every string of the pool its position in byte order;
+static unsigned int *rank_strings(const STRPOOL *pool)
+{
+    unsigned int *order = malloc(pool -> count * sizeof(unsigned int));
+    unsigned int *rank = malloc(pool -> count * sizeof(unsigned int));
+    unsigned int i;
+
+    if(order == NULL || rank == NULL)
+    {
+        free(order);
+        free(rank);
+        return NULL;
+    }
+    for(i = 0; i < pool -> count; i++)
+    {
+        order[i] = i;
+    }
+    qsort_r(order, pool -> count, sizeof(unsigned int), compare_strings, (void *)pool);
+    for(i = 0; i < pool -> count; i++)
+    {
+        rank[order[i]] = i;
+    }
+    free(order);
+    return rank;
+}
+
+/* Function to sort (key << 32 | row) pairs and leave the rows in order; with
+   more than 2^32 rows the row would not fit, which the catalogue's 32 bit
+   string ids rule out long before */
+static void sort_rows(unsigned long long *keys, size_t count, size_t *rows)
+{
+    size_t i;
+    qsort(keys, count, sizeof(unsigned long long), compare_keys);
+    for(i = 0; i < count; i++)
+    {
+        rows[i] = keys[i] & 0xFFFFFFFFULL;
+    }
+}
+
+//Function to fill rows with the catalogue in path order;
+static void sort_by_path(const MP3CATALOG *catalog, const unsigned int *rank, unsigned long long *keys, size_t *rows)
+{
+    size_t i, count = catalog -> count;
+
+    // path order first: directory, then name inside it
+    for(i = 0; i < count; i++)
+    {
+        keys[i] = (unsigned long long)rank[catalog -> dirs[i]] << 32 | i;
+    }
+    sort_rows(keys, count, rows);
+    for(i = 0; i < count; )
+    {
+        // files of one directory, ordered by name
+        size_t j = i;
+        unsigned int dir = catalog -> dirs[rows[i]];
+        for(; j < count && catalog -> dirs[rows[j]] == dir; j++)
+        {
+            keys[j] = (unsigned long long)rank[catalog -> names[rows[j]]] << 32 | rows[j];
+        }
+        sort_rows(keys + i, j - i, rows + i);
+        i = j;
+    }
+}
+
+//Function to get the rows ordered by one column, then by path (free() the result);
+size_t *catalog_sort(const MP3CATALOG *catalog, int column)
+{
+    size_t i, count = catalog -> count;
+    size_t *rows = malloc((count ? count : 1) * sizeof(size_t));
+    size_t *positions = malloc((count ? count : 1) * sizeof(size_t));
+    unsigned long long *keys = malloc((count ? count : 1) * sizeof(unsigned long long));
+    unsigned int *rank = rank_strings(&catalog -> pool);
+
+    if(rows == NULL || positions == NULL || keys == NULL || rank == NULL)
+    {
+        free(rows);
+        free(positions);
+        free(keys);
+        free(rank);
+        return NULL;
+    }
+    sort_by_path(catalog, rank, keys, column == CATALOG_FILE_COLUMN ? rows : positions);
+    if(column != CATALOG_FILE_COLUMN)
+    {
+        // then the column, ties keep their path order (the position is the low half)
+        for(i = 0; i < count; i++)
+        {
+            keys[i] = (unsigned long long)rank[catalog -> columns[column][positions[i]]] << 32 | i;
+        }
+        qsort(keys, count, sizeof(unsigned long long), compare_keys);
+        for(i = 0; i < count; i++)
+        {
+            rows[i] = positions[keys[i] & 0xFFFFFFFFULL];
+        }
+    }
+    free(positions);
+    free(keys);
+    free(rank);
+    return rows;
+}
+
+//Function to release the catalogue;
+void catalog_free(MP3CATALOG *catalog)
+{
+    unsigned int i;
+    free(catalog -> dirs);
+    free(catalog -> names);
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        free(catalog -> columns[i]);
+    }
+    strpool_free(&catalog -> pool);
+    pthread_mutex_destroy(&catalog -> lock);
+    memset(catalog, 0, sizeof(*catalog));
+}
@@ -0,0 +1,109 @@
+/*
+File        : mp3catalog.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the in-memory tag catalogue of a library.
+
+              This file contains the structure definitions and function
+              prototypes required to keep the tags of millions of files
+              in memory as columns of small integers, so they can be
+              sorted, grouped and exported after a scan.
+
+              Key Components:
+               - STRPOOL   : Every distinct string once, back to back in
+                             one buffer, and a hash on its bytes. A string
+                             is known by its id (0 is the empty string).
+               - MP3CATALOG: One row per file. The path is split into a
+                             directory id and a name id, and every frame
+                             has a column of string ids. All ids point
+                             into the same pool.
+
+              Memory Layout (n files, c frames):
+               | dirs[n] | names[n] | column[0][n] ... column[c-1][n] |   4 bytes each
+               | pool: distinct directories, names and values          |
+               An artist, album, genre or year shared by thousands of
+               tracks is stored once, so ten million tracks with the six
+               default frames take about 320 MB of ids plus the pool.
+
+              Notes:
+               - catalog_add() may be called from several scan workers,
+                 rows are appended under the catalogue lock.
+               - Sorting compares string ids through a rank table built
+                 once per sort, so the row sort itself only compares
+                 integers.
+*/
+#ifndef mp3catalog_h
+#define mp3catalog_h
+#include <stddef.h>
+#include <pthread.h>
+#include "types.h"
+#include "mp3view.h"
+
+#define CATALOG_FILE_COLUMN MAX_FIELDS   // "column" number of the path in catalog_sort()
+
+typedef struct strpool
+{
+	char *data;                  // every string, each followed by '\0'
+	size_t used;                 // bytes of data in use
+	size_t size;                 // bytes of data allocated
+	size_t *offsets;             // start of every string in data, by id
+	unsigned int *lengths;       // length of every string, by id
+	unsigned int count;          // distinct strings
+	unsigned int capacity;       // allocated entries of offsets and lengths
+	unsigned int *slots;         // hash of the strings: id + 1, 0 = empty
+	unsigned int mask;           // number of slots - 1
+}STRPOOL;
+
+typedef struct mp3catalog
+{
+	unsigned int ncolumns;       // frames per row
+	char ids[MAX_FIELDS][MAX_LEN]; // frame id of every column
+	unsigned int *dirs;          // directory of every file (string id)
+	unsigned int *names;         // name of every file (string id)
+	unsigned int *columns[MAX_FIELDS]; // value of every frame (string id)
+	size_t count;                // rows
+	size_t capacity;             // allocated rows
+	STRPOOL pool;
+	pthread_mutex_t lock;        // serialises catalog_add() of the workers
+}MP3CATALOG;
+
+//Function to set up an empty pool holding only the empty string;
+status strpool_init(STRPOOL *pool);
+
+//Function to get the id of a string, adding it when it is new (UINT_MAX: out of memory);
+unsigned int strpool_intern(STRPOOL *pool, const char *text, size_t length);
+
+//Function to get the id of a string without adding it (UINT_MAX: not in the pool);
+unsigned int strpool_find(const STRPOOL *pool, const char *text, size_t length);
+
+//Function to order two strings of the pool by their bytes;
+int strpool_compare(const STRPOOL *pool, unsigned int x, unsigned int y);
+
+//Function to get a string of the pool by its id;
+const char *strpool_get(const STRPOOL *pool, unsigned int id, unsigned int *length);
+
+//Function to release the pool;
+void strpool_free(STRPOOL *pool);
+
+//Function to set up an empty catalogue with the six tags or the --fields frames;
+status catalog_init(MP3CATALOG *catalog, const FIELDSET *fields);
+
+//Function to add the tags of one parsed file as a new row;
+status catalog_add(MP3CATALOG *catalog, const MP3VIEW *mp3view);
+
+//Function to find the column of a frame id ("file" for the path, -1 if unknown);
+int catalog_column(const MP3CATALOG *catalog, const char *id);
+
+//Function to get the value of one frame of one row;
+const char *catalog_value(const MP3CATALOG *catalog, size_t row, unsigned int column, unsigned int *length);
+
+//Function to write the full path of one row into a buffer;
+size_t catalog_path(const MP3CATALOG *catalog, size_t row, char *buffer, size_t size);
+
+//Function to get the rows ordered by one column, then by path (free() the result);
+size_t *catalog_sort(const MP3CATALOG *catalog, int column);
+
+//Function to release the catalogue;
+void catalog_free(MP3CATALOG *catalog);
+
+#endif
@@ -0,0 +1,539 @@
+/*
+File        : mp3dup.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the duplicate audio finder.
+
+              This file contains the function definitions required to:
+               - Read the duplicate options from the command line
+               - Find the audio range of every file with worker threads
+               - Narrow the candidates by audio length, then by a probe
+                 hash of the first bytes, before any file is read in full
+               - Hash the mapped audio of the remaining files
+               - Print the sets of files with the same audio
+
+              Notes:
+               - Every pass hands out files with an atomic counter, like
+                 the scan workers (see mp3scan.c).
+               - The audio range is found with audio_range(), the same code
+                 that gives the duration in the single file view.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "id3tag.h"
+#include "mp3audio.h"
+#include "mp3scan.h"
+#include "mp3dup.h"
+#include "mp3format.h"
+#include "outbuf.h"
+#include "stats.h"
+
+#define XXH_PRIME1 11400714785074694791ULL
+#define XXH_PRIME2 14029467366897019727ULL
+#define XXH_PRIME3 1609587929392839161ULL
+#define XXH_PRIME4 9650029242287828579ULL
+#define XXH_PRIME5 2870177450012600261ULL
+
+//Function to read the duplicate options (-d <dir> [-j <threads>]);
+status check_dup_args(int argc, char *argv[], MP3DUP *mp3dup)
+{
+    int i;
+
+    mp3dup -> scan.root = NULL;
+    mp3dup -> scan.threads = default_threads();
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+        {
+            mp3dup -> scan.root = argv[++i];
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            int threads = atoi(argv[++i]);
+            if(threads < 1 || threads > MAX_SCAN_THREADS)
+            {
+                printf("Error: thread count should be between 1 and %d\n", MAX_SCAN_THREADS);
+                return E_FAILURE;
+            }
+            mp3dup -> scan.threads = threads;
+        }
+        else
+        {
+            printf("Error: unknown duplicate option '%s'\n", argv[i]);
+            return E_FAILURE;
+        }
+    }
+    if(mp3dup -> scan.root == NULL)
+    {
+        printf("Error: missing directory name\n");
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to rotate a 64 bit value left;
+static inline unsigned long long rotl64(unsigned long long value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+//Function to mix 8 input bytes into one accumulator;
+static inline unsigned long long xxh_round(unsigned long long acc, unsigned long long input)
+{
+    acc += input * XXH_PRIME2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME1;
+}
+
+//Function to fold one lane accumulator into the hash;
+static inline unsigned long long xxh_merge(unsigned long long hash, unsigned long long acc)
+{
+    hash ^= xxh_round(0, acc);
+    return hash * XXH_PRIME1 + XXH_PRIME4;
+}
+
+//Function to read 8 little endian bytes;
+static inline unsigned long long read64(const unsigned char *ptr)
+{
+    unsigned long long value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+//Function to read 4 little endian bytes;
+static inline unsigned int read32(const unsigned char *ptr)
+{
+    unsigned int value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+/* Function to hash a buffer with 64 bit xxHash; four independent lanes take
+   32 bytes per step, so the loop runs at memory speed */
+unsigned long long dup_hash(const void *data, size_t length, unsigned long long seed)
+{
+    const unsigned char *ptr = data;
+    const unsigned char *end = ptr + length;
+    unsigned long long hash;
+
+    if(length >= 32)
+    {
+        unsigned long long v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        unsigned long long v2 = seed + XXH_PRIME2;
+        unsigned long long v3 = seed;
+        unsigned long long v4 = seed - XXH_PRIME1;
+        const unsigned char *limit = end - 32;
+        do
+        {
+            v1 = xxh_round(v1, read64(ptr));
+            v2 = xxh_round(v2, read64(ptr + 8));
+            v3 = xxh_round(v3, read64(ptr + 16));
+            v4 = xxh_round(v4, read64(ptr + 24));
+            ptr += 32;
+        }while(ptr <= limit);
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = xxh_merge(hash, v1);
+        hash = xxh_merge(hash, v2);
+        hash = xxh_merge(hash, v3);
+        hash = xxh_merge(hash, v4);
+    }
+    else
+    {
+        hash = seed + XXH_PRIME5;
+    }
+    hash += length;
+
+    while(ptr + 8 <= end)
+    {
+        hash ^= xxh_round(0, read64(ptr));
+        hash = rotl64(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+        ptr += 8;
+    }
+    if(ptr + 4 <= end)
+    {
+        hash ^= (unsigned long long)read32(ptr) * XXH_PRIME1;
+        hash = rotl64(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+        ptr += 4;
+    }
+    while(ptr < end)
+    {
+        hash ^= *ptr++ * XXH_PRIME5;
+        hash = rotl64(hash, 11) * XXH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+//Function to get the audio length of a file;
+static inline off_t audio_length(const DUPFILE *dupfile)
+{
+    return dupfile -> end - dupfile -> start;
+}
+
+//Function to find where the audio of one file starts and ends;
+static status find_range(DUPFILE *dupfile, int fd)
+{
+    struct stat st;
+    ID3TAG id3tag = {0};
+
+    if(fstat(fd, &st) != 0)
+    {
+        return E_FAILURE;
+    }
+    // a file without a tag is all audio (minus its tails)
+    int tagged = id3_read_header(fd, &id3tag) == E_SUCCESS;
+    audio_range(fd, tagged ? &id3tag : NULL, st.st_size, &dupfile -> start, &dupfile -> end);
+    return E_SUCCESS;
+}
+
+//Function to hash the first DUP_PROBE_SIZE audio bytes of one file;
+static status probe_file(MP3DUP *mp3dup, DUPFILE *dupfile, int fd, unsigned char *buffer)
+{
+    off_t length = audio_length(dupfile);
+    size_t want = length < DUP_PROBE_SIZE ? (size_t)length : DUP_PROBE_SIZE;
+    ssize_t bytes = pread(fd, buffer, want, dupfile -> start);
+    STATS_IO(stat_bytes_read, bytes);
+    if(bytes != (ssize_t)want)
+    {
+        return E_FAILURE;
+    }
+    dupfile -> probe = dup_hash(buffer, want, 0);
+    if((off_t)want == length)
+    {
+        // the probe already covered all of the audio
+        dupfile -> hash = dupfile -> probe;
+        __atomic_fetch_add(&mp3dup -> hashed, want, __ATOMIC_RELAXED);
+    }
+    return E_SUCCESS;
+}
+
+//Function to map the audio of one file and hash all of it;
+static status hash_file(MP3DUP *mp3dup, DUPFILE *dupfile, int fd)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    off_t base = dupfile -> start & ~((off_t)page - 1);
+    size_t skip = dupfile -> start - base;
+    size_t size = skip + (dupfile -> end - dupfile -> start);
+    unsigned char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, base);
+    STATS_COUNT(stat_syscalls, 1);
+    if(map == MAP_FAILED)
+    {
+        return E_FAILURE;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    dupfile -> hash = dup_hash(map + skip, size - skip, 0);
+    STATS_COUNT(stat_bytes_read, size - skip);
+    __atomic_fetch_add(&mp3dup -> hashed, size - skip, __ATOMIC_RELAXED);
+    munmap(map, size);
+    // the audio is not needed again, keep the cache for the rest of the system
+    posix_fadvise(fd, base, size, POSIX_FADV_DONTNEED);
+    return E_SUCCESS;
+}
+
+//Function run by every worker thread for the current pass;
+static void *dup_worker(void *arg)
+{
+    MP3DUP *mp3dup = arg;
+    unsigned char *buffer = NULL;
+
+    if(mp3dup -> pass == dup_pass_probe && (buffer = malloc(DUP_PROBE_SIZE)) == NULL)
+    {
+        return NULL;
+    }
+    while(1)
+    {
+        size_t index = __atomic_fetch_add(&mp3dup -> next, 1, __ATOMIC_RELAXED);
+        if(index >= mp3dup -> nwork)
+        {
+            break;
+        }
+        DUPFILE *dupfile = mp3dup -> work[index];
+        if(mp3dup -> pass == dup_pass_hash && audio_length(dupfile) <= DUP_PROBE_SIZE)
+        {
+            continue;       // the probe hashed all of it already
+        }
+        int fd = open(dupfile -> path, O_RDONLY | O_CLOEXEC);
+        STATS_COUNT(stat_syscalls, 1);
+        status ret = E_FAILURE;
+        if(fd >= 0)
+        {
+            if(mp3dup -> pass == dup_pass_range)
+            {
+                ret = find_range(dupfile, fd);
+            }
+            else if(mp3dup -> pass == dup_pass_probe)
+            {
+                ret = probe_file(mp3dup, dupfile, fd, buffer);
+            }
+            else
+            {
+                ret = hash_file(mp3dup, dupfile, fd);
+            }
+            close(fd);
+        }
+        if(ret != E_SUCCESS)
+        {
+            dupfile -> failed = 1;
+            __atomic_fetch_add(&mp3dup -> failed, 1, __ATOMIC_RELAXED);
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+//Function to run one pass over the work list with the worker threads;
+static void run_pass(MP3DUP *mp3dup, DupPass pass)
+{
+    pthread_t workers[MAX_SCAN_THREADS];
+    unsigned int i, started = 0;
+    unsigned int threads = mp3dup -> scan.threads;
+
+    mp3dup -> pass = pass;
+    mp3dup -> next = 0;
+    if(threads > mp3dup -> nwork)
+    {
+        threads = mp3dup -> nwork ? mp3dup -> nwork : 1;
+    }
+    for(i = 0; i < threads; i++)
+    {
+        if(pthread_create(&workers[i], NULL, dup_worker, mp3dup) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if(started == 0)
+    {
+        // no thread could be started, do the work on this one
+        dup_worker(mp3dup);
+    }
+    for(i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+}
+
+//Function to order files by audio length;
+static int compare_length(const void *a, const void *b)
+{
+    off_t x = audio_length(*(DUPFILE * const *)a), y = audio_length(*(DUPFILE * const *)b);
+    return (x > y) - (x < y);
+}
+
+//Function to order files by audio length, then probe hash;
+static int compare_probe(const void *a, const void *b)
+{
+    const DUPFILE *x = *(DUPFILE * const *)a, *y = *(DUPFILE * const *)b;
+    int ret = compare_length(a, b);
+    return ret != 0 ? ret : (x -> probe > y -> probe) - (x -> probe < y -> probe);
+}
+
+//Function to order files by audio length, then full hash, then name;
+static int compare_hash(const void *a, const void *b)
+{
+    const DUPFILE *x = *(DUPFILE * const *)a, *y = *(DUPFILE * const *)b;
+    int ret = compare_length(a, b);
+    if(ret == 0)
+    {
+        ret = (x -> hash > y -> hash) - (x -> hash < y -> hash);
+    }
+    return ret != 0 ? ret : strcmp(x -> path, y -> path);
+}
+
+/* Function to sort the work list and keep only the files that share their
+   key with another file; returns the number of files kept */
+static size_t keep_shared(MP3DUP *mp3dup, int (*compare)(const void *, const void *))
+{
+    size_t i, run, kept = 0;
+
+    qsort(mp3dup -> work, mp3dup -> nwork, sizeof(DUPFILE *), compare);
+    for(i = 0; i < mp3dup -> nwork; i = run)
+    {
+        for(run = i + 1; run < mp3dup -> nwork && compare(&mp3dup -> work[i], &mp3dup -> work[run]) == 0; run++)
+        {
+        }
+        if(run - i < 2)
+        {
+            continue;
+        }
+        for(; i < run; i++)
+        {
+            mp3dup -> work[kept++] = mp3dup -> work[i];
+        }
+    }
+    mp3dup -> nwork = kept;
+    return kept;
+}
+
+//Function to drop the files that failed in the last pass from the work list;
+static void drop_failed(MP3DUP *mp3dup)
+{
+    size_t i, kept = 0;
+    for(i = 0; i < mp3dup -> nwork; i++)
+    {
+        if(!mp3dup -> work[i] -> failed)
+        {
+            mp3dup -> work[kept++] = mp3dup -> work[i];
+        }
+    }
+    mp3dup -> nwork = kept;
+}
+
+//Function to check whether two sorted files hold the same audio;
+static int same_audio(const DUPFILE *x, const DUPFILE *y)
+{
+    return audio_length(x) == audio_length(y) && x -> hash == y -> hash;
+}
+
+//Function to print one set of files with the same audio;
+static void print_set(DUPFILE **set, size_t count, unsigned long number, OUTBUF *outbuf, OutputFormat format)
+{
+    size_t i;
+    char hash[17];
+
+    snprintf(hash, sizeof(hash), "%016llx", set[0] -> hash);
+    if(format == format_jsonl)
+    {
+        outbuf_printf(outbuf, "{\"hash\":\"%s\",\"bytes\":%lld,\"files\":[", hash, (long long)audio_length(set[0]));
+        for(i = 0; i < count; i++)
+        {
+            outbuf_append(outbuf, i ? ",\"" : "\"", i ? 2 : 1);
+            outbuf_append_json(outbuf, set[i] -> path, strlen(set[i] -> path));
+            outbuf_append(outbuf, "\"", 1);
+        }
+        outbuf_append(outbuf, "]}\n", 3);
+    }
+    else if(format == format_tsv)
+    {
+        for(i = 0; i < count; i++)
+        {
+            outbuf_printf(outbuf, "%s\t%lld\t", hash, (long long)audio_length(set[i]));
+            outbuf_append_tsv(outbuf, set[i] -> path, strlen(set[i] -> path));
+            outbuf_append(outbuf, "\n", 1);
+        }
+    }
+    else
+    {
+        outbuf_printf(outbuf, "Duplicate set %lu: %zu files, %lld bytes of audio, hash %s\n", number, count,
+                      (long long)audio_length(set[0]), hash);
+        for(i = 0; i < count; i++)
+        {
+            outbuf_printf(outbuf, "    %s\n", set[i] -> path);
+        }
+        outbuf_append(outbuf, "\n", 1);
+    }
+    outbuf_maybe_flush(outbuf);
+}
+
+//Function to find and print every set of files with the same audio;
+status Mp3Dup(MP3DUP *mp3dup)
+{
+    MP3SCAN *scan = &mp3dup -> scan;
+    size_t i, run, sets = 0, copies = 0;
+    unsigned long long wasted = 0;
+
+    if(collect_mp3files(scan, scan -> root) != E_SUCCESS && scan -> count == 0)
+    {
+        return E_FAILURE;
+    }
+    mp3dup -> files = calloc(scan -> count ? scan -> count : 1, sizeof(DUPFILE));
+    mp3dup -> work = malloc((scan -> count ? scan -> count : 1) * sizeof(DUPFILE *));
+    if(mp3dup -> files == NULL || mp3dup -> work == NULL)
+    {
+        printf("Error: out of memory\n");
+        return E_FAILURE;
+    }
+    for(i = 0; i < scan -> count; i++)
+    {
+        mp3dup -> files[i].path = scan -> files[i];
+        mp3dup -> work[i] = &mp3dup -> files[i];
+    }
+    mp3dup -> nwork = scan -> count;
+
+    // pass 1: the audio range of every file, from its tag header and tails
+    run_pass(mp3dup, dup_pass_range);
+    drop_failed(mp3dup);
+    // an empty audio range is not worth reporting
+    for(i = run = 0; i < mp3dup -> nwork; i++)
+    {
+        if(audio_length(mp3dup -> work[i]) > 0)
+        {
+            mp3dup -> work[run++] = mp3dup -> work[i];
+        }
+    }
+    mp3dup -> nwork = run;
+
+    // pass 2: a probe hash for every file whose length is not unique
+    if(keep_shared(mp3dup, compare_length) > 0)
+    {
+        run_pass(mp3dup, dup_pass_probe);
+        drop_failed(mp3dup);
+    }
+
+    // pass 3: a full hash where length and probe still match
+    size_t probed = mp3dup -> nwork;
+    if(keep_shared(mp3dup, compare_probe) > 0)
+    {
+        run_pass(mp3dup, dup_pass_hash);
+        drop_failed(mp3dup);
+    }
+
+    fflush(stdout);
+    OutputFormat format = scan -> format;
+    FILE *summary = format == format_text ? stdout : stderr;
+    OUTBUF outbuf;
+    if(outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    if(format == format_tsv)
+    {
+        outbuf_append(&outbuf, "hash\tbytes\tfile\n", 16);
+    }
+    qsort(mp3dup -> work, mp3dup -> nwork, sizeof(DUPFILE *), compare_hash);
+    for(i = 0; i < mp3dup -> nwork; i = run)
+    {
+        for(run = i + 1; run < mp3dup -> nwork && same_audio(mp3dup -> work[i], mp3dup -> work[run]); run++)
+        {
+        }
+        if(run - i < 2)
+        {
+            continue;
+        }
+        print_set(mp3dup -> work + i, run - i, ++sets, &outbuf, format);
+        copies += run - i - 1;
+        wasted += (unsigned long long)audio_length(mp3dup -> work[i]) * (run - i - 1);
+    }
+    if(outbuf_free(&outbuf) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+
+    fprintf(summary, "Checked %zu files with %u threads: %zu probed, %llu bytes hashed, %lu failed\n",
+            scan -> count, scan -> threads, probed, mp3dup -> hashed, mp3dup -> failed);
+    fprintf(summary, "%zu duplicate sets, %zu redundant copies holding %llu bytes of audio\n", sets, copies, wasted);
+    return mp3dup -> failed ? E_FAILURE : E_SUCCESS;
+}
+
+//Function to release the files and the scan;
+void free_dup(MP3DUP *mp3dup)
+{
+    free(mp3dup -> files);
+    free(mp3dup -> work);
+    mp3dup -> files = NULL;
+    mp3dup -> work = NULL;
+    mp3dup -> nwork = 0;
+    free_scan(&mp3dup -> scan);
+}
@@ -0,0 +1,91 @@
+/*
+File        : mp3dup.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the duplicate audio finder.
+
+              This file contains the structure definitions and function
+              prototypes required to find files below a directory that
+              hold the same audio, whatever their tags say.
+
+              Key Components:
+               - DUPFILE : One collected file, the byte range of its audio
+                           (after the ID3v2 tag, before any ID3v1 / APEv2
+                           tail) and the hashes taken of that range.
+               - MP3DUP  : The scan (root, file names, thread count), the
+                           files, the work list of the current pass and
+                           the totals of the run.
+
+              Duplicate Workflow:
+               1. User runs "./a.out -d <dir> [-j <threads>]".
+               2. The tree is walked like a scan (collect_mp3files()) and
+                  the workers find the audio range of every file; only
+                  the tag header and the last 160 bytes are read.
+               3. Files whose audio length nobody else shares cannot have
+                  a duplicate and are never read.
+               4. The rest get a probe hash of their first DUP_PROBE_SIZE
+                  audio bytes; files still sharing (length, probe) get the
+                  audio mapped and hashed in full with a 64 bit xxHash.
+               5. Files with the same (length, hash) form one duplicate
+                  set; sets are printed by audio length.
+
+              Notes:
+               - The hash is not cryptographic: it finds copies, it does
+                 not defend against files crafted to collide.
+               - Mapped audio is dropped from the page cache once it is
+                 hashed, so hashing a library larger than memory does not
+                 push everything else out.
+               - --format=jsonl prints one set per line and --format=tsv
+                 one file per row; the summary then goes to stderr.
+*/
+#ifndef mp3dup_h
+#define mp3dup_h
+#include <stddef.h>
+#include <sys/types.h>
+#include "types.h"
+#include "mp3scan.h"
+
+#define DUP_PROBE_SIZE (64 * 1024)       // audio bytes hashed before a full hash
+
+typedef enum
+{
+	dup_pass_range,          // find the audio range of every file
+	dup_pass_probe,          // hash the first DUP_PROBE_SIZE audio bytes
+	dup_pass_hash            // hash the whole audio
+}DupPass;
+
+typedef struct dupfile
+{
+	char *path;              // file name (owned by the scan)
+	off_t start;             // first audio byte
+	off_t end;               // one past the last audio byte
+	unsigned long long probe;  // hash of the first DUP_PROBE_SIZE audio bytes
+	unsigned long long hash;   // hash of the whole audio
+	int failed;              // the file could not be read
+}DUPFILE;
+
+typedef struct mp3dup
+{
+	MP3SCAN scan;            // root, thread count and collected names
+	DUPFILE *files;          // one per collected name
+	DUPFILE **work;          // files of the current pass
+	size_t nwork;
+	size_t next;             // next entry of work to hand out (atomic)
+	DupPass pass;
+	unsigned long failed;    // files that could not be read (atomic)
+	unsigned long long hashed; // audio bytes hashed (atomic)
+}MP3DUP;
+
+//Function to read the duplicate options (-d <dir> [-j <threads>]);
+status check_dup_args(int argc, char *argv[], MP3DUP *mp3dup);
+
+//Function to find and print every set of files with the same audio;
+status Mp3Dup(MP3DUP *mp3dup);
+
+//Function to hash a buffer with 64 bit xxHash;
+unsigned long long dup_hash(const void *data, size_t length, unsigned long long seed);
+
+//Function to release the files and the scan;
+void free_dup(MP3DUP *mp3dup);
+
+#endif
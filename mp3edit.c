@@ -1,264 +1,894 @@
-/*
-File        : mp3edit.c
-Author      : G C Phaneendra
-Roll No     : 25008_031
-Description : Implementation file for MP3 Tag Editing functionality.
-
-              This file contains the function definitions required to
-              modify ID3v2 metadata tags in MP3 files. It works by scanning
-              the MP3's tag frames, locating the desired frame, replacing its
-              data with user-provided content, and writing the modified data
-              to a new file.
-
-              Features:
-               - Parse command-line arguments to identify the tag to edit
-               - Validate new MP3 file extension before editing
-               - Open input and output MP3 files in binary mode
-               - Locate and update the selected ID3v2 frame (e.g., TIT2, TPE1)
-               - Preserve all other frames and file content without changes
-               - Replace the original file with the updated one after editing
-
-              Supported Tag Edit Options:
-               -t : Title    (TIT2)
-               -a : Artist   (TPE1)
-               -A : Album    (TALB)
-               -y : Year     (TYER)
-               -m : Genre    (TCON)
-               -c : Comment  (COMM)
-
-              Editing Workflow:
-               1. User runs the program with -e and a tag option;
- */
-#include <stdio.h>
-#include "types.h"
-#include "mp3edit.h"
-#include <string.h>
-#include "mp3view.h"
-#include <stdlib.h>
-
-char *edit_tag[6] = {"-t", "-a", "-A", "-y", "-m", "-c"};
-
-//Function to edit content;
-status mp3_edit(MP3EDIT *mp3edit, char *argv[])
-{
-    unsigned short int i;
-    unsigned short int found = 0;
-    for(i = 0; i < 6; i++)
-    {
-          if(strcmp(argv[2], edit_tag[i]) == 0)
-         {
-              found = 1;
-               switch (argv[2][1])
-              {
-                      case 't': strcpy(mp3edit -> tag, "TIT2"); break;
-                      case 'a': strcpy(mp3edit -> tag, "TPE1"); break;
-                      case 'A': strcpy(mp3edit -> tag, "TALB"); break;
-                      case 'y': strcpy(mp3edit -> tag, "TYER"); break;
-                      case 'm': strcpy(mp3edit -> tag, "TCON"); break;
-                      case 'c': strcpy(mp3edit -> tag, "COMM"); break;
-                     default:
-                      printf("Error: Unsupported tag option '%s'\n", argv[2]);
-                     return E_FAILURE;
-               }
-          
-              if(argv[3] == NULL)
-              {
-               printf("Error missing new content for editing\n");
-               return E_FAILURE;
-              }
-              size_t len = strlen(argv[3]);
-              strcpy(mp3edit->data, argv[3]);
-              mp3edit->data[len] = '\0';
-              mp3edit -> size = len;
-               if(check_for_newfileextension(mp3edit, argv) != E_SUCCESS)
-               {
-                return E_FAILURE;
-               }
-               return E_SUCCESS;
-          }
-     }
-
-    if(!found)
-    {
-      printf("we'r here to help you every step of the way\n");
-           printf("-t -> to edit song title\n");
-           printf("-a to edit artist name\n");
-           printf("-A to edit album name\n");
-           printf("-y to edit year\n");
-           printf("-m to edit content\n");
-           printf("-c to edit comment\n");
-           return E_FAILURE;
-    }
-}
-
-//Function to check the new file extension;
- status check_for_newfileextension(MP3EDIT *mp3edit, char *argv[])
- {
-     if(argv[4] == NULL)
-     {
-        printf("Error: missing output file name\n");
-        return E_FAILURE;
-     }
-      char *temp = strrchr(argv[4], '.');
-      if(temp != NULL && strcmp(temp, ".mp3") == 0)
-      {
-           mp3edit -> input_file = argv[4]; 
-           return E_SUCCESS;
-      }
-      else
-      {
-           printf("Nem file extension should be .mp3\n");
-           return E_FAILURE;
-      }
-
-  }
-
-
-  /* Function to open input and output files */
-    status open_files(MP3EDIT *mp3edit)
-   {
-      mp3edit -> fptr_input_file = fopen(mp3edit -> input_file, "rb");
-
-      if(mp3edit -> fptr_input_file  == NULL)
-      {
-              perror("Error: Unable to open The input file");
-              return E_FAILURE;
-      }
-      else
-      {
-            printf("The input file was opened successfully\n");
-      }
-
-      mp3edit -> fptr_output_file =  fopen("output.mp3", "wb");
-      if(mp3edit -> fptr_output_file   == NULL)
-      {
-         perror("Error opening output file");
-         return E_FAILURE;
-      }
-      else
-      {
-          printf("The output file was opened successfully\n");
-      }
-     return E_SUCCESS;
-      
-  }
-
-
-
-/* Function to edit tag data */
-status edit_tag_data(MP3EDIT *mp3edit)
-{
-    // Copy ID3v2 header
-    rewind(mp3edit -> fptr_input_file);
-    char header[10];
-    fread(header, 1, 10,  mp3edit -> fptr_input_file);
-    fwrite(header, 1, 10,  mp3edit -> fptr_output_file);
-    int edited = 0;
-    while (1)
-{
-    char frame_id[5] = {0};
-    unsigned char size_buf[4], flags[2];
-    unsigned char encoding;
-    
-    // Frame ID
-    if (fread(frame_id, 1, 4, mp3edit->fptr_input_file) != 4 || frame_id[0] == 0x00)
-        break;
-    
-    // Frame size
-    if (fread(size_buf, 1, 4, mp3edit->fptr_input_file) != 4)
-        break;
-    
-    int frame_size = convert_to_littleEndian((char *)size_buf);
-    
-    // Frame flags
-    if (fread(flags, 1, 2, mp3edit->fptr_input_file) != 2)
-        break;
-    
-    // Encoding byte
-    if (fread(&encoding, 1, 1, mp3edit->fptr_input_file) != 1)
-        break;
-
-    // Remaining frame data
-    char *data = malloc(frame_size - 1);
-    if (!data) return E_FAILURE;
-    if (fread(data, 1, frame_size - 1, mp3edit->fptr_input_file) != frame_size - 1)
-    {
-        free(data);
-        return E_FAILURE;
-    }
-
-    if (strncmp(frame_id, mp3edit->tag, 4) == 0)
-    {
-        int new_size = strlen(mp3edit->data) + 1;
-        unsigned char new_size_buf[4] = {
-            (new_size >> 24) & 0xFF,
-            (new_size >> 16) & 0xFF,
-            (new_size >> 8) & 0xFF,
-            new_size & 0xFF
-        };
-        fwrite(frame_id, 1, 4, mp3edit->fptr_output_file);
-        fwrite(new_size_buf, 1, 4, mp3edit->fptr_output_file);
-        fwrite(flags, 1, 2, mp3edit->fptr_output_file);
-        fwrite(&encoding, 1, 1, mp3edit->fptr_output_file);
-        fwrite(mp3edit->data, 1, new_size - 1, mp3edit->fptr_output_file);
-        edited = 1;
-    }
-    else
-    {
-        // Copy original frame exactly
-        fwrite(frame_id, 1, 4, mp3edit->fptr_output_file);
-        fwrite(size_buf, 1, 4, mp3edit->fptr_output_file);
-        fwrite(flags, 1, 2, mp3edit->fptr_output_file);
-        fwrite(&encoding, 1, 1, mp3edit->fptr_output_file);
-        fwrite(data, 1, frame_size - 1, mp3edit->fptr_output_file);
-    }
-
-    free(data);
-}
-
-
-    // copy remaining data to output file;
-    char buffer[4096];
-    size_t bytes;
-    while ((bytes = fread(buffer, 1, sizeof(buffer), mp3edit->fptr_input_file)) > 0)
-    {
-       fwrite(buffer, 1, bytes, mp3edit->fptr_output_file);
-    }
-
-    fclose(mp3edit -> fptr_input_file);
-    fclose(mp3edit -> fptr_output_file);
-
-    if (edited)
-    {
-        remove(mp3edit -> input_file);
-        rename("output.mp3", mp3edit -> input_file);
-        
-     printf("✅ Tag '%s' updated successfully.\n", mp3edit -> tag);
-    }
-    else
-    {
-        remove("output.mp3");
-        printf("⚠  Frame '%s' not found. No changes made.\n", mp3edit -> tag);
-    }
-
-    return  E_SUCCESS;
-}
-
-          
-        
-
-         
-    
-
-    
-    
-
-
-//Function to convert big endian to little endian;
-int convert_to_littleEndian(const char *buffer)
-{
-    return ((unsigned char)buffer[0] << 24) |
-           ((unsigned char)buffer[1] << 16) |
-           ((unsigned char)buffer[2] << 8) |
-           (unsigned char)buffer[3];
-}
+/*
+File        : mp3edit.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for MP3 Tag Editing functionality.
+
+              This file contains the function definitions required to
+              modify ID3v2 metadata tags in MP3 files. It works by scanning
+              the MP3's tag frames, locating the desired frame, replacing its
+              data with user-provided content, and writing the modified data
+              to a new file.
+
+              Features:
+               - Parse command-line arguments to identify the tag to edit
+               - Validate new MP3 file extension before editing
+               - Open the MP3 file in binary read/write mode
+               - Load the whole ID3v2 tag and rebuild its frames in memory
+               - Locate and update the selected ID3v2 frame (e.g., TIT2, TPE1)
+               - Preserve all other frames and file content without changes
+               - Rewrite only the tag region in place (pwrite) when the new
+                 frames fit into the existing tag and its padding
+               - Otherwise copy everything to a new file with a bigger tag,
+                 moving the audio data with copy_file_range() / sendfile()
+                 (an O_TMPFILE next to the original, named with linkat()
+                 once complete) and rename it over the original file
+               - Sync the new data before the rename and the directory
+                 after it, or queue the file in a COMMITGROUP that syncs
+                 many files at once (bulk edits)
+
+              Supported Tag Edit Options:
+               -t : Title    (TIT2)
+               -a : Artist   (TPE1)
+               -A : Album    (TALB)
+               -y : Year     (TYER)
+               -m : Genre    (TCON)
+               -c : Comment  (COMM)
+
+              Editing Workflow:
+               1. User runs the program with -e and a tag option;
+ */
+#define _GNU_SOURCE          // copy_file_range()
+#include <stdio.h>
+#include "types.h"
+#include "mp3edit.h"
+#include <string.h>
+#include "mp3view.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include "id3tag.h"
+#include "stats.h"
+#include "mp3text.h"
+#include "id3frames.h"
+
+/* Function to map an edit option to its frame id; options are two
+   characters, so the letter alone picks the frame */
+const char *option_to_tag(const char *option)
+{
+    if(option[0] != '-' || option[1] == '\0' || option[2] != '\0')
+    {
+        return NULL;
+    }
+    switch (option[1])
+    {
+        case 't': return "TIT2";
+        case 'a': return "TPE1";
+        case 'A': return "TALB";
+        case 'y': return "TYER";
+        case 'm': return "TCON";
+        case 'c': return "COMM";
+    }
+    return NULL;
+}
+
+//Function to add one frame assignment, a later one for the same frame wins;
+status add_frame_edit(MP3EDIT *mp3edit, const char *tag, char *data)
+{
+    unsigned int i, id = frame_id((const unsigned char *)tag);
+    for(i = 0; i < mp3edit -> count; i++)
+    {
+        if(mp3edit -> edits[i].id == id)
+        {
+            break;
+        }
+    }
+    if(i == MAX_EDITS)
+    {
+        return E_FAILURE;
+    }
+    strcpy(mp3edit -> edits[i].tag, tag);
+    mp3edit -> edits[i].id = id;
+    mp3edit -> edits[i].data = data;
+    mp3edit -> edits[i].size = strlen(data);
+    mp3edit -> edits[i].found = 0;
+    if(i == mp3edit -> count)
+    {
+        mp3edit -> count++;
+    }
+    return E_SUCCESS;
+}
+
+//Function to edit content;
+status mp3_edit(MP3EDIT *mp3edit, char *argv[])
+{
+    int i;
+    mp3edit -> count = 0;
+
+    // any number of "<option> <new_text>" pairs, the last argument is the file
+    for(i = 2; argv[i] != NULL && argv[i + 1] != NULL; i += 2)
+    {
+          const char *tag = option_to_tag(argv[i]);
+          if(tag == NULL)
+          {
+              break;
+          }
+          if(add_frame_edit(mp3edit, tag, argv[i + 1]) != E_SUCCESS)
+          {
+              printf("Error: too many tag options\n");
+              return E_FAILURE;
+          }
+    }
+
+    if(mp3edit -> count == 0 || (argv[i] != NULL && argv[i + 1] != NULL))
+    {
+      if(argv[i] != NULL && argv[i + 1] == NULL && option_to_tag(argv[i]) != NULL)
+      {
+           printf("Error missing new content for editing\n");
+           return E_FAILURE;
+      }
+      printf("we'r here to help you every step of the way\n");
+           printf("-t -> to edit song title\n");
+           printf("-a to edit artist name\n");
+           printf("-A to edit album name\n");
+           printf("-y to edit year\n");
+           printf("-m to edit content\n");
+           printf("-c to edit comment\n");
+           return E_FAILURE;
+    }
+    return check_for_newfileextension(mp3edit, argv[i]);
+}
+
+//Function to check the new file extension;
+ status check_for_newfileextension(MP3EDIT *mp3edit, char *fname)
+ {
+     if(fname == NULL)
+     {
+        printf("Error: missing output file name\n");
+        return E_FAILURE;
+     }
+      // "-" edits the stream on stdin into stdout (see mp3stream.h)
+      if(has_mp3_extension(fname) || strcmp(fname, "-") == 0)
+      {
+           mp3edit -> input_file = fname; 
+           return E_SUCCESS;
+      }
+      else
+      {
+           printf("Nem file extension should be .mp3\n");
+           return E_FAILURE;
+      }
+
+  }
+
+
+  /* Function to open the input file for in-place editing */
+    status open_files(MP3EDIT *mp3edit)
+   {
+      STATS_BEGIN(start);
+      mp3edit -> fptr_input_file = fopen(mp3edit -> input_file, "r+b");
+      STATS_COUNT(stat_syscalls, 1);
+      STATS_END(phase_open, start);
+
+      if(mp3edit -> fptr_input_file  == NULL)
+      {
+              mp3edit -> error = "Error: Unable to open The input file";
+              return E_FAILURE;
+      }
+      // the temporary output file is only created by copy_to_output_file() when the tag has to grow
+      mp3edit -> fptr_output_file = NULL;
+     return E_SUCCESS;
+      
+  }
+
+
+
+/* Function to find the pending edit of a frame by its integer id; frames
+   that are not text or comments are never rewritten, their payload has a
+   layout the new text cannot be put into */
+static FRAMEEDIT *find_frame_edit(MP3EDIT *mp3edit, const unsigned char *frame)
+{
+    unsigned int i, id = frame_id(frame);
+    if(!frame_is_editable(id))
+    {
+        return NULL;
+    }
+    for(i = 0; i < mp3edit -> count; i++)
+    {
+        if(!mp3edit -> edits[i].found && mp3edit -> edits[i].id == id)
+        {
+            return &mp3edit -> edits[i];
+        }
+    }
+    return NULL;
+}
+
+/* Function to get the most the edits can add to a tag body: one frame
+   header, the encoding byte, a comment language and empty description
+   and the encoded text per edit; the edits are marked as not found yet */
+size_t edit_growth(MP3EDIT *mp3edit)
+{
+    size_t grow = 0;
+    unsigned int i;
+    for(i = 0; i < mp3edit -> count; i++)
+    {
+        mp3edit -> edits[i].found = 0;
+        grow += FRAME_HEADER_SIZE + 1 + 3 + 4 + TEXT_MAX_ENCODED(mp3edit -> edits[i].size);
+    }
+    return grow;
+}
+
+/* Function to rebuild the frames of a loaded tag into body (at least
+   size + edit_growth() bytes, zeroed) with the edits applied; only the
+   first matching frame of each edit is replaced. Returns the end of the
+   frames in body, *edit_offset is where the first replaced frame starts */
+unsigned int rebuild_tag_frames(MP3EDIT *mp3edit, const ID3TAG *id3tag, unsigned char *body,
+                                unsigned int *edit_offset, int *edited)
+{
+    unsigned int in = id3tag -> frames_start, out = id3tag -> frames_start;
+    *edit_offset = 0;
+    *edited = 0;
+    memcpy(body, id3tag -> buffer, id3tag -> frames_start);
+    while(in < id3tag -> used)
+    {
+        const unsigned char *frame = id3tag -> buffer + in;
+        unsigned int frame_size = convert_to_littleEndian((const char *)frame + 4);
+        FRAMEEDIT *edit = frame_size >= 1 ? find_frame_edit(mp3edit, frame) : NULL;
+
+        if(edit != NULL)
+        {
+            /* the new text is UTF-8; it is stored in the encoding of the old
+               frame, or as UTF-16 when an ISO-8859-1 frame cannot hold it */
+            /* a compressed, encrypted or grouped frame does not start with
+               its encoding byte and language: they are not taken from it */
+            int plain = !(frame[9] & FRAME_FORMAT_FLAGS);
+            const unsigned char *text = (const unsigned char *)edit -> data;
+            unsigned int encoding = text_pick_encoding(plain ? frame[FRAME_HEADER_SIZE] : TEXT_LATIN1, text, edit -> size);
+            unsigned char *data = body + out + FRAME_HEADER_SIZE;
+            size_t pos = 0;
+            if(!*edited)
+            {
+                *edit_offset = out;
+            }
+            data[pos++] = encoding;
+            const FRAMESLOT *known = frame_lookup(frame_id(frame));
+            if(known != NULL && known -> kind == frame_comment)
+            {
+                // keep the language, the description is left empty
+                memcpy(data + pos, plain && frame_size >= 4 ? (const char *)frame + FRAME_HEADER_SIZE + 1 : "eng", 3);
+                pos += 3;
+                pos += text_from_utf8(encoding, (const unsigned char *)"", 0, data + pos);
+                data[pos++] = 0;
+                if(encoding == TEXT_UTF16 || encoding == TEXT_UTF16BE)
+                {
+                    data[pos++] = 0;  // UTF-16 strings end with two zero bytes
+                }
+            }
+            pos += text_from_utf8(encoding, text, edit -> size, data + pos);
+            unsigned int new_frame_size = pos;
+            memcpy(body + out, frame, 4);                         // frame id
+            int_to_bigendian(new_frame_size, body + out + 4);     // new frame size
+            body[out + 8] = frame[8];                             // status flags
+            body[out + 9] = frame[9] & ~FRAME_FORMAT_FLAGS;       // the new payload is plain text
+            out += FRAME_HEADER_SIZE + new_frame_size;
+            edit -> found = 1;
+            *edited = 1;
+        }
+        else
+        {
+            // Copy original frame exactly
+            memcpy(body + out, frame, FRAME_HEADER_SIZE + frame_size);
+            out += FRAME_HEADER_SIZE + frame_size;
+        }
+        in += FRAME_HEADER_SIZE + frame_size;
+    }
+    return out;
+}
+
+/* Function to edit tag data; all frame assignments are applied in one
+   pass over the tag and the file is written at most once */
+status edit_tag_data(MP3EDIT *mp3edit)
+{
+    ID3TAG id3tag;
+    int fd = fileno(mp3edit -> fptr_input_file);
+    ARENA own_arena = {0};
+    ARENA *arena = mp3edit -> arena != NULL ? mp3edit -> arena : &own_arena;
+
+    // the tag and the rebuilt tag both come from the per-file arena
+    id3tag.arena = arena;
+    STATS_BEGIN(start);
+    status found = id3_read_tag(fd, &id3tag);
+    STATS_END(phase_read_tag, start);
+    if(found != E_SUCCESS)
+    {
+        arena_free(&own_arena);
+        mp3edit -> error = "Error: ID3v2 tag was not found in the file";
+        fclose(mp3edit -> fptr_input_file);
+        return E_FAILURE;
+    }
+    if(id3tag.header[3] != 3 || (id3tag.header[5] & 0x80))
+    {
+        mp3edit -> error = "Error: only ID3v2.3 tags without unsynchronisation can be edited";
+        arena_free(&own_arena);
+        fclose(mp3edit -> fptr_input_file);
+        return E_FAILURE;
+    }
+
+    size_t grow = edit_growth(mp3edit);
+    unsigned char *body = arena_calloc(arena, id3tag.size + grow);
+    if(body == NULL)
+    {
+        mp3edit -> error = "Error: out of memory";
+        arena_free(&own_arena);
+        fclose(mp3edit -> fptr_input_file);
+        return E_FAILURE;
+    }
+
+    unsigned int in = id3tag.used, edit_offset = 0;      // the old frames end at used
+    int edited = 0;
+    unsigned int out = rebuild_tag_frames(mp3edit, &id3tag, body, &edit_offset, &edited);
+
+    status ret = E_SUCCESS;
+    if(!edited)
+    {
+        // nothing to write
+    }
+    else if(out <= id3tag.size)
+    {
+        /* new frames fit into the old tag and its padding: rewrite only the
+           bytes from the first edited frame up to the old end of frames, the
+           part between out and in is zero (arena_calloc) and becomes padding */
+        size_t length = (out > in ? out : in) - edit_offset;
+        STATS_BEGIN(write_start);
+        ssize_t written = pwrite(fd, body + edit_offset, length, id3tag.offset + ID3_HEADER_SIZE + edit_offset);
+        STATS_IO(stat_bytes_written, written);
+        STATS_END(phase_write, write_start);
+        if(written != (ssize_t)length)
+        {
+            mp3edit -> error = "Error: Unable to update the tag";
+            ret = E_FAILURE;
+        }
+        else if(mp3edit -> commit != NULL)
+        {
+            // synced together with the rest of the group
+            if(commit_group_add(mp3edit -> commit, NULL, mp3edit -> input_file, mp3edit -> commit_failed) != E_SUCCESS)
+            {
+                mp3edit -> error = "Error: Unable to update the tag";
+                ret = E_FAILURE;
+            }
+        }
+        else
+        {
+            STATS_BEGIN(sync_start);
+            int synced = fdatasync(fd);
+            STATS_COUNT(stat_syscalls, 1);
+            STATS_END(phase_sync, sync_start);
+            if(synced != 0)
+            {
+                mp3edit -> error = "Error: Unable to update the tag";
+                ret = E_FAILURE;
+            }
+        }
+    }
+    else
+    {
+        ret = copy_to_output_file(mp3edit, &id3tag, body, out);
+    }
+
+    arena_free(&own_arena);
+    if(mp3edit -> fptr_input_file != NULL)
+    {
+        fclose(mp3edit -> fptr_input_file);
+    }
+    return ret;
+}
+
+//Function to report which frames were updated;
+void display_edit_result(MP3EDIT *mp3edit)
+{
+    unsigned int i;
+    for(i = 0; i < mp3edit -> count; i++)
+    {
+        if(mp3edit -> edits[i].found)
+        {
+            printf("✅ Tag '%s' updated successfully.\n", mp3edit -> edits[i].tag);
+        }
+        else
+        {
+            printf("⚠  Frame '%s' not found. No changes made.\n", mp3edit -> edits[i].tag);
+        }
+    }
+}
+
+//Function to open the directory that holds a file;
+static int open_parent_dir(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    if(slash == NULL)
+    {
+        return open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+    if(slash == path)
+    {
+        return open("/", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+    char *dir = strndup(path, slash - path);
+    STATS_COUNT(stat_mallocs, 1);
+    if(dir == NULL)
+    {
+        return -1;
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    free(dir);
+    return fd;
+}
+
+/* Function to give a finished O_TMPFILE file a unique name next to the
+   file it replaces; linkat() never overwrites, so a taken name is retried */
+static status link_temp_file(int fd, const char *target, char *name, size_t length)
+{
+    static unsigned int counter;
+    char proc_path[32];
+    int attempt;
+
+    snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", fd);
+    for(attempt = 0; attempt < 64; attempt++)
+    {
+        unsigned int n = __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+        snprintf(name, length, "%s.%06x", target, ((unsigned int)getpid() * 2654435761u + n) & 0xFFFFFF);
+        // AT_EMPTY_PATH needs CAP_DAC_READ_SEARCH, the /proc link works for everyone
+        if(linkat(fd, "", AT_FDCWD, name, AT_EMPTY_PATH) == 0 ||
+           linkat(AT_FDCWD, proc_path, AT_FDCWD, name, AT_SYMLINK_FOLLOW) == 0)
+        {
+            return E_SUCCESS;
+        }
+        if(errno != EEXIST)
+        {
+            return E_FAILURE;
+        }
+    }
+    return E_FAILURE;
+}
+
+//Function to remove an unfinished output file;
+static void discard_output_file(MP3EDIT *mp3edit, char *output_file, int linked, int dir_fd)
+{
+    if(mp3edit -> fptr_output_file != NULL)
+    {
+        fclose(mp3edit -> fptr_output_file);
+        mp3edit -> fptr_output_file = NULL;
+    }
+    if(linked)
+    {
+        unlink(output_file);
+    }
+    free(output_file);
+    if(dir_fd >= 0)
+    {
+        close(dir_fd);
+    }
+}
+
+/* Function to rewrite the whole file when the tag has to grow; the new
+   file is built in the directory of the original (so concurrent edits
+   never share a temporary file and the final rename() stays on the same
+   file system), synced, named and then renamed over it */
+status copy_to_output_file(MP3EDIT *mp3edit, ID3TAG *id3tag, const unsigned char *body, unsigned int used)
+{
+    struct stat st;
+    size_t length = strlen(mp3edit -> input_file) + sizeof(".XXXXXX");
+    char *output_file = malloc(length);
+    int dir_fd = open_parent_dir(mp3edit -> input_file);
+    int fd = -1, linked = 0;
+
+    STATS_COUNT(stat_mallocs, 1);
+    STATS_BEGIN(start);
+    mp3edit -> fptr_output_file = NULL;
+    if(output_file != NULL && dir_fd >= 0)
+    {
+        // unnamed until it is complete: a crash while writing leaves nothing behind
+        fd = openat(dir_fd, ".", O_TMPFILE | O_WRONLY | O_CLOEXEC, 0600);
+    }
+    if(output_file != NULL && fd < 0)
+    {
+        // no O_TMPFILE on this kernel or file system: a named file next to the original
+        snprintf(output_file, length, "%s.XXXXXX", mp3edit -> input_file);
+        fd = mkstemp(output_file);
+        linked = fd >= 0;
+    }
+    if(fd < 0 || (mp3edit -> fptr_output_file = fdopen(fd, "wb")) == NULL)
+    {
+       mp3edit -> error = "Error opening output file";
+       if(fd >= 0)
+       {
+           close(fd);
+       }
+       discard_output_file(mp3edit, output_file, linked, dir_fd);
+       return E_FAILURE;
+    }
+    // keep the permissions of the original file
+    if(fstat(fileno(mp3edit -> fptr_input_file), &st) == 0)
+    {
+        fchmod(fd, st.st_mode & 07777);
+    }
+
+    // whatever precedes a located tag (junk, or the audio of an appended tag) is kept
+    if(id3tag -> offset > 0 && copy_audio_data(fileno(mp3edit -> fptr_input_file), 0, id3tag -> offset, fd) != E_SUCCESS)
+    {
+        mp3edit -> error = "Error writing output file";
+        discard_output_file(mp3edit, output_file, linked, dir_fd);
+        return E_FAILURE;
+    }
+
+    // new header with the grown size, followed by the frames and fresh padding
+    unsigned char header[ID3_HEADER_SIZE];
+    static const unsigned char padding[ID3_GROW_PADDING];
+    memcpy(header, id3tag -> header, ID3_HEADER_SIZE);
+    int_to_syncsafe(used + ID3_GROW_PADDING, header + 6);
+    fwrite(header, 1, ID3_HEADER_SIZE, mp3edit -> fptr_output_file);
+    fwrite(body, 1, used, mp3edit -> fptr_output_file);
+    fwrite(padding, 1, ID3_GROW_PADDING, mp3edit -> fptr_output_file);
+
+    // copy remaining data to output file;
+    status copied = E_FAILURE;
+    int flushed = fflush(mp3edit -> fptr_output_file);
+    STATS_COUNT(stat_syscalls, 3);      // open, fchmod and the write of the new tag
+    STATS_COUNT(stat_bytes_written, ID3_HEADER_SIZE + used + ID3_GROW_PADDING);
+    STATS_END(phase_write, start);
+    if(flushed == 0)
+    {
+        STATS_BEGIN(copy_start);
+        copied = copy_audio_data(fileno(mp3edit -> fptr_input_file), id3tag -> offset + ID3_HEADER_SIZE + (off_t)id3tag -> size, -1, fd);
+        STATS_END(phase_copy, copy_start);
+    }
+    fclose(mp3edit -> fptr_input_file);
+    mp3edit -> fptr_input_file = NULL;
+    if(copied != E_SUCCESS)
+    {
+        mp3edit -> error = "Error writing output file";
+        discard_output_file(mp3edit, output_file, linked, dir_fd);
+        return E_FAILURE;
+    }
+
+    // the data has to be on disk before the name points at it; a group syncs later
+    if(mp3edit -> commit == NULL)
+    {
+        STATS_BEGIN(sync_start);
+        int synced = fsync(fd);
+        STATS_COUNT(stat_syscalls, 1);
+        STATS_END(phase_sync, sync_start);
+        if(synced != 0)
+        {
+            mp3edit -> error = "Error writing output file";
+            discard_output_file(mp3edit, output_file, linked, dir_fd);
+            return E_FAILURE;
+        }
+    }
+    if(!linked)
+    {
+        if(link_temp_file(fd, mp3edit -> input_file, output_file, length) != E_SUCCESS)
+        {
+            mp3edit -> error = "Error replacing the original file";
+            discard_output_file(mp3edit, output_file, linked, dir_fd);
+            return E_FAILURE;
+        }
+        linked = 1;
+        STATS_COUNT(stat_syscalls, 1);
+    }
+    int closed = fclose(mp3edit -> fptr_output_file);
+    mp3edit -> fptr_output_file = NULL;
+    if(closed != 0)
+    {
+        mp3edit -> error = "Error writing output file";
+        discard_output_file(mp3edit, output_file, linked, dir_fd);
+        return E_FAILURE;
+    }
+
+    if(mp3edit -> commit != NULL)
+    {
+        // bulk run: synced and renamed together with the rest of its group
+        status queued = commit_group_add(mp3edit -> commit, output_file, mp3edit -> input_file, mp3edit -> commit_failed);
+        if(queued != E_SUCCESS)
+        {
+            mp3edit -> error = "Error replacing the original file";
+            unlink(output_file);
+        }
+        free(output_file);
+        close(dir_fd);
+        return queued;
+    }
+
+    // rename() replaces the original in one step, the directory sync makes it stick
+    STATS_BEGIN(rename_start);
+    int renamed = rename(output_file, mp3edit -> input_file);
+    STATS_COUNT(stat_syscalls, 1);
+    STATS_END(phase_rename, rename_start);
+    if(renamed != 0)
+    {
+        mp3edit -> error = "Error replacing the original file";
+        discard_output_file(mp3edit, output_file, linked, dir_fd);
+        return E_FAILURE;
+    }
+    STATS_BEGIN(sync_start);
+    fsync(dir_fd);
+    STATS_COUNT(stat_syscalls, 1);
+    STATS_END(phase_sync, sync_start);
+    free(output_file);
+    close(dir_fd);
+    return E_SUCCESS;
+}
+
+//Function to set up a group of files committed together;
+status commit_group_init(COMMITGROUP *group, size_t limit)
+{
+    group -> items = NULL;
+    group -> count = 0;
+    group -> capacity = 0;
+    group -> limit = limit ? limit : 1;
+    return pthread_mutex_init(&group -> lock, NULL) == 0 ? E_SUCCESS : E_FAILURE;
+}
+
+//Function to queue a written file; the group is committed once it is full;
+status commit_group_add(COMMITGROUP *group, const char *temp, const char *target, int *failed)
+{
+    PENDINGCOMMIT item;
+    item.temp = temp != NULL ? strdup(temp) : NULL;
+    item.target = strdup(target);
+    item.failed = failed;
+    STATS_COUNT(stat_mallocs, 2);
+    if(item.target == NULL || (temp != NULL && item.temp == NULL))
+    {
+        free(item.temp);
+        free(item.target);
+        return E_FAILURE;
+    }
+
+    pthread_mutex_lock(&group -> lock);
+    if(group -> count == group -> capacity)
+    {
+        size_t capacity = group -> capacity ? group -> capacity * 2 : group -> limit;
+        PENDINGCOMMIT *items = realloc(group -> items, capacity * sizeof(PENDINGCOMMIT));
+        if(items == NULL)
+        {
+            pthread_mutex_unlock(&group -> lock);
+            free(item.temp);
+            free(item.target);
+            return E_FAILURE;
+        }
+        group -> items = items;
+        group -> capacity = capacity;
+    }
+    group -> items[group -> count++] = item;
+    int full = group -> count >= group -> limit;
+    pthread_mutex_unlock(&group -> lock);
+
+    // the worker that fills the group commits it
+    return full ? commit_group_flush(group) : E_SUCCESS;
+}
+
+/* Function to run syncfs() once for every file system that holds one of
+   the files, before (temporary names) or after (final names) the renames;
+   a file that cannot be opened or a failed syncfs() fails the whole group */
+static status sync_file_systems(PENDINGCOMMIT *items, size_t count, int renamed)
+{
+    dev_t synced[16];
+    size_t nsynced = 0, i, j;
+
+    for(i = 0; i < count; i++)
+    {
+        const char *path = renamed || items[i].temp == NULL ? items[i].target : items[i].temp;
+        struct stat st;
+        if(stat(path, &st) != 0)
+        {
+            return E_FAILURE;
+        }
+        for(j = 0; j < nsynced && synced[j] != st.st_dev; j++)
+        {
+        }
+        if(j < nsynced)
+        {
+            continue;
+        }
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+        {
+            return E_FAILURE;
+        }
+        STATS_BEGIN(start);
+        int ret = syncfs(fd);
+        STATS_COUNT(stat_syscalls, 3);
+        STATS_END(phase_sync, start);
+        close(fd);
+        if(ret != 0)
+        {
+            return E_FAILURE;
+        }
+        if(nsynced < sizeof(synced) / sizeof(synced[0]))
+        {
+            synced[nsynced++] = st.st_dev;
+        }
+    }
+    return E_SUCCESS;
+}
+
+//Function to mark every file of a group as not committed;
+static void fail_commit_items(PENDINGCOMMIT *items, size_t count)
+{
+    size_t i;
+    for(i = 0; i < count; i++)
+    {
+        if(items[i].failed != NULL)
+        {
+            *items[i].failed = 1;
+        }
+    }
+}
+
+/* Function to sync and rename every queued file: one syncfs() puts the
+   data of the whole group on disk, then every file is renamed over its
+   original and a second syncfs() makes the new names durable */
+status commit_group_flush(COMMITGROUP *group)
+{
+    status ret = E_SUCCESS;
+    size_t i;
+
+    // take the queue, so other workers keep adding while this one syncs
+    pthread_mutex_lock(&group -> lock);
+    PENDINGCOMMIT *items = group -> items;
+    size_t count = group -> count;
+    group -> items = NULL;
+    group -> count = group -> capacity = 0;
+    pthread_mutex_unlock(&group -> lock);
+    if(count == 0)
+    {
+        free(items);
+        return E_SUCCESS;
+    }
+
+    // data that may not be on disk is never renamed over an original
+    if(sync_file_systems(items, count, 0) != E_SUCCESS)
+    {
+        for(i = 0; i < count; i++)
+        {
+            if(items[i].temp != NULL)
+            {
+                unlink(items[i].temp);
+            }
+        }
+        fail_commit_items(items, count);
+        ret = E_FAILURE;
+    }
+    else
+    {
+        for(i = 0; i < count; i++)
+        {
+            if(items[i].temp == NULL)
+            {
+                continue;       // edited in place, the sync above was all it needed
+            }
+            STATS_BEGIN(rename_start);
+            int renamed = rename(items[i].temp, items[i].target);
+            STATS_COUNT(stat_syscalls, 1);
+            STATS_END(phase_rename, rename_start);
+            if(renamed != 0)
+            {
+                unlink(items[i].temp);
+                if(items[i].failed != NULL)
+                {
+                    *items[i].failed = 1;
+                }
+                ret = E_FAILURE;
+            }
+        }
+        if(sync_file_systems(items, count, 1) != E_SUCCESS)
+        {
+            fail_commit_items(items, count);
+            ret = E_FAILURE;
+        }
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        free(items[i].temp);
+        free(items[i].target);
+    }
+    free(items);
+    return ret;
+}
+
+//Function to commit what is left and release the group;
+status commit_group_free(COMMITGROUP *group)
+{
+    status ret = commit_group_flush(group);
+    pthread_mutex_destroy(&group -> lock);
+    return ret;
+}
+
+/* Function to copy bytes [offset, end) of the input, end < 0 meaning up
+   to EOF (the audio data that follows the tag); copy_file_range()
+   keeps the data in the kernel (and lets file systems reflink or copy on
+   the server), sendfile() is the next best thing and a plain read/write
+   loop with a large buffer is the last resort */
+status copy_audio_data(int in_fd, off_t offset, off_t end, int out_fd)
+{
+    struct stat st;
+    if(fstat(in_fd, &st) != 0)
+    {
+        return E_FAILURE;
+    }
+    if(end < 0 || end > st.st_size)
+    {
+        end = st.st_size;
+    }
+    off_t in_offset = offset;
+    size_t remaining = end > offset ? end - offset : 0;
+    ssize_t bytes = 0;
+
+    while(remaining > 0 && (bytes = copy_file_range(in_fd, &in_offset, out_fd, NULL, remaining, 0)) > 0)
+    {
+        STATS_IO(stat_bytes_written, bytes);
+        remaining -= bytes;
+    }
+    if(remaining == 0 || bytes == 0)
+    {
+        return E_SUCCESS;     // done, or the file got shorter under us
+    }
+    if(errno != EXDEV && errno != EINVAL && errno != ENOSYS && errno != EOPNOTSUPP && errno != EBADF)
+    {
+        return E_FAILURE;
+    }
+
+    while(remaining > 0 && (bytes = sendfile(out_fd, in_fd, &in_offset, remaining)) > 0)
+    {
+        STATS_IO(stat_bytes_written, bytes);
+        remaining -= bytes;
+    }
+    if(remaining == 0 || bytes == 0)
+    {
+        return E_SUCCESS;
+    }
+    if(errno != EINVAL && errno != ENOSYS)
+    {
+        return E_FAILURE;
+    }
+
+    char *buffer = malloc(COPY_BUFFER_SIZE);
+    STATS_COUNT(stat_mallocs, 1);
+    if(buffer == NULL)
+    {
+        return E_FAILURE;
+    }
+    while(remaining > 0 &&
+          (bytes = pread(in_fd, buffer, remaining < COPY_BUFFER_SIZE ? remaining : COPY_BUFFER_SIZE, in_offset)) > 0)
+    {
+        ssize_t done = 0;
+        STATS_IO(stat_bytes_read, bytes);
+        while(done < bytes)
+        {
+            ssize_t written = write(out_fd, buffer + done, bytes - done);
+            STATS_IO(stat_bytes_written, written);
+            if(written < 0)
+            {
+                free(buffer);
+                return E_FAILURE;
+            }
+            done += written;
+        }
+        in_offset += bytes;
+        remaining -= bytes < (ssize_t)remaining ? (size_t)bytes : remaining;
+    }
+    free(buffer);
+    return bytes < 0 ? E_FAILURE : E_SUCCESS;
+}
+
+//Function to convert big endian to little endian;
+unsigned int convert_to_littleEndian(const char *buffer)
+{
+    return ((unsigned int)(unsigned char)buffer[0] << 24) |
+           ((unsigned char)buffer[1] << 16) |
+           ((unsigned char)buffer[2] << 8) |
+           (unsigned char)buffer[3];
+}
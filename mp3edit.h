@@ -1,74 +1,160 @@
-/*
-File        : mp3edit.h
-Author      : G C Phaneendra
-Roll No     : 25008_031
-Description : Header file for MP3 Tag Editing functionality.
-
-              This file contains the structure definition and function 
-              prototypes required to modify ID3v2 tag data in MP3 files.
-
-              Key Components:
-               - MP3EDIT : Holds file pointers, tag name, new data content, 
-                           and size information required for editing.
-               - data[]  : Stores the new text that will replace existing tag content.
-
-              Supported Editing Workflow:
-               1. Parse command-line arguments to determine the tag to edit and new content.
-               2. Validate the MP3 file extension.
-               3. Open the MP3 file and create a temporary output file.
-               4. Locate the specified ID3v2 frame (e.g., TIT2 for title).
-               5. Replace old tag data with the new provided content.
-               6. Save the modified MP3 file.
-
-              Supported Tag Options:
-               -t : Title
-               -a : Artist
-               -A : Album
-               -y : Year
-               -m : Genre
-               -c : Comment
-
-              Notes:
-               - Only ".mp3" files are supported for editing.
-               - Editing should preserve the rest of the MP3 file data unchanged.
-               - This header works in conjunction with mp3view.h and mp3view.c 
-                 to provide full tag viewing and editing capabilities.
-*/
-
-#ifndef mp3edit_h
-#define mp3edit_h
-#include "types.h"
-#include "mp3view.h"
-
-typedef struct mp3edit
-{
-    unsigned int size; // integer variable to store the new size of the content;
-    char tag[5];  // an array of character to store tag;
-
-    FILE *fptr_output_file;
-     /*This is a file pointer to open file and perform file operations */
-
-    char *input_file;
-    FILE *fptr_input_file;
-
-    char data[50]; // to store the new content;
-
-
-}MP3EDIT;
-
-//Function to edit content;
-status mp3_edit(MP3EDIT *mp3edit, char *argv[]);
-
-//Function to check the new file extension;
-status check_for_newfileextension(MP3EDIT *mp3edit, char *argv[]);
-
-//Function open the files to edit the data;
-status open_files(MP3EDIT *mp3edit);
-
-/* Function to edit tag data */
-status edit_tag_data(MP3EDIT *mp3edit);
-
-//Function to convert big endian to little endian;
-int convert_to_littleEndian(const char *buffer);
-#endif
-
+/*
+File        : mp3edit.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for MP3 Tag Editing functionality.
+
+              This file contains the structure definition and function 
+              prototypes required to modify ID3v2 tag data in MP3 files.
+
+              Key Components:
+               - FRAMEEDIT : One frame assignment (frame id, new text, size).
+               - MP3EDIT   : Holds file pointers and all frame assignments
+                             of one run; they are applied together in a
+                             single pass over the tag.
+
+              Supported Editing Workflow:
+               1. Parse command-line arguments to determine the tags to edit and new contents
+                  (any number of "<option> <new_text>" pairs before the file name).
+               2. Validate the MP3 file extension.
+               3. Open the MP3 file for reading and writing.
+               4. Locate the specified ID3v2 frames (e.g., TIT2 for title).
+               5. Replace old tag data with the new provided contents.
+               6. If the new frames fit into the tag and its padding, write
+                  only the tag region back in place; otherwise rewrite the
+                  file through a temporary output file with a larger tag.
+               7. Make the change durable: the new file is synced before it
+                  is renamed over the original and the directory after it.
+
+              Crash Safety:
+               - The new file is an unnamed O_TMPFILE in the directory of
+                 the original (a named mkstemp() file where O_TMPFILE is
+                 not supported); it only gets a name with linkat() once it
+                 is complete, so a crash while it is written leaves nothing
+                 behind, and rename() swaps it in atomically.
+               - COMMITGROUP : Bulk runs pass a group instead of syncing
+                 every file. Finished files are queued and every
+                 COMMIT_GROUP_SIZE files (and at the end) the group does
+                 one syncfs(), renames all of them and one more syncfs():
+                 two syncs per group instead of two per file.
+
+              Supported Tag Options:
+               -t : Title
+               -a : Artist
+               -A : Album
+               -y : Year
+               -m : Genre
+               -c : Comment
+
+              Notes:
+               - Only ".mp3" files are supported for editing.
+               - Editing should preserve the rest of the MP3 file data unchanged.
+               - This header works in conjunction with mp3view.h and mp3view.c 
+                 to provide full tag viewing and editing capabilities.
+*/
+
+#ifndef mp3edit_h
+#define mp3edit_h
+#include <sys/types.h>
+#include <pthread.h>
+#include "types.h"
+#include "mp3view.h"
+#include "id3tag.h"
+#include "arena.h"
+
+#define COPY_BUFFER_SIZE (1024 * 1024)   // last resort copy loop buffer
+#define COMMIT_GROUP_SIZE 256            // files a bulk run commits with one pair of syncs
+#define MAX_EDITS 16  // frame assignments applied to one file
+
+typedef struct frame_edit
+{
+    char tag[5];         // frame id to replace (e.g. TIT2);
+    unsigned int id;     // the same id as an integer (frame_id()), used for matching;
+    char *data;          // new content, not copied;
+    unsigned int size;   // length of the new content;
+    int found;           // set once the frame was replaced;
+}FRAMEEDIT;
+
+typedef struct pending_commit
+{
+    char *temp;          // finished temporary file, NULL for an edit made in place;
+    char *target;        // file it replaces;
+    int *failed;         // set when the file could not be committed, may be NULL;
+}PENDINGCOMMIT;
+
+typedef struct commit_group
+{
+    pthread_mutex_t lock;    // protects the queue, shared by all workers
+    PENDINGCOMMIT *items;    // files waiting for the next sync
+    size_t count;            // number of queued files
+    size_t capacity;         // allocated entries in items
+    size_t limit;            // queue length that triggers a commit
+}COMMITGROUP;
+
+typedef struct mp3edit
+{
+    FRAMEEDIT edits[MAX_EDITS]; // all frame assignments of this run;
+    unsigned int count;         // number of used entries in edits;
+
+    FILE *fptr_output_file;
+     /*This is a file pointer to open file and perform file operations */
+
+    char *input_file;
+    FILE *fptr_input_file;
+    const char *error;   // reason of the last failure, printed by the caller
+    ARENA *arena;        // per-file memory owned by the caller, NULL for a private one
+    COMMITGROUP *commit; // bulk runs: queue the file instead of syncing it, NULL to sync now
+    int *commit_failed;  // set by the group when the queued file could not be committed
+
+}MP3EDIT;
+
+//Function to edit content;
+status mp3_edit(MP3EDIT *mp3edit, char *argv[]);
+
+//Function to map an edit option to its frame id;
+const char *option_to_tag(const char *option);
+
+//Function to add one frame assignment, a later one for the same frame wins;
+status add_frame_edit(MP3EDIT *mp3edit, const char *tag, char *data);
+
+//Function to check the new file extension;
+status check_for_newfileextension(MP3EDIT *mp3edit, char *fname);
+
+//Function open the files to edit the data;
+status open_files(MP3EDIT *mp3edit);
+
+//Function to get the most the edits can add to a tag body;
+size_t edit_growth(MP3EDIT *mp3edit);
+
+//Function to rebuild the frames of a loaded tag with the edits applied (returns the end of the frames);
+unsigned int rebuild_tag_frames(MP3EDIT *mp3edit, const ID3TAG *id3tag, unsigned char *body,
+                                unsigned int *edit_offset, int *edited);
+
+/* Function to edit tag data */
+status edit_tag_data(MP3EDIT *mp3edit);
+
+//Function to report which frames were updated;
+void display_edit_result(MP3EDIT *mp3edit);
+
+//Function to rewrite the whole file when the tag has to grow;
+status copy_to_output_file(MP3EDIT *mp3edit, ID3TAG *id3tag, const unsigned char *body, unsigned int used);
+
+//Function to copy bytes [offset, end) (end < 0: up to EOF) without passing them through user memory;
+status copy_audio_data(int in_fd, off_t offset, off_t end, int out_fd);
+
+//Function to set up a group of files committed together;
+status commit_group_init(COMMITGROUP *group, size_t limit);
+
+//Function to queue a written file; the group is committed once it is full;
+status commit_group_add(COMMITGROUP *group, const char *temp, const char *target, int *failed);
+
+//Function to sync and rename every queued file;
+status commit_group_flush(COMMITGROUP *group);
+
+//Function to commit what is left and release the group;
+status commit_group_free(COMMITGROUP *group);
+
+//Function to convert big endian to little endian;
+unsigned int convert_to_littleEndian(const char *buffer);
+#endif
+
@@ -0,0 +1,227 @@
+/*
+File        : mp3format.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the output formats of the view and scan modes.
+
+              This file contains the function definitions required to:
+               - Read the --format option from the command line
+               - Format the tags of one file as labelled text, a JSON
+                 Lines object or a TSV row
+               - Format a file that could not be read in the same layout
+
+              Notes:
+               - Records are appended to the caller's OUTBUF; the scan
+                 workers each own one, so no lock is taken here.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3format.h"
+#include "mp3catalog.h"
+#include "outbuf.h"
+
+static const char *labels[MAX_TAGS] = {"TITLE", "ARTIST", "ALBUM", "YEAR", "MUSIC", "COMMENT"};
+static const char *ids[MAX_TAGS] = {"TIT2", "TPE1", "TALB", "TYER", "TCON", "COMM"};
+
+//Function to read --format=<text|jsonl|tsv> from the arguments and remove it;
+int parse_format_arg(int argc, char *argv[], OutputFormat *format)
+{
+    int i, j = 1;
+    *format = format_text;
+    for(i = 1; i < argc; i++)
+    {
+        if(strncmp(argv[i], "--format=", 9) != 0)
+        {
+            argv[j++] = argv[i];
+            continue;
+        }
+        const char *name = argv[i] + 9;
+        if(strcmp(name, "text") == 0)
+        {
+            *format = format_text;
+        }
+        else if(strcmp(name, "jsonl") == 0)
+        {
+            *format = format_jsonl;
+        }
+        else if(strcmp(name, "tsv") == 0)
+        {
+            *format = format_tsv;
+        }
+        else
+        {
+            printf("Error: --format should be text, jsonl or tsv\n");
+            return -1;
+        }
+    }
+    argv[j] = NULL;
+    return j;
+}
+
+//Function to get the number of value columns of a record;
+static unsigned int column_count(const FIELDSET *fields)
+{
+    return fields != NULL ? fields -> count : MAX_TAGS;
+}
+
+//Function to get the frame id of a value column;
+static const char *column_id(const FIELDSET *fields, unsigned int i)
+{
+    return fields != NULL ? fields -> names[i] : ids[i];
+}
+
+//Function to write the TSV header row (nothing for the other formats);
+void format_header(const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format)
+{
+    unsigned int i;
+    if(format != format_tsv)
+    {
+        return;
+    }
+    outbuf_append(outbuf, "file", 4);
+    for(i = 0; i < column_count(fields); i++)
+    {
+        outbuf_append(outbuf, "\t", 1);
+        outbuf_append(outbuf, column_id(fields, i), 4);
+    }
+    outbuf_append(outbuf, "\terror\n", 7);
+}
+
+//Function to format one record from its file name and column values;
+static void format_values(const char *fname, const FIELDSET *fields, const char **values,
+                          const unsigned int *lengths, OUTBUF *outbuf, OutputFormat format)
+{
+    unsigned int i;
+
+    if(format == format_jsonl)
+    {
+        outbuf_append(outbuf, "{\"file\":\"", 9);
+        outbuf_append_json(outbuf, fname, strlen(fname));
+        for(i = 0; i < column_count(fields); i++)
+        {
+            outbuf_append(outbuf, "\",\"", 3);
+            outbuf_append(outbuf, column_id(fields, i), 4);
+            outbuf_append(outbuf, "\":\"", 3);
+            outbuf_append_json(outbuf, values[i], lengths[i]);
+        }
+        outbuf_append(outbuf, "\"}\n", 3);
+        return;
+    }
+    if(format == format_tsv)
+    {
+        outbuf_append_tsv(outbuf, fname, strlen(fname));
+        for(i = 0; i < column_count(fields); i++)
+        {
+            outbuf_append(outbuf, "\t", 1);
+            outbuf_append_tsv(outbuf, values[i], lengths[i]);
+        }
+        outbuf_append(outbuf, "\t\n", 2);
+        return;
+    }
+
+    outbuf_printf(outbuf, "%s\n", fname);
+    for(i = 0; i < column_count(fields); i++)
+    {
+        outbuf_printf(outbuf, "%-15s:            %.*s\n", fields != NULL ? field_label(fields -> names[i]) : labels[i],
+                      (int)lengths[i], values[i]);
+    }
+    outbuf_append(outbuf, "\n", 1);
+}
+
+//Function to format the tags of one file into a worker buffer;
+void format_mp3tags(const MP3VIEW *mp3view, OUTBUF *outbuf, OutputFormat format)
+{
+    const FIELDSET *fields = mp3view -> fields;
+    const char *values[MAX_FIELDS];
+    unsigned int lengths[MAX_FIELDS];
+    unsigned int i;
+
+    for(i = 0; i < column_count(fields); i++)
+    {
+        values[i] = fields != NULL ? field_value(mp3view, i) : tag_value(mp3view, i);
+        lengths[i] = fields != NULL ? mp3view -> fieldinfo[i].length : mp3view -> mp3viewinfo[i].length;
+    }
+    format_values(mp3view -> sample_mp3_fname, fields, values, lengths, outbuf, format);
+}
+
+//Function to format one row of the catalogue like the file it came from;
+void format_catalog_row(const MP3CATALOG *catalog, size_t row, const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format)
+{
+    const char *values[MAX_FIELDS];
+    unsigned int lengths[MAX_FIELDS];
+    char fname[PATH_MAX];
+    unsigned int i;
+
+    catalog_path(catalog, row, fname, sizeof(fname));
+    for(i = 0; i < catalog -> ncolumns; i++)
+    {
+        values[i] = catalog_value(catalog, row, i, &lengths[i]);
+    }
+    format_values(fname, fields, values, lengths, outbuf, format);
+}
+
+//Function to format a file that could not be read;
+void format_error(const char *fname, const char *error, const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format)
+{
+    unsigned int i;
+    if(error == NULL)
+    {
+        error = "Invalid tag";
+    }
+    if(format == format_jsonl)
+    {
+        outbuf_append(outbuf, "{\"file\":\"", 9);
+        outbuf_append_json(outbuf, fname, strlen(fname));
+        outbuf_append(outbuf, "\",\"error\":\"", 11);
+        outbuf_append_json(outbuf, error, strlen(error));
+        outbuf_append(outbuf, "\"}\n", 3);
+    }
+    else if(format == format_tsv)
+    {
+        outbuf_append_tsv(outbuf, fname, strlen(fname));
+        for(i = 0; i < column_count(fields); i++)
+        {
+            outbuf_append(outbuf, "\t", 1);
+        }
+        outbuf_append(outbuf, "\t", 1);
+        outbuf_append_tsv(outbuf, error, strlen(error));
+        outbuf_append(outbuf, "\n", 1);
+    }
+    else
+    {
+        outbuf_printf(outbuf, "%s: %s\n\n", fname, error);
+    }
+}
+
+/* Function to view one file as a single record on stdout; unlike Mp3View()
+   nothing else is printed, so the output can be fed to another program */
+status Mp3ViewRecord(MP3VIEW *mp3view, OutputFormat format)
+{
+    OUTBUF outbuf;
+
+    if(outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    fflush(stdout);
+    format_header(mp3view -> fields, &outbuf, format);
+    status ret = parse_mp3file(mp3view);
+    if(ret == E_SUCCESS)
+    {
+        format_mp3tags(mp3view, &outbuf, format);
+    }
+    else
+    {
+        format_error(mp3view -> sample_mp3_fname, mp3view -> error, mp3view -> fields, &outbuf, format);
+    }
+    close_mp3file(mp3view);
+    if(outbuf_free(&outbuf) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    return ret;
+}
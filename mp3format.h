@@ -0,0 +1,65 @@
+/*
+File        : mp3format.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the output formats of the view and scan modes.
+
+              This file contains the format selection and the function
+              prototypes that turn the tags of one file into one record
+              in a worker's OUTBUF.
+
+              Key Components:
+               - OutputFormat : text  - the labelled lines shown so far
+                                jsonl - one JSON object per line (JSON Lines)
+                                tsv   - a header row, then one tab separated
+                                        row per file
+
+              Record Layout:
+               jsonl : {"file":"a.mp3","TIT2":"...","TPE1":"...",...}
+                       {"file":"b.mp3","error":"..."}
+               tsv   : file  TIT2  TPE1  ...  error
+                       the error column is empty for files that were read
+               Keys and columns are the frame ids: the six default tags
+               or the --fields list. Values are UTF-8 (see mp3text.h).
+
+              Notes:
+               - Selected with --format=text|jsonl|tsv anywhere on the
+                 command line.
+               - In the machine formats the scan summary goes to stderr,
+                 so stdout holds nothing but records.
+               - Records are built without printf: values are escaped in
+                 bulk by outbuf_append_json() / outbuf_append_tsv().
+*/
+#ifndef mp3format_h
+#define mp3format_h
+#include "types.h"
+#include "mp3view.h"
+#include "outbuf.h"
+#include "mp3catalog.h"
+
+typedef enum
+{
+	format_text,
+	format_jsonl,
+	format_tsv
+}OutputFormat;
+
+//Function to read --format=<text|jsonl|tsv> from the arguments and remove it;
+int parse_format_arg(int argc, char *argv[], OutputFormat *format);
+
+//Function to write the TSV header row (nothing for the other formats);
+void format_header(const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format);
+
+//Function to format the tags of one file into a worker buffer;
+void format_mp3tags(const MP3VIEW *mp3view, OUTBUF *outbuf, OutputFormat format);
+
+//Function to format one row of the catalogue like the file it came from;
+void format_catalog_row(const MP3CATALOG *catalog, size_t row, const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format);
+
+//Function to format a file that could not be read;
+void format_error(const char *fname, const char *error, const FIELDSET *fields, OUTBUF *outbuf, OutputFormat format);
+
+//Function to view one file as a single record on stdout;
+status Mp3ViewRecord(MP3VIEW *mp3view, OutputFormat format);
+
+#endif
@@ -0,0 +1,529 @@
+/*
+File        : mp3index.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the persistent on-disk tag index.
+
+              This file contains the function definitions required to:
+               - Load all records of an index file into a hash table
+               - Decide from stat() data whether a file has to be parsed
+               - Serialise parsed tags into records for appending
+               - Compact the file once it holds mostly stale records
+
+              Notes:
+               - Workers serialise records into their own OUTBUF bound to
+                 the index file descriptor, so appends go out in large
+                 batches under one lock, like the scan output.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3index.h"
+#include "outbuf.h"
+#include "stats.h"
+
+//Function to hash a path (FNV-1a);
+static unsigned long long hash_path(const char *path)
+{
+    unsigned long long hash = 1469598103934665603ULL;
+    while(*path)
+    {
+        hash = (hash ^ (unsigned char)*path++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+//Function to double the hash table once it is full;
+static status index_grow(MP3INDEX *mp3index)
+{
+    size_t nbuckets = mp3index -> nbuckets ? mp3index -> nbuckets * 2 : 1024;
+    INDEXENTRY **buckets = calloc(nbuckets, sizeof(INDEXENTRY *));
+    size_t i;
+
+    if(buckets == NULL)
+    {
+        return E_FAILURE;
+    }
+    for(i = 0; i < mp3index -> nbuckets; i++)
+    {
+        INDEXENTRY *entry = mp3index -> buckets[i];
+        while(entry != NULL)
+        {
+            INDEXENTRY *next = entry -> next;
+            size_t slot = hash_path(entry -> path) & (nbuckets - 1);
+            entry -> next = buckets[slot];
+            buckets[slot] = entry;
+            entry = next;
+        }
+    }
+    free(mp3index -> buckets);
+    mp3index -> buckets = buckets;
+    mp3index -> nbuckets = nbuckets;
+    return E_SUCCESS;
+}
+
+//Function to add one record to the table, replacing an older one of the same path;
+static status index_insert(MP3INDEX *mp3index, const INDEXRECORD *record, const char *path, const char *values)
+{
+    size_t values_length = 0;
+    int i;
+
+    for(i = 0; i < MAX_TAGS; i++)
+    {
+        values_length += record -> value_length[i];
+    }
+    INDEXENTRY *entry = malloc(sizeof(INDEXENTRY) + record -> path_length + 1 + values_length);
+    if(entry == NULL)
+    {
+        return E_FAILURE;
+    }
+    entry -> record = *record;
+    entry -> path = entry -> data;
+    memcpy(entry -> path, path, record -> path_length);
+    entry -> path[record -> path_length] = '\0';
+    entry -> values = entry -> data + record -> path_length + 1;
+    memcpy(entry -> values, values, values_length);
+    entry -> seen = 0;
+
+    if(mp3index -> count >= mp3index -> nbuckets && index_grow(mp3index) != E_SUCCESS)
+    {
+        free(entry);
+        return E_FAILURE;
+    }
+    INDEXENTRY **link = &mp3index -> buckets[hash_path(entry -> path) & (mp3index -> nbuckets - 1)];
+    while(*link != NULL && strcmp((*link) -> path, entry -> path) != 0)
+    {
+        link = &(*link) -> next;
+    }
+    if(*link != NULL)
+    {
+        // newer record of the same file
+        entry -> next = (*link) -> next;
+        free(*link);
+    }
+    else
+    {
+        entry -> next = NULL;
+        mp3index -> count++;
+    }
+    *link = entry;
+    return E_SUCCESS;
+}
+
+//Function to read all records of the index file into the table;
+static status index_load(MP3INDEX *mp3index)
+{
+    struct stat st;
+    if(fstat(mp3index -> fd, &st) != 0)
+    {
+        return E_FAILURE;
+    }
+    char magic[INDEX_MAGIC_SIZE];
+    if(st.st_size >= INDEX_MAGIC_SIZE && pread(mp3index -> fd, magic, INDEX_MAGIC_SIZE, 0) == INDEX_MAGIC_SIZE &&
+       memcmp(magic, INDEX_MAGIC, INDEX_MAGIC_PREFIX_SIZE) == 0 && memcmp(magic, INDEX_MAGIC, INDEX_MAGIC_SIZE) != 0)
+    {
+        // written by an older version: its values may differ, start over
+        if(ftruncate(mp3index -> fd, 0) != 0)
+        {
+            return E_FAILURE;
+        }
+        st.st_size = 0;
+    }
+    if(st.st_size == 0)
+    {
+        // new index: write the magic
+        if(write(mp3index -> fd, INDEX_MAGIC, INDEX_MAGIC_SIZE) != INDEX_MAGIC_SIZE)
+        {
+            return E_FAILURE;
+        }
+        return E_SUCCESS;
+    }
+
+    char *data = malloc(st.st_size);
+    STATS_COUNT(stat_mallocs, 1);
+    STATS_IO(stat_bytes_read, st.st_size);
+    if(data == NULL || pread(mp3index -> fd, data, st.st_size, 0) != st.st_size ||
+       memcmp(data, INDEX_MAGIC, INDEX_MAGIC_SIZE) != 0)
+    {
+        printf("Error: %s is not a tag index\n", mp3index -> fname);
+        free(data);
+        return E_FAILURE;
+    }
+
+    size_t pos = INDEX_MAGIC_SIZE;
+    while(pos + sizeof(INDEXRECORD) <= (size_t)st.st_size)
+    {
+        INDEXRECORD record;
+        size_t values_length = 0;
+        int i;
+
+        memcpy(&record, data + pos, sizeof(record));
+        for(i = 0; i < MAX_TAGS; i++)
+        {
+            values_length += record.value_length[i];
+        }
+        if(record.length != sizeof(record) - sizeof(record.length) + record.path_length + values_length ||
+           pos + sizeof(record.length) + record.length > (size_t)st.st_size)
+        {
+            break;
+        }
+        const char *path = data + pos + sizeof(record);
+        if(index_insert(mp3index, &record, path, path + record.path_length) != E_SUCCESS)
+        {
+            free(data);
+            return E_FAILURE;
+        }
+        mp3index -> records++;
+        pos += sizeof(record.length) + record.length;
+    }
+    free(data);
+
+    // anything after the last complete record is a torn append
+    if(pos != (size_t)st.st_size && ftruncate(mp3index -> fd, pos) != 0)
+    {
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to open (or create) the index file and load its records;
+status index_open(MP3INDEX *mp3index, char *fname)
+{
+    memset(mp3index, 0, sizeof(*mp3index));
+    mp3index -> fname = fname;
+    pthread_mutex_init(&mp3index -> lock, NULL);
+    mp3index -> fd = open(fname, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(mp3index -> fd < 0)
+    {
+        perror("Error: Unable to open the index file");
+        return E_FAILURE;
+    }
+    if(index_grow(mp3index) != E_SUCCESS || index_load(mp3index) != E_SUCCESS)
+    {
+        index_close(mp3index);
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to set up an index that only lives in memory (no file);
+status index_init(MP3INDEX *mp3index)
+{
+    memset(mp3index, 0, sizeof(*mp3index));
+    mp3index -> fd = -1;
+    pthread_mutex_init(&mp3index -> lock, NULL);
+    return index_grow(mp3index);
+}
+
+/* Function to add or replace the entry of a parsed (or failed) file; the
+   record is also appended to the index file when there is one */
+status index_put(MP3INDEX *mp3index, const MP3VIEW *mp3view, status parsed, const struct stat *st)
+{
+    OUTBUF record;
+    INDEXRECORD fixed;
+
+    if(outbuf_init(&record, mp3index -> fd, 0, NULL) != E_SUCCESS ||
+       index_add_record(&record, mp3view, parsed, st) != E_SUCCESS)
+    {
+        free(record.data);
+        return E_FAILURE;
+    }
+    memcpy(&fixed, record.data, sizeof(fixed));
+    const char *path = record.data + sizeof(fixed);
+    status ret = index_insert(mp3index, &fixed, path, path + fixed.path_length);
+    if(ret != E_SUCCESS || mp3index -> fd < 0)
+    {
+        record.length = 0;      // nothing to append
+    }
+    else
+    {
+        mp3index -> records++;
+    }
+    if(outbuf_free(&record) != E_SUCCESS)
+    {
+        ret = E_FAILURE;
+    }
+    return ret;
+}
+
+//Function to drop the entry of a path (a file that was deleted or moved away);
+void index_remove(MP3INDEX *mp3index, const char *path)
+{
+    INDEXENTRY **link = &mp3index -> buckets[hash_path(path) & (mp3index -> nbuckets - 1)];
+    while(*link != NULL && strcmp((*link) -> path, path) != 0)
+    {
+        link = &(*link) -> next;
+    }
+    if(*link != NULL)
+    {
+        INDEXENTRY *gone = *link;
+        *link = gone -> next;
+        free(gone);
+        mp3index -> count--;
+    }
+}
+
+/* Function to drop every entry below a directory, or with unseen_only
+   set only those the last walk of it did not see (deleted files) */
+void index_remove_tree(MP3INDEX *mp3index, const char *dir, int unseen_only)
+{
+    size_t length = strlen(dir);
+    size_t i;
+
+    for(i = 0; i < mp3index -> nbuckets; i++)
+    {
+        INDEXENTRY **link = &mp3index -> buckets[i];
+        while(*link != NULL)
+        {
+            INDEXENTRY *entry = *link;
+            if(strncmp(entry -> path, dir, length) == 0 && entry -> path[length] == '/' &&
+               !(unseen_only && entry -> seen))
+            {
+                *link = entry -> next;
+                free(entry);
+                mp3index -> count--;
+                continue;
+            }
+            link = &entry -> next;
+        }
+    }
+}
+
+//Function to clear the seen flag of every entry before a new walk;
+void index_clear_seen(MP3INDEX *mp3index)
+{
+    size_t i;
+    INDEXENTRY *entry;
+
+    for(i = 0; i < mp3index -> nbuckets; i++)
+    {
+        for(entry = mp3index -> buckets[i]; entry != NULL; entry = entry -> next)
+        {
+            entry -> seen = 0;
+        }
+    }
+}
+
+//Function to find the entry of a path;
+INDEXENTRY *index_lookup(MP3INDEX *mp3index, const char *path)
+{
+    INDEXENTRY *entry = mp3index -> buckets[hash_path(path) & (mp3index -> nbuckets - 1)];
+    while(entry != NULL && strcmp(entry -> path, path) != 0)
+    {
+        entry = entry -> next;
+    }
+    return entry;
+}
+
+//Function to check whether an entry still describes the file;
+int index_entry_matches(const INDEXENTRY *entry, const struct stat *st)
+{
+    return entry -> record.dev == (unsigned long long)st -> st_dev &&
+           entry -> record.ino == (unsigned long long)st -> st_ino &&
+           entry -> record.size == (unsigned long long)st -> st_size &&
+           entry -> record.mtime_sec == (long long)st -> st_mtim.tv_sec &&
+           entry -> record.mtime_nsec == (unsigned int)st -> st_mtim.tv_nsec;
+}
+
+//Function to present an entry as a parsed MP3VIEW (values are views into the entry);
+void index_entry_to_view(INDEXENTRY *entry, MP3VIEW *mp3view)
+{
+    unsigned int offset = 0;
+    int i;
+
+    mp3view -> sample_mp3_fname = entry -> path;
+    mp3view -> id3tag.buffer = (unsigned char *)entry -> values;
+    mp3view -> id3tag.map = NULL;
+    for(i = 0; i < MAX_TAGS; i++)
+    {
+        mp3view -> mp3viewinfo[i].offset = offset;
+        mp3view -> mp3viewinfo[i].length = entry -> record.value_length[i];
+        offset += entry -> record.value_length[i];
+    }
+}
+
+//Function to serialise a parsed (or failed) file into a record buffer;
+status index_add_record(OUTBUF *records, const MP3VIEW *mp3view, status parsed, const struct stat *st)
+{
+    INDEXRECORD record;
+    size_t values_length = 0;
+    int i;
+
+    memset(&record, 0, sizeof(record));
+    record.path_length = strlen(mp3view -> sample_mp3_fname);
+    record.dev = st -> st_dev;
+    record.ino = st -> st_ino;
+    record.size = st -> st_size;
+    record.mtime_sec = st -> st_mtim.tv_sec;
+    record.mtime_nsec = st -> st_mtim.tv_nsec;
+    record.failed = parsed != E_SUCCESS;
+    if(record.failed)
+    {
+        record.value_length[0] = strlen(mp3view -> error);
+    }
+    else
+    {
+        for(i = 0; i < MAX_TAGS; i++)
+        {
+            record.value_length[i] = mp3view -> mp3viewinfo[i].length;
+        }
+    }
+    for(i = 0; i < MAX_TAGS; i++)
+    {
+        values_length += record.value_length[i];
+    }
+    record.length = sizeof(record) - sizeof(record.length) + record.path_length + values_length;
+
+    if(outbuf_append(records, (const char *)&record, sizeof(record)) != E_SUCCESS ||
+       outbuf_append(records, mp3view -> sample_mp3_fname, record.path_length) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    if(record.failed)
+    {
+        return outbuf_append(records, mp3view -> error, record.value_length[0]);
+    }
+    for(i = 0; i < MAX_TAGS; i++)
+    {
+        if(outbuf_append(records, tag_value(mp3view, i), record.value_length[i]) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+    }
+    return E_SUCCESS;
+}
+
+//Function to write one entry back as a record;
+static status index_write_entry(OUTBUF *outbuf, const INDEXENTRY *entry)
+{
+    size_t values_length = entry -> record.length - (sizeof(INDEXRECORD) - sizeof(entry -> record.length)) -
+                           entry -> record.path_length;
+    if(outbuf_append(outbuf, (const char *)&entry -> record, sizeof(INDEXRECORD)) != E_SUCCESS ||
+       outbuf_append(outbuf, entry -> path, entry -> record.path_length) != E_SUCCESS ||
+       outbuf_append(outbuf, entry -> values, values_length) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    return outbuf_maybe_flush(outbuf);
+}
+
+/* Function to rewrite the index without stale records when it is worth it;
+   entries below root that the scan did not see belong to deleted files */
+status index_compact(MP3INDEX *mp3index, const char *root)
+{
+    MP3INDEX current;
+    size_t root_length = strlen(root);
+    size_t i, dropped = 0;
+
+    // "/music/" is "/music", and "/" leaves nothing, every path starts with "/"
+    while(root_length > 0 && root[root_length - 1] == '/')
+    {
+        root_length--;
+    }
+
+    // reload so the records appended by this scan are included
+    if(index_open(&current, mp3index -> fname) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    for(i = 0; i < current.nbuckets; i++)
+    {
+        INDEXENTRY **link = &current.buckets[i];
+        while(*link != NULL)
+        {
+            INDEXENTRY *old = index_lookup(mp3index, (*link) -> path);
+            if(old != NULL && !old -> seen && strncmp(old -> path, root, root_length) == 0 &&
+               old -> path[root_length] == '/')
+            {
+                INDEXENTRY *gone = *link;
+                *link = gone -> next;
+                free(gone);
+                current.count--;
+                dropped++;
+                continue;
+            }
+            link = &(*link) -> next;
+        }
+    }
+    if(dropped == 0 && current.records <= 2 * current.count)
+    {
+        index_close(&current);
+        return E_SUCCESS;
+    }
+
+    size_t length = strlen(mp3index -> fname) + 5;
+    char *tmp_name = malloc(length);
+    if(tmp_name == NULL)
+    {
+        index_close(&current);
+        return E_FAILURE;
+    }
+    snprintf(tmp_name, length, "%s.tmp", mp3index -> fname);
+
+    status ret = E_FAILURE;
+    OUTBUF outbuf;
+    int fd = open(tmp_name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd >= 0 && outbuf_init(&outbuf, fd, OUTBUF_SIZE, NULL) == E_SUCCESS)
+    {
+        ret = outbuf_append(&outbuf, INDEX_MAGIC, INDEX_MAGIC_SIZE);
+        for(i = 0; i < current.nbuckets && ret == E_SUCCESS; i++)
+        {
+            const INDEXENTRY *entry;
+            for(entry = current.buckets[i]; entry != NULL && ret == E_SUCCESS; entry = entry -> next)
+            {
+                ret = index_write_entry(&outbuf, entry);
+            }
+        }
+        if(outbuf_free(&outbuf) != E_SUCCESS || fsync(fd) != 0)
+        {
+            ret = E_FAILURE;
+        }
+    }
+    if(fd >= 0)
+    {
+        close(fd);
+    }
+    if(ret == E_SUCCESS && rename(tmp_name, mp3index -> fname) != 0)
+    {
+        ret = E_FAILURE;
+    }
+    if(ret != E_SUCCESS)
+    {
+        unlink(tmp_name);
+    }
+    free(tmp_name);
+    index_close(&current);
+    return ret;
+}
+
+//Function to close the index and release all entries;
+void index_close(MP3INDEX *mp3index)
+{
+    size_t i;
+    for(i = 0; i < mp3index -> nbuckets; i++)
+    {
+        INDEXENTRY *entry = mp3index -> buckets[i];
+        while(entry != NULL)
+        {
+            INDEXENTRY *next = entry -> next;
+            free(entry);
+            entry = next;
+        }
+    }
+    free(mp3index -> buckets);
+    mp3index -> buckets = NULL;
+    mp3index -> nbuckets = 0;
+    mp3index -> count = 0;
+    if(mp3index -> fd >= 0)
+    {
+        close(mp3index -> fd);
+        mp3index -> fd = -1;
+    }
+    pthread_mutex_destroy(&mp3index -> lock);
+}
@@ -0,0 +1,120 @@
+/*
+File        : mp3index.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the persistent on-disk tag index.
+
+              This file contains the structure definitions and function
+              prototypes required to remember the parsed tags of every
+              scanned file, so that a rescan only has to stat a file and
+              re-parse it when it actually changed.
+
+              Key Components:
+               - INDEXRECORD : Fixed part of one record as stored on disk.
+               - INDEXENTRY  : One file in memory (latest record wins).
+               - MP3INDEX    : The open index file and a hash table of
+                               entries keyed by path. Without a file
+                               (index_init()) it is a plain in-memory
+                               table, as used by the watch daemon.
+
+              File Layout:
+               | "MP3IDX1\n" | record | record | ... |
+               record = INDEXRECORD, path bytes, the six tag values
+               A file is unchanged when (device, inode, size, mtime) of
+               its record still match stat().
+
+              Notes:
+               - New records are only ever appended (O_APPEND), a changed
+                 file simply gets a newer record. When more than half of
+                 the records are stale the file is compacted.
+               - A torn record at the end (crash during a write) is cut
+                 off when the index is loaded.
+               - Records use the native byte order; the index is a cache
+                 for the machine that wrote it.
+*/
+#ifndef mp3index_h
+#define mp3index_h
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "mp3view.h"
+#include "outbuf.h"
+
+#define INDEX_MAGIC "MP3IDX2\n"      // 2: values are UTF-8, comments without language/description
+#define INDEX_MAGIC_PREFIX_SIZE 6     // "MP3IDX": an index of another version is rebuilt
+#define INDEX_MAGIC_SIZE 8
+
+typedef struct index_record
+{
+	unsigned int length;          // bytes of the record after this field
+	unsigned int path_length;     // bytes of the path (no terminator)
+	unsigned long long dev;       // st_dev
+	unsigned long long ino;       // st_ino
+	unsigned long long size;      // st_size
+	long long mtime_sec;          // st_mtim.tv_sec
+	unsigned int mtime_nsec;      // st_mtim.tv_nsec
+	unsigned int failed;          // 1: value 0 holds the error message
+	unsigned int value_length[MAX_TAGS];
+}INDEXRECORD;
+
+typedef struct index_entry
+{
+	INDEXRECORD record;
+	char *path;                   // points into data
+	char *values;                 // the six values back to back, points into data
+	int seen;                     // file was found by the current scan
+	struct index_entry *next;     // hash chain
+	char data[];                  // path, '\0', values
+}INDEXENTRY;
+
+typedef struct mp3index
+{
+	char *fname;                  // index file name
+	int fd;                       // index file opened for appending
+	INDEXENTRY **buckets;         // hash table of entries by path
+	size_t nbuckets;
+	size_t count;                 // live entries
+	size_t records;               // records in the file (live and stale)
+	pthread_mutex_t lock;         // serialises appends of the worker buffers
+	unsigned long hits;           // files answered from the index (atomic)
+	unsigned long parsed;         // files that had to be parsed (atomic)
+}MP3INDEX;
+
+//Function to open (or create) the index file and load its records;
+status index_open(MP3INDEX *mp3index, char *fname);
+
+//Function to set up an index that only lives in memory (no file);
+status index_init(MP3INDEX *mp3index);
+
+//Function to add or replace the entry of a parsed (or failed) file;
+status index_put(MP3INDEX *mp3index, const MP3VIEW *mp3view, status parsed, const struct stat *st);
+
+//Function to drop the entry of a path (a file that was deleted or moved away);
+void index_remove(MP3INDEX *mp3index, const char *path);
+
+//Function to drop every entry below a directory (only the unseen ones with unseen_only);
+void index_remove_tree(MP3INDEX *mp3index, const char *dir, int unseen_only);
+
+//Function to clear the seen flag of every entry before a new walk;
+void index_clear_seen(MP3INDEX *mp3index);
+
+//Function to find the entry of a path;
+INDEXENTRY *index_lookup(MP3INDEX *mp3index, const char *path);
+
+//Function to check whether an entry still describes the file;
+int index_entry_matches(const INDEXENTRY *entry, const struct stat *st);
+
+//Function to present an entry as a parsed MP3VIEW (values are views into the entry);
+void index_entry_to_view(INDEXENTRY *entry, MP3VIEW *mp3view);
+
+//Function to serialise a parsed (or failed) file into a record buffer;
+status index_add_record(OUTBUF *records, const MP3VIEW *mp3view, status parsed, const struct stat *st);
+
+//Function to rewrite the index without stale records when it is worth it;
+status index_compact(MP3INDEX *mp3index, const char *root);
+
+//Function to close the index and release all entries;
+void index_close(MP3INDEX *mp3index);
+
+#endif
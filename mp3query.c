@@ -0,0 +1,677 @@
+/*
+File        : mp3query.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the tag query mode.
+
+              This file contains the function definitions required to:
+               - Read the query options from the command line
+               - Build sorted, varint encoded posting lists for TPE1,
+                 TALB, TCON and TYER
+               - Parse exact, prefix and conjunctive queries
+               - Intersect the posting lists and print the matches
+
+              Notes:
+               - A file number is the position of the file in path order,
+                 so matches come out sorted by path without a sort.
+               - The lists are built once after the scan; queries only
+                 read them.
+*/
+#define _GNU_SOURCE          // qsort_r()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include "types.h"
+#include "mp3scan.h"
+#include "mp3catalog.h"
+#include "mp3format.h"
+#include "mp3query.h"
+#include "outbuf.h"
+#include "stats.h"
+
+static const char *indexed[4] = {"TPE1", "TALB", "TCON", "TYER"};
+
+//Function to read the query options (-f <dir> [-j <threads>] [-i <index>] [query ...]);
+status check_query_args(int argc, char *argv[], MP3QUERY *mp3query)
+{
+    int i;
+
+    mp3query -> scan.root = NULL;
+    mp3query -> scan.threads = default_threads();
+    mp3query -> queries = NULL;
+    mp3query -> nqueries = 0;
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-f") == 0 && mp3query -> scan.root == NULL)
+        {
+            mp3query -> scan.root = i + 1 < argc ? argv[++i] : NULL;
+            if(mp3query -> scan.root == NULL)
+            {
+                break;
+            }
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            int threads = atoi(argv[++i]);
+            if(threads < 1 || threads > MAX_SCAN_THREADS)
+            {
+                printf("Error: thread count should be between 1 and %d\n", MAX_SCAN_THREADS);
+                return E_FAILURE;
+            }
+            mp3query -> scan.threads = threads;
+        }
+        else if(strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            mp3query -> scan.index_fname = argv[++i];
+        }
+        else if(argv[i][0] != '-' && mp3query -> scan.root != NULL)
+        {
+            // queries come last, one per argument
+            mp3query -> queries = argv + i;
+            mp3query -> nqueries = argc - i;
+            break;
+        }
+        else
+        {
+            printf("Error: unknown query option '%s'\n", argv[i]);
+            return E_FAILURE;
+        }
+    }
+    if(mp3query -> scan.root == NULL)
+    {
+        printf("Error: missing directory name\n");
+        return E_FAILURE;
+    }
+    if(mp3query -> scan.fields != NULL && mp3query -> scan.index_fname != NULL)
+    {
+        printf("Error: --fields cannot be combined with -i\n");
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to append one number as a varint (7 bits per byte, low bits first);
+static inline unsigned char *put_varint(unsigned char *ptr, unsigned int value)
+{
+    while(value >= 0x80)
+    {
+        *ptr++ = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    *ptr++ = value;
+    return ptr;
+}
+
+//Function to read one varint;
+static inline const unsigned char *get_varint(const unsigned char *ptr, unsigned int *value)
+{
+    if(*ptr < 0x80)
+    {
+        // gaps in long lists are small, most take one byte
+        *value = *ptr;
+        return ptr + 1;
+    }
+    unsigned int result = *ptr & 0x7F;
+    int shift = 7;
+    while(*ptr++ & 0x80)
+    {
+        result |= (unsigned int)(*ptr & 0x7F) << shift;
+        shift += 7;
+    }
+    *value = result;
+    return ptr;
+}
+
+//Function to order two pool ids by their strings, for qsort_r();
+static int compare_terms(const void *a, const void *b, void *arg)
+{
+    return strpool_compare(arg, *(const unsigned int *)a, *(const unsigned int *)b);
+}
+
+//Function to release the lists of one frame;
+static void free_postings(POSTINGS *postings)
+{
+    free(postings -> terms);
+    free(postings -> counts);
+    free(postings -> offsets);
+    free(postings -> data);
+    memset(postings, 0, sizeof(*postings));
+    postings -> column = -1;
+}
+
+/* Function to build the postings of one catalogue column: the terms are
+   the distinct values in byte order, and a counting sort over the files
+   (already in path order) leaves every list sorted */
+status build_postings(POSTINGS *postings, const MP3CATALOG *catalog, const size_t *rows, int column)
+{
+    const STRPOOL *pool = &catalog -> pool;
+    const unsigned int *values = catalog -> columns[column];
+    size_t ndocs = catalog -> count;
+    unsigned int *term_of = calloc(pool -> count, sizeof(unsigned int));
+    unsigned int *docs = malloc((ndocs ? ndocs : 1) * sizeof(unsigned int));
+    size_t *fill = NULL;
+    size_t i;
+    unsigned int t;
+
+    memset(postings, 0, sizeof(*postings));
+    postings -> column = column;
+    postings -> ndocs = ndocs;
+    if(term_of == NULL || docs == NULL)
+    {
+        free(term_of);
+        free(docs);
+        return E_FAILURE;
+    }
+
+    // files of every value (term_of counts first, then maps a value to its term)
+    for(i = 0; i < ndocs; i++)
+    {
+        term_of[values[rows[i]]]++;
+    }
+    term_of[0] = 0;      // empty values are not indexed
+    for(i = 1; i < pool -> count; i++)
+    {
+        postings -> nterms += term_of[i] != 0;
+    }
+    unsigned int nterms = postings -> nterms;
+    postings -> terms = malloc((nterms ? nterms : 1) * sizeof(unsigned int));
+    postings -> counts = malloc((nterms ? nterms : 1) * sizeof(unsigned int));
+    postings -> offsets = malloc((nterms + 1) * sizeof(size_t));
+    fill = malloc((nterms ? nterms : 1) * sizeof(size_t));
+    if(postings -> terms == NULL || postings -> counts == NULL || postings -> offsets == NULL || fill == NULL)
+    {
+        free(term_of);
+        free(docs);
+        free(fill);
+        free_postings(postings);
+        return E_FAILURE;
+    }
+    for(i = 1, t = 0; i < pool -> count; i++)
+    {
+        if(term_of[i] != 0)
+        {
+            postings -> terms[t++] = i;
+        }
+    }
+    qsort_r(postings -> terms, nterms, sizeof(unsigned int), compare_terms, (void *)pool);
+
+    // term sizes and the place of every list in docs
+    size_t start = 0;
+    for(t = 0; t < nterms; t++)
+    {
+        unsigned int count = term_of[postings -> terms[t]];
+        postings -> counts[t] = count;
+        fill[t] = start;
+        start += count;
+        term_of[postings -> terms[t]] = t + 1;
+    }
+    for(i = 0; i < ndocs; i++)
+    {
+        unsigned int term = term_of[values[rows[i]]];
+        if(term != 0)
+        {
+            docs[fill[term - 1]++] = i;
+        }
+    }
+    free(term_of);
+
+    // varint gaps, at most 5 bytes per file
+    postings -> data = malloc(start * 5 + 1);
+    if(postings -> data == NULL)
+    {
+        free(docs);
+        free(fill);
+        free_postings(postings);
+        return E_FAILURE;
+    }
+    unsigned char *ptr = postings -> data;
+    const unsigned int *doc = docs;
+    for(t = 0; t < nterms; t++)
+    {
+        unsigned int j, previous = 0;
+        postings -> offsets[t] = ptr - postings -> data;
+        for(j = 0; j < postings -> counts[t]; j++, doc++)
+        {
+            ptr = put_varint(ptr, *doc - previous);
+            previous = *doc;
+        }
+    }
+    postings -> offsets[nterms] = ptr - postings -> data;
+    free(docs);
+    free(fill);
+    unsigned char *data = realloc(postings -> data, (ptr - postings -> data) + 1);
+    if(data != NULL)
+    {
+        postings -> data = data;
+    }
+    return E_SUCCESS;
+}
+
+//Function to decode the list of one term into an array (returns the files written);
+static size_t decode_term(const POSTINGS *postings, unsigned int term, unsigned int *docs)
+{
+    const unsigned char *ptr = postings -> data + postings -> offsets[term];
+    unsigned int i, count = postings -> counts[term], doc = 0, gap;
+
+    for(i = 0; i < count; i++)
+    {
+        ptr = get_varint(ptr, &gap);
+        doc += gap;
+        docs[i] = doc;
+    }
+    return count;
+}
+
+//Function to set the bit of every file in the list of one term;
+static void mark_term(const POSTINGS *postings, unsigned int term, unsigned long long *bitmap)
+{
+    const unsigned char *ptr = postings -> data + postings -> offsets[term];
+    unsigned int i, count = postings -> counts[term], doc = 0, gap;
+
+    for(i = 0; i < count; i++)
+    {
+        ptr = get_varint(ptr, &gap);
+        doc += gap;
+        bitmap[doc / 64] |= 1ULL << (doc % 64);
+    }
+}
+
+//Function to compare a term with a value, only up to its length for a prefix;
+static int compare_term(const STRPOOL *pool, unsigned int id, const char *value, size_t length, int prefix)
+{
+    unsigned int term_length;
+    const char *term = strpool_get(pool, id, &term_length);
+    int ret = memcmp(term, value, term_length < length ? term_length : length);
+    if(ret != 0 || (prefix && term_length >= length))
+    {
+        return ret;
+    }
+    return (term_length > length) - (term_length < length);
+}
+
+//Function to find the first term that is not below a value;
+static unsigned int lower_term(const POSTINGS *postings, const STRPOOL *pool, const char *value, size_t length, int prefix)
+{
+    unsigned int low = 0, high = postings -> nterms;
+    while(low < high)
+    {
+        unsigned int middle = low + (high - low) / 2;
+        if(compare_term(pool, postings -> terms[middle], value, length, prefix) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+//Function to parse one "<frame>=<value>[*]" condition into a range of terms;
+static status parse_condition(MP3QUERY *mp3query, const char *text, size_t length, CONDITION *condition)
+{
+    const STRPOOL *pool = &mp3query -> scan.catalog.pool;
+    const char *equal = memchr(text, '=', length);
+    unsigned int i, t;
+
+    if(equal == NULL || equal - text != 4)
+    {
+        fprintf(stderr, "Error: '%.*s' should be <frame>=<value>\n", (int)length, text);
+        return E_FAILURE;
+    }
+    condition -> postings = NULL;
+    for(i = 0; i < 4; i++)
+    {
+        if(memcmp(text, indexed[i], 4) == 0)
+        {
+            condition -> postings = &mp3query -> postings[i];
+        }
+    }
+    if(condition -> postings == NULL)
+    {
+        fprintf(stderr, "Error: %.4s is not indexed (TPE1, TALB, TCON and TYER are)\n", text);
+        return E_FAILURE;
+    }
+    if(condition -> postings -> column < 0)
+    {
+        fprintf(stderr, "Error: %.4s is not one of the --fields frames\n", text);
+        return E_FAILURE;
+    }
+    const char *value = equal + 1;
+    size_t value_length = text + length - value;
+    int prefix = value_length > 0 && value[value_length - 1] == '*';
+    value_length -= prefix;
+    condition -> value = value;
+    condition -> length = value_length;
+    condition -> prefix = prefix;
+
+    const POSTINGS *postings = condition -> postings;
+    condition -> first = lower_term(postings, pool, value, value_length, prefix);
+    condition -> last = condition -> first;
+    if(prefix)
+    {
+        // the terms with the prefix follow each other in byte order
+        unsigned int low = condition -> first, high = postings -> nterms;
+        while(low < high)
+        {
+            unsigned int middle = low + (high - low) / 2;
+            if(compare_term(pool, postings -> terms[middle], value, value_length, 1) <= 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        condition -> last = low;
+    }
+    else if(condition -> first < postings -> nterms &&
+            compare_term(pool, postings -> terms[condition -> first], value, value_length, 0) == 0)
+    {
+        condition -> last = condition -> first + 1;
+    }
+    condition -> count = 0;
+    for(t = condition -> first; t < condition -> last; t++)
+    {
+        condition -> count += postings -> counts[t];
+    }
+    return E_SUCCESS;
+}
+
+//Function to order two file numbers;
+static int compare_docs(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+//Function to get a bitmap of every file of a condition (free() the result);
+static unsigned long long *condition_bitmap(const CONDITION *condition)
+{
+    unsigned long long *bitmap = calloc(condition -> postings -> ndocs / 64 + 1, sizeof(unsigned long long));
+    unsigned int t;
+
+    if(bitmap == NULL)
+    {
+        return NULL;
+    }
+    for(t = condition -> first; t < condition -> last; t++)
+    {
+        mark_term(condition -> postings, t, bitmap);
+    }
+    return bitmap;
+}
+
+//Function to decode every file of a condition into a sorted array;
+static size_t decode_condition(const CONDITION *condition, unsigned int *docs)
+{
+    size_t count = 0;
+    unsigned int t;
+
+    // a file has one value per frame, so the lists of a prefix never overlap
+    if(condition -> last - condition -> first > 1 && condition -> count >= condition -> postings -> ndocs / 64)
+    {
+        // many files: a walk over the bitmap leaves them sorted
+        unsigned long long *bitmap = condition_bitmap(condition);
+        size_t word, nwords = condition -> postings -> ndocs / 64 + 1;
+        if(bitmap != NULL)
+        {
+            for(word = 0; word < nwords; word++)
+            {
+                unsigned long long bits = bitmap[word];
+                while(bits != 0)
+                {
+                    docs[count++] = word * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                }
+            }
+            free(bitmap);
+            return count;
+        }
+    }
+    for(t = condition -> first; t < condition -> last; t++)
+    {
+        count += decode_term(condition -> postings, t, docs + count);
+    }
+    if(condition -> last - condition -> first > 1)
+    {
+        qsort(docs, count, sizeof(unsigned int), compare_docs);
+    }
+    return count;
+}
+
+//Function to check the value of one file against a condition;
+static inline int file_matches(const MP3QUERY *mp3query, const CONDITION *condition, unsigned int doc)
+{
+    const MP3CATALOG *catalog = &mp3query -> scan.catalog;
+    unsigned int id = catalog -> columns[condition -> postings -> column][mp3query -> rows[doc]];
+    unsigned int length;
+
+    if(!condition -> prefix)
+    {
+        return id == condition -> postings -> terms[condition -> first];
+    }
+    const char *value = strpool_get(&catalog -> pool, id, &length);
+    return id != 0 && length >= condition -> length && memcmp(value, condition -> value, condition -> length) == 0;
+}
+
+/* Function to keep the files that also match a condition (returns the new
+   count); few files are checked against their own value in the catalogue,
+   many against a bitmap of the condition's lists */
+static size_t filter_condition(const MP3QUERY *mp3query, const CONDITION *condition, unsigned int *docs, size_t count)
+{
+    size_t i, kept = 0;
+
+    if(condition -> count == 0)
+    {
+        return 0;
+    }
+    if(count * QUERY_LOOKUP_COST > condition -> count)
+    {
+        unsigned long long *bitmap = condition_bitmap(condition);
+        if(bitmap != NULL)
+        {
+            for(i = 0; i < count; i++)
+            {
+                if(bitmap[docs[i] / 64] >> (docs[i] % 64) & 1)
+                {
+                    docs[kept++] = docs[i];
+                }
+            }
+            free(bitmap);
+            return kept;
+        }
+    }
+    for(i = 0; i < count; i++)
+    {
+        if(file_matches(mp3query, condition, docs[i]))
+        {
+            docs[kept++] = docs[i];
+        }
+    }
+    return kept;
+}
+
+//Function to order conditions by their number of files;
+static int compare_conditions(const void *a, const void *b)
+{
+    size_t x = ((const CONDITION *)a) -> count, y = ((const CONDITION *)b) -> count;
+    return (x > y) - (x < y);
+}
+
+//Function to answer one query into a buffer of file numbers (returns the count, -1 on error);
+long run_query(MP3QUERY *mp3query, const char *query, unsigned int **docs)
+{
+    CONDITION conditions[QUERY_MAX_CONDITIONS];
+    unsigned int nconditions = 0, i;
+    const char *ptr = query;
+
+    *docs = NULL;
+    while(1)
+    {
+        const char *and = strstr(ptr, "&&");
+        const char *end = and != NULL ? and : ptr + strlen(ptr);
+        // spaces around a condition do not count, inside a value they do
+        while(ptr < end && *ptr == ' ')
+        {
+            ptr++;
+        }
+        const char *stop = end;
+        while(stop > ptr && (stop[-1] == ' ' || stop[-1] == '\n' || stop[-1] == '\r'))
+        {
+            stop--;
+        }
+        if(nconditions == QUERY_MAX_CONDITIONS)
+        {
+            fprintf(stderr, "Error: at most %d conditions in a query\n", QUERY_MAX_CONDITIONS);
+            return -1;
+        }
+        if(parse_condition(mp3query, ptr, stop - ptr, &conditions[nconditions]) != E_SUCCESS)
+        {
+            return -1;
+        }
+        nconditions++;
+        if(and == NULL)
+        {
+            break;
+        }
+        ptr = and + 2;
+    }
+
+    // start from the rarest condition, the others only shrink it
+    qsort(conditions, nconditions, sizeof(CONDITION), compare_conditions);
+    *docs = malloc((conditions[0].count + 1) * sizeof(unsigned int));
+    if(*docs == NULL)
+    {
+        return -1;
+    }
+    size_t count = decode_condition(&conditions[0], *docs);
+    for(i = 1; i < nconditions && count > 0; i++)
+    {
+        count = filter_condition(mp3query, &conditions[i], *docs, count);
+    }
+    return (long)count;
+}
+
+//Function to answer one query and print its files;
+static status answer(MP3QUERY *mp3query, const char *query, OUTBUF *outbuf)
+{
+    unsigned int *docs;
+    long i;
+
+    unsigned long long start = stats_now();
+    long count = run_query(mp3query, query, &docs);
+    unsigned long long elapsed = stats_now() - start;
+    if(count < 0)
+    {
+        free(docs);
+        return E_FAILURE;
+    }
+    for(i = 0; i < count; i++)
+    {
+        format_catalog_row(&mp3query -> scan.catalog, mp3query -> rows[docs[i]], mp3query -> scan.fields,
+                           outbuf, mp3query -> scan.format);
+        outbuf_maybe_flush(outbuf);
+    }
+    free(docs);
+    outbuf_flush(outbuf);
+    fprintf(stderr, "%ld matches in %.1f us\n", count, elapsed / 1000.0);
+    return E_SUCCESS;
+}
+
+//Function to scan the library, build the indexes and answer every query;
+status Mp3Query(MP3QUERY *mp3query)
+{
+    MP3SCAN *scan = &mp3query -> scan;
+    MP3CATALOG *catalog = &scan -> catalog;
+    OUTBUF outbuf;
+    status ret = E_SUCCESS;
+    unsigned int i;
+    int n;
+
+    for(i = 0; i < 4; i++)
+    {
+        mp3query -> postings[i].column = -1;
+    }
+    scan -> order = "file";
+    scan -> quiet = 1;
+    if(Mp3Scan(scan) != E_SUCCESS && catalog -> count == 0)
+    {
+        return E_FAILURE;
+    }
+
+    unsigned long long start = stats_now();
+    mp3query -> rows = catalog_sort(catalog, CATALOG_FILE_COLUMN);
+    if(mp3query -> rows == NULL)
+    {
+        fprintf(stderr, "Error: out of memory\n");
+        return E_FAILURE;
+    }
+    size_t bytes = 0;
+    for(i = 0; i < 4; i++)
+    {
+        int column = catalog_column(catalog, indexed[i]);
+        if(column >= 0 && build_postings(&mp3query -> postings[i], catalog, mp3query -> rows, column) != E_SUCCESS)
+        {
+            fprintf(stderr, "Error: out of memory\n");
+            return E_FAILURE;
+        }
+        bytes += mp3query -> postings[i].column >= 0 ? mp3query -> postings[i].offsets[mp3query -> postings[i].nterms] : 0;
+    }
+    fprintf(stderr, "Indexed %zu files in %.1f ms, %zu bytes of postings\n", catalog -> count,
+            (stats_now() - start) / 1e6, bytes);
+
+    if(outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    format_header(scan -> fields, &outbuf, scan -> format);
+    if(mp3query -> nqueries > 0)
+    {
+        for(n = 0; n < mp3query -> nqueries; n++)
+        {
+            if(answer(mp3query, mp3query -> queries[n], &outbuf) != E_SUCCESS)
+            {
+                ret = E_FAILURE;
+            }
+        }
+    }
+    else
+    {
+        // one query per line until the end of the input
+        char line[QUERY_LINE_MAX];
+        while(fgets(line, sizeof(line), stdin) != NULL)
+        {
+            if(line[0] == '\n' || line[0] == '#')
+            {
+                continue;
+            }
+            if(answer(mp3query, line, &outbuf) != E_SUCCESS)
+            {
+                ret = E_FAILURE;
+            }
+        }
+    }
+    if(outbuf_free(&outbuf) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    return ret;
+}
+
+//Function to release the indexes, the catalogue and the scan;
+void free_query(MP3QUERY *mp3query)
+{
+    unsigned int i;
+    for(i = 0; i < 4; i++)
+    {
+        free_postings(&mp3query -> postings[i]);
+    }
+    free(mp3query -> rows);
+    mp3query -> rows = NULL;
+    free_scan(&mp3query -> scan);
+}
@@ -0,0 +1,104 @@
+/*
+File        : mp3query.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the tag query mode.
+
+              This file contains the structure definitions and function
+              prototypes required to answer questions such as "every
+              track by this artist from 1998" from inverted indexes over
+              the tags of a library.
+
+              Key Components:
+               - POSTINGS : The index of one frame. Every distinct value
+                            (a term) has the sorted list of the files that
+                            carry it, stored as varint encoded gaps.
+               - CONDITION: One "<frame>=<value>[*]" of a query: the range
+                            of terms it matches and their number of files.
+               - MP3QUERY : The scan that fills the catalogue (see
+                            mp3catalog.h), the path order of its rows and
+                            the POSTINGS of TPE1, TALB, TCON and TYER.
+
+              Query Workflow:
+               1. User runs "./a.out -f <dir> [-j <threads>] [-i <index>] [query ...]".
+               2. The library is scanned into a catalogue (quickly with
+                  -i, where unchanged files are not opened).
+               3. Files are numbered in path order and the postings of
+                  every indexed frame are built with one counting sort.
+               4. Every query argument, or every line of stdin when there
+                  is none, is answered with the matching files in path
+                  order, in the --format of the scan.
+
+              Query Syntax:
+               <frame>=<value>      the frame is exactly value
+               <frame>=<prefix>*    the frame starts with prefix
+               a && b && ...        all conditions hold
+               e.g. "TPE1=Some Artist && TYER=1998 && TALB=Live*"
+
+              Notes:
+               - Values are compared as UTF-8 bytes, case sensitive.
+               - The rarest condition is decoded first. The others only
+                 check its files: a few by looking at their value in the
+                 catalogue, many through a bitmap of the condition's
+                 lists. So the cost follows the smallest list, not the
+                 largest.
+               - The time of each query goes to stderr with its count.
+*/
+#ifndef mp3query_h
+#define mp3query_h
+#include <stddef.h>
+#include "types.h"
+#include "mp3scan.h"
+#include "mp3catalog.h"
+
+#define QUERY_MAX_CONDITIONS 16
+#define QUERY_LINE_MAX 4096
+#define QUERY_LOOKUP_COST 8           // a catalogue lookup costs about as much as decoding this many files
+
+typedef struct postings
+{
+	int column;                  // catalogue column of the frame, -1 when not shown
+	size_t ndocs;                // files numbered (the catalogue rows)
+	unsigned int nterms;         // distinct non empty values
+	unsigned int *terms;         // pool id of every value, in byte order
+	unsigned int *counts;        // files of every term
+	size_t *offsets;             // start of every list in data (nterms + 1)
+	unsigned char *data;         // varint gaps of every list
+}POSTINGS;
+
+typedef struct condition
+{
+	const POSTINGS *postings;
+	unsigned int first;          // terms [first, last) match
+	unsigned int last;
+	size_t count;                // files of the matching terms
+	const char *value;           // value or prefix, inside the query text
+	size_t length;
+	int prefix;                  // the value ended with '*'
+}CONDITION;
+
+typedef struct mp3query
+{
+	MP3SCAN scan;                // library, thread count, catalogue
+	char **queries;              // queries given on the command line
+	int nqueries;
+	size_t *rows;                // catalogue row of every file number (path order)
+	POSTINGS postings[4];        // TPE1, TALB, TCON, TYER
+}MP3QUERY;
+
+//Function to read the query options (-f <dir> [-j <threads>] [-i <index>] [query ...]);
+status check_query_args(int argc, char *argv[], MP3QUERY *mp3query);
+
+//Function to scan the library, build the indexes and answer every query;
+status Mp3Query(MP3QUERY *mp3query);
+
+//Function to build the postings of one catalogue column;
+status build_postings(POSTINGS *postings, const MP3CATALOG *catalog, const size_t *rows, int column);
+
+//Function to answer one query into a buffer of file numbers (returns the count, -1 on error);
+long run_query(MP3QUERY *mp3query, const char *query, unsigned int **docs);
+
+//Function to release the indexes, the catalogue and the scan;
+void free_query(MP3QUERY *mp3query);
+
+#endif
@@ -0,0 +1,433 @@
+/*
+File        : mp3scan.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the recursive library scan mode.
+
+              This file contains the function definitions required to:
+               - Read the scan options from the command line
+               - Walk a directory tree and collect ".mp3" files
+               - Run a pool of worker threads that parse the files
+               - Format the tags of every file into per-thread buffers
+                 (as text, JSON Lines or TSV, see mp3format.h)
+
+              Notes:
+               - With -o the records are kept in a catalogue and printed
+                 in order once all files are read.
+               - In async mode (-a) the work is done by uring_scan() and
+                 the thread pool is only the fallback.
+               - Files are handed out with an atomic counter, so there is
+                 no lock on the work list.
+               - Only the output flush takes a lock (see outbuf.c).
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3scan.h"
+#include "mp3uring.h"
+#include "outbuf.h"
+#include "mp3format.h"
+
+/* Function to get the default number of worker threads; one per online
+   CPU, but never more than the workers[] arrays of the pools can hold */
+unsigned int default_threads(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if(cpus < 1)
+    {
+        return 1;
+    }
+    return cpus > MAX_SCAN_THREADS ? MAX_SCAN_THREADS : (unsigned int)cpus;
+}
+
+//Function to read the scan options (-r <dir> [-j <threads>] [-a [-q <depth>]] [-i <index>] [-o <frame>]);
+status check_scan_args(int argc, char *argv[], MP3SCAN *mp3scan)
+{
+    int i;
+
+    mp3scan -> root = NULL;
+    mp3scan -> threads = default_threads();
+    for(i = 2; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            mp3scan -> root = argv[++i];
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            int threads = atoi(argv[++i]);
+            if(threads < 1 || threads > MAX_SCAN_THREADS)
+            {
+                printf("Error: thread count should be between 1 and %d\n", MAX_SCAN_THREADS);
+                return E_FAILURE;
+            }
+            mp3scan -> threads = threads;
+        }
+        else if(strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            mp3scan -> index_fname = argv[++i];
+        }
+        else if(strcmp(argv[i], "-a") == 0)
+        {
+            mp3scan -> async = 1;
+        }
+        else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            mp3scan -> order = argv[++i];
+        }
+        else if(strcmp(argv[i], "-q") == 0 && i + 1 < argc)
+        {
+            int depth = atoi(argv[++i]);
+            if(depth < 1 || depth > URING_MAX_DEPTH)
+            {
+                printf("Error: queue depth should be between 1 and %d\n", URING_MAX_DEPTH);
+                return E_FAILURE;
+            }
+            mp3scan -> depth = depth;
+            mp3scan -> async = 1;
+        }
+        else
+        {
+            printf("Error: unknown scan option '%s'\n", argv[i]);
+            return E_FAILURE;
+        }
+    }
+    if(mp3scan -> root == NULL)
+    {
+        printf("Error: missing directory name\n");
+        return E_FAILURE;
+    }
+    // the index and io_uring paths always read the six tags of the whole tag
+    if(mp3scan -> fields != NULL && (mp3scan -> index_fname != NULL || mp3scan -> async))
+    {
+        printf("Error: --fields cannot be combined with -a or -i\n");
+        return E_FAILURE;
+    }
+    // the io_uring path prints each file as its reads complete
+    if(mp3scan -> order != NULL && mp3scan -> async)
+    {
+        printf("Error: -o cannot be combined with -a\n");
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to add one file name to the work list;
+static status add_file(MP3SCAN *mp3scan, const char *path)
+{
+    if(mp3scan -> count == mp3scan -> capacity)
+    {
+        size_t capacity = mp3scan -> capacity ? mp3scan -> capacity * 2 : 1024;
+        char **files = realloc(mp3scan -> files, capacity * sizeof(char *));
+        if(files == NULL)
+        {
+            return E_FAILURE;
+        }
+        mp3scan -> files = files;
+        mp3scan -> capacity = capacity;
+    }
+    mp3scan -> files[mp3scan -> count] = strdup(path);
+    if(mp3scan -> files[mp3scan -> count] == NULL)
+    {
+        return E_FAILURE;
+    }
+    mp3scan -> count++;
+    return E_SUCCESS;
+}
+
+//Function to collect all mp3 files below a directory;
+status collect_mp3files(MP3SCAN *mp3scan, const char *dir)
+{
+    DIR *dp = opendir(dir);
+    struct dirent *entry;
+    size_t dir_len = strlen(dir);
+
+    if(dp == NULL)
+    {
+        perror(dir);
+        return E_FAILURE;
+    }
+    while((entry = readdir(dp)) != NULL)
+    {
+        if(strcmp(entry -> d_name, ".") == 0 || strcmp(entry -> d_name, "..") == 0)
+        {
+            continue;
+        }
+        size_t length = dir_len + strlen(entry -> d_name) + 2;
+        char *path = malloc(length);
+        if(path == NULL)
+        {
+            closedir(dp);
+            return E_FAILURE;
+        }
+        snprintf(path, length, "%s%s%s", dir, (dir_len && dir[dir_len - 1] == '/') ? "" : "/", entry -> d_name);
+
+        unsigned char type = entry -> d_type;
+        if(type == DT_UNKNOWN)
+        {
+            struct stat st;
+            type = DT_UNKNOWN;
+            if(lstat(path, &st) == 0)
+            {
+                type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+        }
+
+        status ret = E_SUCCESS;
+        if(type == DT_DIR)
+        {
+            collect_mp3files(mp3scan, path);
+        }
+        else if(type == DT_REG && has_mp3_extension(entry -> d_name))
+        {
+            ret = add_file(mp3scan, path);
+        }
+        free(path);
+        if(ret != E_SUCCESS)
+        {
+            closedir(dp);
+            return E_FAILURE;
+        }
+    }
+    closedir(dp);
+    return E_SUCCESS;
+}
+
+//Function to print the tags of one file, or keep them for the sorted output;
+static void emit_mp3tags(MP3SCAN *mp3scan, const MP3VIEW *mp3view, OUTBUF *outbuf)
+{
+    if(mp3scan -> order != NULL && catalog_add(&mp3scan -> catalog, mp3view) == E_SUCCESS)
+    {
+        return;
+    }
+    format_mp3tags(mp3view, outbuf, mp3scan -> format);
+}
+
+//Function to view one file, through the index when one is used;
+void scan_one_file(MP3SCAN *mp3scan, char *fname, OUTBUF *outbuf, OUTBUF *records, ARENA *arena)
+{
+    MP3VIEW mp3view = {0};
+    struct stat st;
+    int use_index = mp3scan -> index_fname != NULL && stat(fname, &st) == 0;
+
+    if(use_index)
+    {
+        INDEXENTRY *entry = index_lookup(&mp3scan -> index, fname);
+        if(entry != NULL)
+        {
+            entry -> seen = 1;
+        }
+        if(entry != NULL && index_entry_matches(entry, &st))
+        {
+            // unchanged since the last scan: answer from the index without opening the file
+            __atomic_fetch_add(&mp3scan -> index.hits, 1, __ATOMIC_RELAXED);
+            if(entry -> record.failed)
+            {
+                // the reason of the failure is kept as the first value
+                char error[256];
+                snprintf(error, sizeof(error), "%.*s", (int)entry -> record.value_length[0], entry -> values);
+                if(!mp3scan -> quiet)
+                {
+                    format_error(fname, error, mp3scan -> fields, outbuf, mp3scan -> format);
+                }
+                __atomic_fetch_add(&mp3scan -> failed, 1, __ATOMIC_RELAXED);
+            }
+            else
+            {
+                index_entry_to_view(entry, &mp3view);
+                emit_mp3tags(mp3scan, &mp3view, outbuf);
+            }
+            return;
+        }
+        __atomic_fetch_add(&mp3scan -> index.parsed, 1, __ATOMIC_RELAXED);
+    }
+
+    mp3view.sample_mp3_fname = fname;
+    mp3view.arena = arena;
+    mp3view.fields = mp3scan -> fields;
+    status ret = parse_mp3file(&mp3view);
+    if(ret == E_SUCCESS)
+    {
+        emit_mp3tags(mp3scan, &mp3view, outbuf);
+    }
+    else
+    {
+        if(!mp3scan -> quiet)
+        {
+            format_error(fname, mp3view.error, mp3scan -> fields, outbuf, mp3scan -> format);
+        }
+        __atomic_fetch_add(&mp3scan -> failed, 1, __ATOMIC_RELAXED);
+    }
+    if(use_index)
+    {
+        index_add_record(records, &mp3view, ret, &st);
+        outbuf_maybe_flush(records);
+    }
+    close_mp3file(&mp3view);
+}
+
+//Function run by every worker thread;
+void *scan_worker(void *arg)
+{
+    MP3SCAN *mp3scan = arg;
+    OUTBUF outbuf, records;
+    ARENA arena = {0};
+
+    if(outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, &mp3scan -> out_lock) != E_SUCCESS)
+    {
+        return NULL;
+    }
+    if(outbuf_init(&records, mp3scan -> index.fd, mp3scan -> index_fname ? OUTBUF_SIZE : 0, &mp3scan -> index.lock) != E_SUCCESS)
+    {
+        outbuf_free(&outbuf);
+        return NULL;
+    }
+    while(1)
+    {
+        size_t index = __atomic_fetch_add(&mp3scan -> next, 1, __ATOMIC_RELAXED);
+        if(index >= mp3scan -> count)
+        {
+            break;
+        }
+        scan_one_file(mp3scan, mp3scan -> files[index], &outbuf, &records, &arena);
+        outbuf_maybe_flush(&outbuf);
+        arena_reset(&arena);
+    }
+    arena_free(&arena);
+    outbuf_free(&records);
+    outbuf_free(&outbuf);
+    return NULL;
+}
+
+//Function to print the catalogue sorted by the -o frame;
+static status print_sorted(MP3SCAN *mp3scan, int column)
+{
+    OUTBUF outbuf;
+    size_t i;
+    size_t *rows = catalog_sort(&mp3scan -> catalog, column);
+
+    if(rows == NULL || outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL) != E_SUCCESS)
+    {
+        free(rows);
+        return E_FAILURE;
+    }
+    for(i = 0; i < mp3scan -> catalog.count; i++)
+    {
+        format_catalog_row(&mp3scan -> catalog, rows[i], mp3scan -> fields, &outbuf, mp3scan -> format);
+        outbuf_maybe_flush(&outbuf);
+    }
+    free(rows);
+    return outbuf_free(&outbuf);
+}
+
+//Function to scan a whole directory tree;
+status Mp3Scan(MP3SCAN *mp3scan)
+{
+    pthread_t workers[MAX_SCAN_THREADS];
+    unsigned int i, started = 0;
+    int column = 0;
+
+    if(mp3scan -> order != NULL)
+    {
+        if(catalog_init(&mp3scan -> catalog, mp3scan -> fields) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+        column = catalog_column(&mp3scan -> catalog, mp3scan -> order);
+        if(column < 0)
+        {
+            printf("Error: -o %s is not one of the frames shown\n", mp3scan -> order);
+            return E_FAILURE;
+        }
+    }
+    if(collect_mp3files(mp3scan, mp3scan -> root) != E_SUCCESS && mp3scan -> count == 0)
+    {
+        return E_FAILURE;
+    }
+    fflush(stdout);
+    // in the machine formats stdout only carries records, the summary goes to stderr
+    FILE *summary = mp3scan -> format == format_text && !mp3scan -> quiet ? stdout : stderr;
+    OUTBUF header;
+    if(!mp3scan -> quiet && outbuf_init(&header, STDOUT_FILENO, 0, NULL) == E_SUCCESS)
+    {
+        format_header(mp3scan -> fields, &header, mp3scan -> format);
+        outbuf_free(&header);
+    }
+    if(mp3scan -> index_fname != NULL)
+    {
+        if(index_open(&mp3scan -> index, mp3scan -> index_fname) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+    }
+    else if(mp3scan -> async && uring_scan(mp3scan) == E_SUCCESS)
+    {
+        fprintf(summary, "Scanned %zu files through io_uring (%u in flight), %lu failed\n", mp3scan -> count,
+               mp3scan -> depth ? mp3scan -> depth : URING_DEFAULT_DEPTH, mp3scan -> failed);
+        return mp3scan -> failed ? E_FAILURE : E_SUCCESS;
+    }
+    if(mp3scan -> threads > mp3scan -> count)
+    {
+        mp3scan -> threads = mp3scan -> count ? mp3scan -> count : 1;
+    }
+
+    pthread_mutex_init(&mp3scan -> out_lock, NULL);
+    for(i = 0; i < mp3scan -> threads; i++)
+    {
+        if(pthread_create(&workers[i], NULL, scan_worker, mp3scan) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if(started == 0)
+    {
+        // no thread could be started, do the work on this one
+        scan_worker(mp3scan);
+    }
+    for(i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_mutex_destroy(&mp3scan -> out_lock);
+    if(mp3scan -> order != NULL && !mp3scan -> quiet && print_sorted(mp3scan, column) != E_SUCCESS)
+    {
+        fprintf(summary, "Error: could not sort the output\n");
+        mp3scan -> failed++;
+    }
+
+    fprintf(summary, "Scanned %zu files with %u threads, %lu failed\n", mp3scan -> count, mp3scan -> threads, mp3scan -> failed);
+    if(mp3scan -> index_fname != NULL)
+    {
+        fprintf(summary, "Index %s: %lu unchanged, %lu parsed\n", mp3scan -> index_fname, mp3scan -> index.hits, mp3scan -> index.parsed);
+        if(index_compact(&mp3scan -> index, mp3scan -> root) != E_SUCCESS)
+        {
+            fprintf(summary, "Warning: could not compact the index\n");
+        }
+        index_close(&mp3scan -> index);
+    }
+    return mp3scan -> failed ? E_FAILURE : E_SUCCESS;
+}
+
+//Function to release the collected file names;
+void free_scan(MP3SCAN *mp3scan)
+{
+    size_t i;
+    for(i = 0; i < mp3scan -> count; i++)
+    {
+        free(mp3scan -> files[i]);
+    }
+    free(mp3scan -> files);
+    mp3scan -> files = NULL;
+    if(mp3scan -> order != NULL)
+    {
+        catalog_free(&mp3scan -> catalog);
+    }
+    mp3scan -> count = mp3scan -> capacity = 0;
+}
@@ -0,0 +1,105 @@
+/*
+File        : mp3scan.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the recursive library scan mode.
+
+              This file contains the structure definition and function
+              prototypes required to walk a directory tree and view the
+              tags of every MP3 file in it using a pool of worker threads.
+
+              Key Components:
+               - MP3SCAN : Holds the root directory, the list of collected
+                           file names, the next file to hand out and the
+                           number of worker threads.
+
+              Scan Workflow:
+               1. User runs "./a.out -v -r <dir> [-j <threads>] [-a [-q <depth>]] [-i <index>] [-o <frame>]".
+               2. The directory tree is walked and every ".mp3" file is
+                  collected (symbolic links are not followed).
+               3. Worker threads take files one by one and parse them with
+                  the same code as the single file view (parse_mp3file()).
+               4. Each worker formats its results into its own OUTBUF and
+                  writes whole buffers to stdout, so output of different
+                  files never interleaves. With --format=jsonl or
+                  --format=tsv every file becomes one line (mp3format.h).
+
+              Async Mode:
+               - With "-a" the files are read by a single thread through
+                 io_uring with up to "-q <depth>" files in flight (see
+                 mp3uring.h); the thread pool is used when io_uring is
+                 not available.
+
+              Index Mode:
+               - With "-i <index>" every file is stat'ed first and only
+                 parsed when (device, inode, size, mtime) differ from its
+                 record in the index (see mp3index.h); new records are
+                 appended by the workers. Index rescans always use the
+                 thread pool since unchanged files are never opened.
+
+              Ordered Mode:
+               - With "-o <frame>" (a frame id of the output, or "file")
+                 the workers put the tags into an MP3CATALOG instead of
+                 printing them (see mp3catalog.h); once every file is read
+                 the rows are sorted by that frame and printed. Files that
+                 failed are still reported as they are found.
+
+              Notes:
+               - The default worker count is the number of online CPUs.
+*/
+#ifndef mp3scan_h
+#define mp3scan_h
+#include <stddef.h>
+#include <pthread.h>
+#include "types.h"
+#include "mp3view.h"
+#include "outbuf.h"
+#include "mp3index.h"
+#include "mp3format.h"
+#include "mp3catalog.h"
+
+#define MAX_SCAN_THREADS 256
+
+typedef struct mp3scan
+{
+	char *root;              // directory to walk
+	unsigned int threads;    // number of worker threads
+	int async;               // read through io_uring instead of the thread pool
+	unsigned int depth;      // files in flight in async mode
+	char *index_fname;       // persistent tag index (-i), NULL when not used
+	const FIELDSET *fields;  // --fields, NULL for the six tags
+	OutputFormat format;     // --format: text, JSON Lines or TSV records
+	MP3INDEX index;
+	const char *order;       // -o: frame the output is sorted by, NULL to print as read
+	MP3CATALOG catalog;      // tags of every file when the output is sorted
+	int quiet;               // only fill the catalogue, print no records (query mode)
+	char **files;            // collected file names
+	size_t count;            // number of collected files
+	size_t capacity;         // allocated entries in files
+	size_t next;             // index of the next file to hand out (atomic)
+	unsigned long failed;    // files that could not be parsed (atomic)
+	pthread_mutex_t out_lock; // serialises writes of the worker buffers
+}MP3SCAN;
+
+//Function to get the default number of worker threads (online CPUs, at most MAX_SCAN_THREADS);
+unsigned int default_threads(void);
+
+//Function to read the scan options (-r <dir> [-j <threads>] ... [-o <frame>]);
+status check_scan_args(int argc, char *argv[], MP3SCAN *mp3scan);
+
+//Function to scan a whole directory tree;
+status Mp3Scan(MP3SCAN *mp3scan);
+
+//Function to collect all mp3 files below a directory;
+status collect_mp3files(MP3SCAN *mp3scan, const char *dir);
+
+//Function to view one file, through the index when one is used;
+void scan_one_file(MP3SCAN *mp3scan, char *fname, OUTBUF *outbuf, OUTBUF *records, ARENA *arena);
+
+//Function run by every worker thread;
+void *scan_worker(void *arg);
+
+//Function to release the collected file names;
+void free_scan(MP3SCAN *mp3scan);
+
+#endif
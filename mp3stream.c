@@ -0,0 +1,306 @@
+/*
+File        : mp3stream.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for reading and editing tags of an MP3
+              stream.
+
+              This file contains the function definitions of the chunk fed
+              tag parser and of the stdin to stdout edit filter built on it.
+
+              Features:
+               - Take the tag header and body from chunks of any size and
+                 resume where the previous chunk stopped
+               - Check the header as soon as its 10 bytes are in, refuse
+                 tags larger than the limit before buffering them
+               - Find the frames of the complete body with the same layout
+                 code as a file (id3_parse_layout())
+               - Rebuild the frames with the edits of an MP3EDIT and write
+                 the new tag, then pass the audio on untouched
+
+              Notes:
+               - Only the tag is buffered; the audio goes from input to
+                 output with splice(), or one chunk at a time.
+               - Nothing here seeks, so a pipe, a socket or a terminal
+                 works as well as a file.
+*/
+#define _GNU_SOURCE          // splice()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include "types.h"
+#include "mp3stream.h"
+#include "mp3view.h"
+#include "stats.h"
+
+//Function to set up a parser at the start of a stream;
+void stream_init(MP3STREAM *stream, ARENA *arena, unsigned int limit)
+{
+    memset(stream, 0, sizeof(MP3STREAM));
+    stream -> state = stream_header;
+    stream -> id3tag.arena = arena;
+    stream -> limit = limit;
+}
+
+/* Function to feed one chunk; the bytes that belong to the tag header
+   or body are taken, and once the state is stream_audio the rest of the
+   chunk (and everything after it) is audio. A stream that does not start
+   with a tag keeps its first 10 bytes in id3tag.header */
+size_t stream_feed(MP3STREAM *stream, const unsigned char *data, size_t length)
+{
+    ID3TAG *id3tag = &stream -> id3tag;
+    size_t taken = 0;
+
+    if(stream -> state == stream_header)
+    {
+        size_t want = ID3_HEADER_SIZE - stream -> have;
+        if(want > length)
+        {
+            want = length;
+        }
+        memcpy(id3tag -> header + stream -> have, data, want);
+        stream -> have += want;
+        taken += want;
+        if(stream -> have < ID3_HEADER_SIZE)
+        {
+            return taken;
+        }
+        if(!id3_valid_header(id3tag -> header, "ID3"))
+        {
+            stream -> state = stream_audio;
+            return taken;
+        }
+        id3tag -> size = bigendian_to_littleendian(id3tag -> header + 6);
+        if(id3tag -> size > stream -> limit)
+        {
+            stream -> error = "Error: the tag is too large to be buffered";
+            stream -> state = stream_failed;
+            return taken;
+        }
+        id3tag -> map = NULL;
+        id3tag -> buffer = arena_alloc(id3tag -> arena, id3tag -> size ? id3tag -> size : 1);
+        if(id3tag -> buffer == NULL)
+        {
+            stream -> error = "Error: out of memory";
+            stream -> state = stream_failed;
+            return taken;
+        }
+        stream -> tagged = 1;
+        stream -> have = 0;
+        stream -> state = stream_body;
+    }
+
+    if(stream -> state == stream_body)
+    {
+        size_t want = id3tag -> size - stream -> have;
+        if(want > length - taken)
+        {
+            want = length - taken;
+        }
+        memcpy(id3tag -> buffer + stream -> have, data + taken, want);
+        stream -> have += want;
+        taken += want;
+        if(stream -> have == id3tag -> size)
+        {
+            if(id3_parse_layout(id3tag) != E_SUCCESS)
+            {
+                stream -> error = "Error: the tag is broken";
+                stream -> state = stream_failed;
+            }
+            else
+            {
+                stream -> state = stream_audio;
+            }
+        }
+    }
+    return taken;
+}
+
+//Function to tell the parser the stream has ended;
+void stream_finish(MP3STREAM *stream)
+{
+    if(stream -> state == stream_header)
+    {
+        // shorter than a tag header: no tag
+        stream -> state = stream_audio;
+    }
+    else if(stream -> state == stream_body)
+    {
+        stream -> error = "Error: the stream ended inside the tag";
+        stream -> state = stream_failed;
+    }
+}
+
+/* Function to read a stream until its tag is parsed; chunk holds
+   STREAM_CHUNK_SIZE bytes and on return chunk[*start, *end) is the audio
+   that came with the last bytes of the tag */
+status stream_read_tag(MP3STREAM *stream, int fd, unsigned char *chunk, size_t *start, size_t *end)
+{
+    *start = *end = 0;
+    while(stream -> state == stream_header || stream -> state == stream_body)
+    {
+        ssize_t bytes = read(fd, chunk, STREAM_CHUNK_SIZE);
+        STATS_IO(stat_bytes_read, bytes);
+        if(bytes < 0)
+        {
+            stream -> error = "Error: Unable to read the stream";
+            stream -> state = stream_failed;
+            break;
+        }
+        if(bytes == 0)
+        {
+            stream_finish(stream);
+            *start = *end = 0;
+            break;
+        }
+        *start = stream_feed(stream, chunk, bytes);
+        *end = bytes;
+    }
+    return stream -> state == stream_failed ? E_FAILURE : E_SUCCESS;
+}
+
+//Function to write a whole buffer, a pipe may take less at a time;
+static status write_all(int fd, const unsigned char *buffer, size_t length)
+{
+    while(length > 0)
+    {
+        ssize_t written = write(fd, buffer, length);
+        STATS_IO(stat_bytes_written, written);
+        if(written < 0)
+        {
+            return E_FAILURE;
+        }
+        buffer += written;
+        length -= written;
+    }
+    return E_SUCCESS;
+}
+
+/* Function to pass the rest of the stream on; splice() moves pipe pages
+   without a copy but needs a pipe on one side (EINVAL otherwise), then
+   the chunk buffer is used for a read/write loop */
+static status pass_through(int in_fd, int out_fd, unsigned char *chunk)
+{
+    ssize_t bytes;
+    while((bytes = splice(in_fd, NULL, out_fd, NULL, STREAM_SPLICE_SIZE, SPLICE_F_MOVE | SPLICE_F_MORE)) > 0)
+    {
+        STATS_IO(stat_bytes_written, bytes);
+    }
+    if(bytes == 0)
+    {
+        return E_SUCCESS;
+    }
+    if(errno != EINVAL && errno != ENOSYS)
+    {
+        return E_FAILURE;
+    }
+    while((bytes = read(in_fd, chunk, STREAM_CHUNK_SIZE)) > 0)
+    {
+        STATS_IO(stat_bytes_read, bytes);
+        if(write_all(out_fd, chunk, bytes) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+    }
+    return bytes < 0 ? E_FAILURE : E_SUCCESS;
+}
+
+/* Function to write the tag with the edits applied; a tag whose frames
+   still fit keeps its size, one that grew gets ID3_GROW_PADDING bytes of
+   padding, and a tag without any of the frames goes out as it came */
+static status write_edited_tag(MP3EDIT *mp3edit, const ID3TAG *id3tag, ARENA *arena, int out_fd)
+{
+    unsigned char header[ID3_HEADER_SIZE];
+    unsigned int edit_offset, size = id3tag -> size;
+    int edited;
+
+    // zeroed: whatever follows the frames is the padding
+    unsigned char *body = arena_calloc(arena, id3tag -> size + edit_growth(mp3edit) + ID3_GROW_PADDING);
+    if(body == NULL)
+    {
+        mp3edit -> error = "Error: out of memory";
+        return E_FAILURE;
+    }
+    unsigned int out = rebuild_tag_frames(mp3edit, id3tag, body, &edit_offset, &edited);
+    if(!edited)
+    {
+        body = id3tag -> buffer;
+    }
+    else if(out > size)
+    {
+        size = out + ID3_GROW_PADDING;
+    }
+    memcpy(header, id3tag -> header, ID3_HEADER_SIZE);
+    int_to_syncsafe(size, header + 6);
+
+    STATS_BEGIN(start);
+    status ret = write_all(out_fd, header, ID3_HEADER_SIZE);
+    if(ret == E_SUCCESS)
+    {
+        ret = write_all(out_fd, body, size);
+    }
+    STATS_END(phase_write, start);
+    if(ret != E_SUCCESS)
+    {
+        mp3edit -> error = "Error: Unable to write the stream";
+    }
+    return ret;
+}
+
+/* Function to apply the edits to the stream on in_fd and write it to
+   out_fd in one pass; nothing is written unless the tag could be read
+   and edited, after that the audio is passed on as it arrives */
+status stream_edit(MP3EDIT *mp3edit, int in_fd, int out_fd)
+{
+    MP3STREAM stream;
+    ARENA own_arena = {0};
+    ARENA *arena = mp3edit -> arena != NULL ? mp3edit -> arena : &own_arena;
+    size_t start, end;
+    status ret = E_FAILURE;
+
+    unsigned char *chunk = malloc(STREAM_CHUNK_SIZE);
+    STATS_COUNT(stat_mallocs, 1);
+    if(chunk == NULL)
+    {
+        mp3edit -> error = "Error: out of memory";
+        return E_FAILURE;
+    }
+    stream_init(&stream, arena, STREAM_TAG_LIMIT);
+    STATS_BEGIN(read_start);
+    status found = stream_read_tag(&stream, in_fd, chunk, &start, &end);
+    STATS_END(phase_read_tag, read_start);
+
+    if(found != E_SUCCESS)
+    {
+        mp3edit -> error = stream.error;
+    }
+    else if(!stream.tagged)
+    {
+        mp3edit -> error = "Error: ID3v2 tag was not found at the start of the stream";
+    }
+    else if(stream.id3tag.header[3] != 3 || (stream.id3tag.header[5] & 0x80))
+    {
+        mp3edit -> error = "Error: only ID3v2.3 tags without unsynchronisation can be edited";
+    }
+    else
+    {
+        ret = write_edited_tag(mp3edit, &stream.id3tag, arena, out_fd);
+    }
+
+    if(ret == E_SUCCESS)
+    {
+        STATS_BEGIN(copy_start);
+        if(write_all(out_fd, chunk + start, end - start) != E_SUCCESS || pass_through(in_fd, out_fd, chunk) != E_SUCCESS)
+        {
+            mp3edit -> error = "Error: Unable to copy the stream";
+            ret = E_FAILURE;
+        }
+        STATS_END(phase_copy, copy_start);
+    }
+    free(chunk);
+    arena_free(&own_arena);
+    return ret;
+}
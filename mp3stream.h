@@ -0,0 +1,91 @@
+/*
+File        : mp3stream.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for reading and editing tags of an MP3 stream.
+
+              This file contains the structure definition and function
+              prototypes required to work on an MP3 that arrives on a pipe
+              or a socket (an upload), where nothing can be read twice and
+              the file is never seen as a whole.
+
+              Key Components:
+               - MP3STREAM : A parser that is fed the stream in chunks of
+                             any size, down to one byte, and remembers where
+                             it stopped. It never seeks and never reads: the
+                             caller owns the input.
+
+              Parser States:
+               stream_header : collecting the 10 byte tag header
+               stream_body   : collecting the tag body (size bytes)
+               stream_audio  : the tag is complete (or there is none), the
+                               rest of the stream is audio and is not looked at
+               stream_failed : the tag is broken or larger than the limit
+
+              Filter Workflow:
+               1. User runs "./a.out -e -t "title" [-a "artist" ...] - < in.mp3 > out.mp3".
+               2. stdin is read in STREAM_CHUNK_SIZE chunks into the parser
+                  until the tag is complete.
+               3. The frames are rebuilt with the edits (see mp3edit.h) and
+                  the new header and tag go to stdout; a tag that grew gets
+                  ID3_GROW_PADDING bytes of padding, one that did not keeps
+                  its size.
+               4. The rest of the stream is passed on as it comes.
+
+              Notes:
+               - Memory is the tag, its rebuilt copy and one chunk, however
+                 long the audio is; tags over STREAM_TAG_LIMIT are refused.
+               - The audio is moved with splice() when stdin or stdout is a
+                 pipe, so it never enters user memory, else with read/write.
+               - The tag must be at the start of the stream. A stream with
+                 no tag or a tag that cannot be edited is an error and
+                 nothing is written, like an edit of a file.
+               - "./a.out -v -" shows the tags of stdin; only the tag is
+                 read, so the duration and bitrate stay empty.
+*/
+#ifndef mp3stream_h
+#define mp3stream_h
+#include <stddef.h>
+#include "types.h"
+#include "id3tag.h"
+#include "arena.h"
+#include "mp3edit.h"
+
+#define STREAM_CHUNK_SIZE 65536                  // bytes read from the stream at a time
+#define STREAM_TAG_LIMIT (64 * 1024 * 1024)      // largest tag body buffered
+#define STREAM_SPLICE_SIZE (1024 * 1024)         // bytes moved by one splice()
+
+typedef enum
+{
+	stream_header,
+	stream_body,
+	stream_audio,
+	stream_failed
+}StreamState;
+
+typedef struct mp3stream
+{
+	StreamState state;
+	ID3TAG id3tag;               // header, then the body once it is complete (from the arena)
+	unsigned int have;           // bytes of the header or of the body received so far
+	int tagged;                  // the stream starts with a tag
+	unsigned int limit;          // largest tag body accepted
+	const char *error;           // reason of stream_failed
+}MP3STREAM;
+
+//Function to set up a parser at the start of a stream;
+void stream_init(MP3STREAM *stream, ARENA *arena, unsigned int limit);
+
+//Function to feed one chunk, returns the bytes taken (the rest of the chunk is audio);
+size_t stream_feed(MP3STREAM *stream, const unsigned char *data, size_t length);
+
+//Function to tell the parser the stream has ended;
+void stream_finish(MP3STREAM *stream);
+
+//Function to read a stream until its tag is parsed, chunk[*start, *end) is the audio read with it;
+status stream_read_tag(MP3STREAM *stream, int fd, unsigned char *chunk, size_t *start, size_t *end);
+
+//Function to apply the edits to the stream on in_fd and write it to out_fd in one pass;
+status stream_edit(MP3EDIT *mp3edit, int in_fd, int out_fd);
+
+#endif
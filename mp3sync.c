@@ -0,0 +1,203 @@
+/*
+File        : mp3sync.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the marker and frame sync scanner.
+
+              This file contains the function definitions required to:
+               - Scan for ID3/3DI markers and frame sync words with SSE2
+                 (16 positions per step) or AVX2 (32 positions per step)
+               - Pick the AVX2 version once at run time
+               - Fall back to memchr() based scalar code elsewhere
+
+              Every vector step compares the bytes at i, i + 1 and i + 2
+              at once and turns the result into a bit mask, the lowest set
+              bit is the first match. The last few positions that do not
+              fill a whole vector are checked by the scalar code.
+*/
+#include <string.h>
+#include "mp3sync.h"
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define SYNC_X86 1
+#include <immintrin.h>
+#endif
+
+//Function to check for a marker at one position;
+static int is_id3_marker(const unsigned char *ptr)
+{
+    return ptr[1] == 'D' && ((ptr[0] == 'I' && ptr[2] == '3') || (ptr[0] == '3' && ptr[2] == 'I'));
+}
+
+//Function to check for a frame sync at one position;
+static int is_frame_sync(const unsigned char *ptr)
+{
+    return ptr[0] == 0xFF && (ptr[1] & 0xE0) == 0xE0;
+}
+
+/* Function to find a marker from start on without vectors; both markers
+   have 'D' in the middle, so memchr() skips to the candidates */
+static size_t find_id3_scalar(const unsigned char *buffer, size_t start, size_t length)
+{
+    if(length < 3)
+    {
+        return length;
+    }
+    size_t i = start + 1;      // position of the 'D'
+    while(i + 1 < length)
+    {
+        const unsigned char *ptr = memchr(buffer + i, 'D', length - 1 - i);
+        if(ptr == NULL)
+        {
+            break;
+        }
+        i = ptr - buffer;
+        if(is_id3_marker(ptr - 1))
+        {
+            return i - 1;
+        }
+        i++;
+    }
+    return length;
+}
+
+//Function to find a frame sync from start on without vectors;
+static size_t find_frame_scalar(const unsigned char *buffer, size_t start, size_t length)
+{
+    size_t i = start;
+    while(i + 1 < length)
+    {
+        const unsigned char *ptr = memchr(buffer + i, 0xFF, length - 1 - i);
+        if(ptr == NULL)
+        {
+            break;
+        }
+        i = ptr - buffer;
+        if(is_frame_sync(ptr))
+        {
+            return i;
+        }
+        i++;
+    }
+    return length;
+}
+
+#ifdef SYNC_X86
+
+static size_t find_id3_sse2(const unsigned char *buffer, size_t length)
+{
+    const __m128i I = _mm_set1_epi8('I'), D = _mm_set1_epi8('D'), three = _mm_set1_epi8('3');
+    size_t i = 0;
+
+    for(; i + 18 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buffer + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buffer + i + 1));
+        __m128i c = _mm_loadu_si128((const __m128i *)(buffer + i + 2));
+        __m128i d = _mm_cmpeq_epi8(b, D);
+        __m128i header = _mm_and_si128(_mm_cmpeq_epi8(a, I), _mm_cmpeq_epi8(c, three));
+        __m128i footer = _mm_and_si128(_mm_cmpeq_epi8(a, three), _mm_cmpeq_epi8(c, I));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(d, _mm_or_si128(header, footer)));
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return find_id3_scalar(buffer, i, length);
+}
+
+static size_t find_frame_sse2(const unsigned char *buffer, size_t length)
+{
+    const __m128i ff = _mm_set1_epi8((char)0xFF), e0 = _mm_set1_epi8((char)0xE0);
+    size_t i = 0;
+
+    for(; i + 17 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buffer + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buffer + i + 1));
+        __m128i sync = _mm_and_si128(_mm_cmpeq_epi8(a, ff), _mm_cmpeq_epi8(_mm_and_si128(b, e0), e0));
+        unsigned int mask = _mm_movemask_epi8(sync);
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return find_frame_scalar(buffer, i, length);
+}
+
+__attribute__((target("avx2")))
+static size_t find_id3_avx2(const unsigned char *buffer, size_t length)
+{
+    const __m256i I = _mm256_set1_epi8('I'), D = _mm256_set1_epi8('D'), three = _mm256_set1_epi8('3');
+    size_t i = 0;
+
+    for(; i + 34 <= length; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(buffer + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(buffer + i + 1));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(buffer + i + 2));
+        __m256i d = _mm256_cmpeq_epi8(b, D);
+        __m256i header = _mm256_and_si256(_mm256_cmpeq_epi8(a, I), _mm256_cmpeq_epi8(c, three));
+        __m256i footer = _mm256_and_si256(_mm256_cmpeq_epi8(a, three), _mm256_cmpeq_epi8(c, I));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_and_si256(d, _mm256_or_si256(header, footer)));
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return find_id3_scalar(buffer, i, length);
+}
+
+__attribute__((target("avx2")))
+static size_t find_frame_avx2(const unsigned char *buffer, size_t length)
+{
+    const __m256i ff = _mm256_set1_epi8((char)0xFF), e0 = _mm256_set1_epi8((char)0xE0);
+    size_t i = 0;
+
+    for(; i + 33 <= length; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(buffer + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(buffer + i + 1));
+        __m256i sync = _mm256_and_si256(_mm256_cmpeq_epi8(a, ff), _mm256_cmpeq_epi8(_mm256_and_si256(b, e0), e0));
+        unsigned int mask = _mm256_movemask_epi8(sync);
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return find_frame_scalar(buffer, i, length);
+}
+
+//Function to check once whether the CPU has AVX2;
+static int have_avx2(void)
+{
+    static int avx2 = -1;
+    if(__atomic_load_n(&avx2, __ATOMIC_RELAXED) < 0)
+    {
+        __builtin_cpu_init();
+        __atomic_store_n(&avx2, __builtin_cpu_supports("avx2") ? 1 : 0, __ATOMIC_RELAXED);
+    }
+    return __atomic_load_n(&avx2, __ATOMIC_RELAXED);
+}
+
+#endif
+
+//Function to find the first "ID3" or "3DI" marker;
+size_t sync_find_id3(const unsigned char *buffer, size_t length)
+{
+#ifdef SYNC_X86
+    return have_avx2() ? find_id3_avx2(buffer, length) : find_id3_sse2(buffer, length);
+#else
+    return find_id3_scalar(buffer, 0, length);
+#endif
+}
+
+//Function to find the first MPEG audio frame sync;
+size_t sync_find_frame(const unsigned char *buffer, size_t length)
+{
+#ifdef SYNC_X86
+    return have_avx2() ? find_frame_avx2(buffer, length) : find_frame_sse2(buffer, length);
+#else
+    return find_frame_scalar(buffer, 0, length);
+#endif
+}
@@ -0,0 +1,38 @@
+/*
+File        : mp3sync.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the vectorized marker and frame sync scanner.
+
+              Key Components:
+               - sync_find_id3()   : First "ID3" (ID3v2 header) or "3DI"
+                                     (ID3v2.4 footer) marker in a buffer.
+               - sync_find_frame() : First MPEG audio frame sync, a 0xFF
+                                     byte followed by a byte with its top
+                                     three bits set (0xFFEx / 0xFFFx).
+
+              Both functions test 32 (AVX2) or 16 (SSE2) positions per
+              step with unaligned loads at offsets 0, 1 and 2, so a match
+              is found without looking at the buffer byte by byte. The
+              AVX2 version is picked at run time when the CPU has it; on
+              other architectures a scalar version built on memchr() is
+              used.
+
+              Notes:
+               - Both return the offset of the match, or length when there
+                 is none, so a caller can continue after a false positive
+                 with buffer + offset + 1.
+               - A match is only a candidate: callers still check the
+                 header behind it (see id3_valid_header()).
+*/
+#ifndef mp3sync_h
+#define mp3sync_h
+#include <stddef.h>
+
+//Function to find the first "ID3" or "3DI" marker;
+size_t sync_find_id3(const unsigned char *buffer, size_t length);
+
+//Function to find the first MPEG audio frame sync;
+size_t sync_find_frame(const unsigned char *buffer, size_t length);
+
+#endif
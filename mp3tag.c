@@ -0,0 +1,277 @@
+/*
+File        : mp3tag.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file of libmp3tag, the embeddable tag library.
+
+              This file contains the function definitions required to:
+               - Keep all state of one file in an MP3TAG context
+               - Parse a tag through the same steps as Mp3View() and map
+                 every failure to an mp3tag_error code
+               - Look up any frame through the frame table
+               - Queue frame changes and apply them with edit_tag_data()
+
+              Notes:
+               - No function in this file prints anything.
+               - The library never writes to a fixed file name; a tag that
+                 has to grow is rebuilt next to the original file.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3edit.h"
+#include "mp3tag.h"
+#include "id3frames.h"
+
+struct mp3tag
+{
+	char *path;                 // file of this context
+	MP3VIEW mp3view;            // parsed tag (file, mapping, frame table)
+	int parsed;                 // mp3view holds a valid parse
+	MP3EDIT mp3edit;            // queued frame changes
+	char *values[MAX_EDITS];    // copies of the queued values, same order as the edits
+};
+
+//Function to create a context for a file;
+mp3tag_error mp3tag_open(MP3TAG **ctx, const char *path)
+{
+    if(ctx == NULL || path == NULL)
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    *ctx = calloc(1, sizeof(MP3TAG));
+    if(*ctx == NULL)
+    {
+        return MP3TAG_ERR_NOMEM;
+    }
+    (*ctx) -> path = strdup(path);
+    if((*ctx) -> path == NULL)
+    {
+        free(*ctx);
+        *ctx = NULL;
+        return MP3TAG_ERR_NOMEM;
+    }
+    return MP3TAG_OK;
+}
+
+//Function to drop the current parse;
+static void mp3tag_unparse(MP3TAG *ctx)
+{
+    if(ctx -> parsed || ctx -> mp3view.fptr_sample_mp3 != NULL)
+    {
+        close_mp3file(&ctx -> mp3view);
+    }
+    ctx -> parsed = 0;
+}
+
+//Function to read and index the tag of the file;
+mp3tag_error mp3tag_parse(MP3TAG *ctx)
+{
+    if(ctx == NULL)
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    mp3tag_unparse(ctx);
+
+    // the steps of parse_mp3file(), each one with its own error code
+    MP3VIEW *mp3view = &ctx -> mp3view;
+    memset(mp3view, 0, sizeof(*mp3view));
+    mp3view -> sample_mp3_fname = ctx -> path;
+    mp3view -> arena = &mp3view -> own_arena;
+    mp3view -> id3tag.arena = mp3view -> arena;
+
+    mp3tag_error error = MP3TAG_OK;
+    if(open_mp3file(mp3view) != E_SUCCESS)
+    {
+        return MP3TAG_ERR_OPEN;
+    }
+    if(check_for_ID3(mp3view) != E_SUCCESS)
+    {
+        error = MP3TAG_ERR_NO_TAG;
+    }
+    else if(check_for_version(mp3view) != E_SUCCESS)
+    {
+        error = MP3TAG_ERR_VERSION;
+    }
+    else if(read_tag_info(mp3view) != E_SUCCESS)
+    {
+        error = MP3TAG_ERR_READ;
+    }
+    if(error != MP3TAG_OK)
+    {
+        close_mp3file(mp3view);
+        return error;
+    }
+    ctx -> parsed = 1;
+    return MP3TAG_OK;
+}
+
+//Function to get the value of a frame (first one if it appears more than once);
+mp3tag_error mp3tag_get_frame(MP3TAG *ctx, const char *id, const char **value, size_t *length)
+{
+    if(ctx == NULL || id == NULL || strlen(id) != 4 || value == NULL || length == NULL)
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    if(!ctx -> parsed)
+    {
+        return MP3TAG_ERR_NOT_PARSED;
+    }
+    const ID3FRAME *frame = id3_find_frame(&ctx -> mp3view.frametable, frame_id((const unsigned char *)id));
+    if(frame == NULL)
+    {
+        return MP3TAG_ERR_NOT_FOUND;
+    }
+    if(id[0] == 'T')
+    {
+        // text frames are returned as UTF-8, converted into the context arena when needed
+        MP3VIEWINFO info;
+        if(decode_frame_text(&ctx -> mp3view, &info, frame) != E_SUCCESS)
+        {
+            return MP3TAG_ERR_NOMEM;
+        }
+        *value = info.text != NULL ? info.text : (const char *)ctx -> mp3view.id3tag.buffer + info.offset;
+        *length = info.length;
+        return MP3TAG_OK;
+    }
+    *value = (const char *)ctx -> mp3view.id3tag.buffer + frame -> offset + FRAME_HEADER_SIZE;
+    *length = frame -> size;
+    return MP3TAG_OK;
+}
+
+//Function to queue a new value for a frame; nothing is written before commit;
+mp3tag_error mp3tag_set_frame(MP3TAG *ctx, const char *id, const char *value, size_t length)
+{
+    char tag[5];
+    unsigned int i;
+
+    if(ctx == NULL || id == NULL || strlen(id) != 4 || (value == NULL && length > 0))
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    memcpy(tag, id, 5);
+    unsigned int value_id = frame_id((const unsigned char *)tag);
+    // the value is stored as text, a binary or URL frame would be corrupted
+    if(!frame_is_editable(value_id))
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    for(i = 0; i < ctx -> mp3edit.count; i++)
+    {
+        if(ctx -> mp3edit.edits[i].id == value_id)
+        {
+            break;
+        }
+    }
+    if(i == MAX_EDITS)
+    {
+        return MP3TAG_ERR_TOO_MANY;
+    }
+
+    char *copy = malloc(length + 1);
+    if(copy == NULL)
+    {
+        return MP3TAG_ERR_NOMEM;
+    }
+    memcpy(copy, value, length);
+    copy[length] = '\0';
+    if(add_frame_edit(&ctx -> mp3edit, tag, copy) != E_SUCCESS)
+    {
+        free(copy);
+        return MP3TAG_ERR_TOO_MANY;
+    }
+    ctx -> mp3edit.edits[i].size = length;   // value may hold NUL bytes
+    free(ctx -> values[i]);
+    ctx -> values[i] = copy;
+    return MP3TAG_OK;
+}
+
+//Function to forget all queued values;
+static void mp3tag_clear_edits(MP3TAG *ctx)
+{
+    unsigned int i;
+    for(i = 0; i < MAX_EDITS; i++)
+    {
+        free(ctx -> values[i]);
+        ctx -> values[i] = NULL;
+    }
+    memset(&ctx -> mp3edit, 0, sizeof(ctx -> mp3edit));
+}
+
+//Function to write all queued values with a single update of the file;
+mp3tag_error mp3tag_commit(MP3TAG *ctx)
+{
+    unsigned int i;
+
+    if(ctx == NULL)
+    {
+        return MP3TAG_ERR_ARGS;
+    }
+    if(ctx -> mp3edit.count == 0)
+    {
+        return MP3TAG_OK;
+    }
+    // the parse describes the old file contents
+    mp3tag_unparse(ctx);
+
+    MP3EDIT *mp3edit = &ctx -> mp3edit;
+    mp3edit -> input_file = ctx -> path;
+    mp3edit -> arena = NULL;
+
+    mp3tag_error error = MP3TAG_OK;
+    if(open_files(mp3edit) != E_SUCCESS)
+    {
+        error = MP3TAG_ERR_OPEN;
+    }
+    else if(edit_tag_data(mp3edit) != E_SUCCESS)
+    {
+        error = MP3TAG_ERR_WRITE;
+    }
+    else
+    {
+        for(i = 0; i < mp3edit -> count; i++)
+        {
+            if(!mp3edit -> edits[i].found)
+            {
+                error = MP3TAG_ERR_NOT_FOUND;
+            }
+        }
+    }
+    mp3tag_clear_edits(ctx);
+    return error;
+}
+
+//Function to release the context;
+void mp3tag_close(MP3TAG *ctx)
+{
+    if(ctx == NULL)
+    {
+        return;
+    }
+    mp3tag_unparse(ctx);
+    mp3tag_clear_edits(ctx);
+    free(ctx -> path);
+    free(ctx);
+}
+
+//Function to describe an error code;
+const char *mp3tag_strerror(mp3tag_error error)
+{
+    switch(error)
+    {
+        case MP3TAG_OK:             return "Success";
+        case MP3TAG_ERR_ARGS:       return "Invalid argument";
+        case MP3TAG_ERR_NOMEM:      return "Out of memory";
+        case MP3TAG_ERR_OPEN:       return "Unable to open the file";
+        case MP3TAG_ERR_NO_TAG:     return "ID3 was not found in the file";
+        case MP3TAG_ERR_VERSION:    return "the correct version was not found";
+        case MP3TAG_ERR_READ:       return "Unable to read the tag";
+        case MP3TAG_ERR_NOT_PARSED: return "The tag was not parsed";
+        case MP3TAG_ERR_NOT_FOUND:  return "Frame not found";
+        case MP3TAG_ERR_TOO_MANY:   return "Too many frame changes";
+        case MP3TAG_ERR_WRITE:      return "Unable to update the file";
+    }
+    return "Unknown error";
+}
@@ -0,0 +1,86 @@
+/*
+File        : mp3tag.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Public header of libmp3tag, the embeddable tag library.
+
+              This header is all a program needs to read and edit ID3v2.3
+              tags in-process instead of running "./a.out" per file. The
+              same parsing and editing code as the command line tool is
+              used underneath (mp3view.c, mp3edit.c, id3tag.c).
+
+              Key Components:
+               - MP3TAG      : Opaque context for one file. Everything the
+                               library needs lives in it, so any number of
+                               threads can work at the same time as long
+                               as each context is used by one thread.
+               - mp3tag_error: Result of every call; nothing is printed.
+
+              Typical Use:
+                  MP3TAG *ctx;
+                  if(mp3tag_open(&ctx, "song.mp3") == MP3TAG_OK &&
+                     mp3tag_parse(ctx) == MP3TAG_OK)
+                  {
+                      const char *title; size_t length;
+                      if(mp3tag_get_frame(ctx, "TIT2", &title, &length) == MP3TAG_OK)
+                          ...
+                      mp3tag_set_frame(ctx, "TPE1", "Artist", 6);
+                      mp3tag_commit(ctx);
+                  }
+                  mp3tag_close(ctx);
+
+              Notes:
+               - Values returned by mp3tag_get_frame() point into the
+                 context and stay valid until the next parse, commit or
+                 close; they are not NUL terminated.
+               - Text frames (ids starting with 'T') are returned as
+                 UTF-8 whatever their encoding, and mp3tag_set_frame()
+                 takes UTF-8; other frames are returned as stored.
+               - mp3tag_set_frame() only sets text frames (T*** but TXXX)
+                 and comments (COMM, USLT); any other id, e.g. APIC,
+                 gives MP3TAG_ERR_ARGS and the frame is left alone.
+               - Link with -lmp3tag -pthread.
+*/
+#ifndef mp3tag_h
+#define mp3tag_h
+#include <stddef.h>
+
+typedef struct mp3tag MP3TAG;
+
+typedef enum
+{
+	MP3TAG_OK = 0,
+	MP3TAG_ERR_ARGS,          // invalid argument
+	MP3TAG_ERR_NOMEM,         // out of memory
+	MP3TAG_ERR_OPEN,          // file could not be opened
+	MP3TAG_ERR_NO_TAG,        // no ID3v2 tag at the start of the file
+	MP3TAG_ERR_VERSION,       // tag is not ID3v2.3
+	MP3TAG_ERR_READ,          // tag could not be read
+	MP3TAG_ERR_NOT_PARSED,    // mp3tag_parse() was not called
+	MP3TAG_ERR_NOT_FOUND,     // frame is not in the tag
+	MP3TAG_ERR_TOO_MANY,      // too many pending frame changes
+	MP3TAG_ERR_WRITE          // the file could not be updated
+}mp3tag_error;
+
+//Function to create a context for a file;
+mp3tag_error mp3tag_open(MP3TAG **ctx, const char *path);
+
+//Function to read and index the tag of the file;
+mp3tag_error mp3tag_parse(MP3TAG *ctx);
+
+//Function to get the value of a frame (first one if it appears more than once);
+mp3tag_error mp3tag_get_frame(MP3TAG *ctx, const char *id, const char **value, size_t *length);
+
+//Function to queue a new value for a frame; nothing is written before commit;
+mp3tag_error mp3tag_set_frame(MP3TAG *ctx, const char *id, const char *value, size_t length);
+
+//Function to write all queued values with a single update of the file;
+mp3tag_error mp3tag_commit(MP3TAG *ctx);
+
+//Function to release the context;
+void mp3tag_close(MP3TAG *ctx);
+
+//Function to describe an error code;
+const char *mp3tag_strerror(mp3tag_error error);
+
+#endif
@@ -0,0 +1,359 @@
+/*
+File        : mp3text.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for text frame encoding conversion.
+
+              This file contains the function definitions required to:
+               - Convert ISO-8859-1, UTF-16 (with byte order mark) and
+                 UTF-16BE frame text to UTF-8
+               - Convert UTF-8 back into ISO-8859-1 or UTF-16
+               - Skip a terminated string (e.g. a COMM description)
+
+              Each conversion runs an SSE2 block loop over the ASCII
+              parts and falls back to a one character step function for
+              the rest; both produce the same output.
+*/
+#include <string.h>
+#include "mp3text.h"
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define TEXT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define REPLACEMENT_CHAR 0xFFFD
+
+//Function to write one code point as UTF-8;
+static size_t put_utf8(unsigned int cp, unsigned char *dst)
+{
+    if(cp < 0x80)
+    {
+        dst[0] = cp;
+        return 1;
+    }
+    if(cp < 0x800)
+    {
+        dst[0] = 0xC0 | cp >> 6;
+        dst[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    }
+    if(cp < 0x10000)
+    {
+        dst[0] = 0xE0 | cp >> 12;
+        dst[1] = 0x80 | ((cp >> 6) & 0x3F);
+        dst[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+    dst[0] = 0xF0 | cp >> 18;
+    dst[1] = 0x80 | ((cp >> 12) & 0x3F);
+    dst[2] = 0x80 | ((cp >> 6) & 0x3F);
+    dst[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+/* Function to read one code point from UTF-8; a byte that does not start
+   a valid sequence is taken as an ISO-8859-1 character of its own */
+static unsigned int get_utf8(const unsigned char *src, size_t length, size_t *used)
+{
+    unsigned int cp = src[0];
+    size_t need = cp >= 0xF0 && cp < 0xF5 ? 3 : cp >= 0xE0 ? 2 : cp >= 0xC2 ? 1 : 0;
+    size_t i;
+
+    *used = 1;
+    if(cp < 0x80 || need == 0 || need >= length || cp > 0xF4)
+    {
+        return cp;
+    }
+    unsigned int value = cp & (0x3F >> need);
+    for(i = 1; i <= need; i++)
+    {
+        if((src[i] & 0xC0) != 0x80)
+        {
+            return cp;
+        }
+        value = value << 6 | (src[i] & 0x3F);
+    }
+    // overlong forms, surrogates and values past U+10FFFF are not valid
+    if((need == 2 && value < 0x800) || (need == 3 && (value < 0x10000 || value > 0x10FFFF)) ||
+       (value >= 0xD800 && value <= 0xDFFF))
+    {
+        return cp;
+    }
+    *used = need + 1;
+    return value;
+}
+
+//Function to read one UTF-16 unit;
+static unsigned int get_unit(const unsigned char *src, int big_endian)
+{
+    return big_endian ? (unsigned int)src[0] << 8 | src[1] : (unsigned int)src[1] << 8 | src[0];
+}
+
+//Function to write one UTF-16 unit;
+static void put_unit(unsigned int unit, unsigned char *dst, int big_endian)
+{
+    dst[big_endian ? 0 : 1] = unit >> 8;
+    dst[big_endian ? 1 : 0] = unit & 0xFF;
+}
+
+//Function to check whether a text is plain ASCII (nothing to convert);
+int text_is_ascii(const unsigned char *src, size_t length)
+{
+    size_t i = 0;
+#ifdef TEXT_SSE2
+    for(; i + 16 <= length; i += 16)
+    {
+        if(_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(src + i))) != 0)
+        {
+            return 0;
+        }
+    }
+#endif
+    for(; i < length; i++)
+    {
+        if(src[i] & 0x80)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+//Function to convert ISO-8859-1 to UTF-8 up to the first NUL;
+static size_t latin1_to_utf8(const unsigned char *src, size_t length, unsigned char *dst)
+{
+    size_t i = 0, out = 0;
+    while(i < length)
+    {
+#ifdef TEXT_SSE2
+        if(i + 16 <= length)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            int special = _mm_movemask_epi8(v) | _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+            if(special == 0)
+            {
+                // 16 ASCII characters: copied as they are
+                _mm_storeu_si128((__m128i *)(dst + out), v);
+                i += 16;
+                out += 16;
+                continue;
+            }
+        }
+#endif
+        if(src[i] == 0)
+        {
+            break;
+        }
+        out += put_utf8(src[i], dst + out);
+        i++;
+    }
+    return out;
+}
+
+//Function to convert UTF-16 units to UTF-8 up to the first NUL unit;
+static size_t utf16_to_utf8(const unsigned char *src, size_t length, int big_endian, unsigned char *dst)
+{
+    size_t i = 0, out = 0;
+    length &= ~(size_t)1;
+    while(i < length)
+    {
+#ifdef TEXT_SSE2
+        if(i + 16 <= length)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            if(big_endian)
+            {
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            }
+            __m128i zero = _mm_setzero_si128();
+            __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xFF80)), zero);
+            __m128i nul = _mm_cmpeq_epi16(v, zero);
+            if(_mm_movemask_epi8(ascii) == 0xFFFF && _mm_movemask_epi8(nul) == 0)
+            {
+                // 8 ASCII units: narrowed to 8 bytes
+                _mm_storel_epi64((__m128i *)(dst + out), _mm_packus_epi16(v, v));
+                i += 16;
+                out += 8;
+                continue;
+            }
+        }
+#endif
+        unsigned int unit = get_unit(src + i, big_endian);
+        i += 2;
+        if(unit == 0)
+        {
+            break;
+        }
+        if(unit >= 0xD800 && unit <= 0xDBFF && i + 2 <= length)
+        {
+            unsigned int low = get_unit(src + i, big_endian);
+            if(low >= 0xDC00 && low <= 0xDFFF)
+            {
+                unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                i += 2;
+            }
+        }
+        if(unit >= 0xD800 && unit <= 0xDFFF)
+        {
+            unit = REPLACEMENT_CHAR;     // lone surrogate
+        }
+        out += put_utf8(unit, dst + out);
+    }
+    return out;
+}
+
+//Function to convert frame text to UTF-8, stopping at the terminator; returns the UTF-8 length;
+size_t text_to_utf8(unsigned int encoding, const unsigned char *src, size_t length, unsigned char *dst)
+{
+    switch(encoding)
+    {
+        case TEXT_UTF16:
+            // the byte order mark decides, little endian when it is missing
+            if(length >= 2 && src[0] == 0xFE && src[1] == 0xFF)
+            {
+                return utf16_to_utf8(src + 2, length - 2, 1, dst);
+            }
+            if(length >= 2 && src[0] == 0xFF && src[1] == 0xFE)
+            {
+                return utf16_to_utf8(src + 2, length - 2, 0, dst);
+            }
+            return utf16_to_utf8(src, length, 0, dst);
+        case TEXT_UTF16BE:
+            return utf16_to_utf8(src, length, 1, dst);
+        case TEXT_UTF8:
+        {
+            const unsigned char *end = memchr(src, 0, length);
+            size_t used = end ? (size_t)(end - src) : length;
+            memcpy(dst, src, used);
+            return used;
+        }
+        default:
+            return latin1_to_utf8(src, length, dst);
+    }
+}
+
+//Function to get the bytes taken by a terminated string (terminator included);
+size_t text_string_end(unsigned int encoding, const unsigned char *src, size_t length)
+{
+    size_t i;
+    if(encoding == TEXT_UTF16 || encoding == TEXT_UTF16BE)
+    {
+        for(i = 0; i + 1 < length; i += 2)
+        {
+            if(src[i] == 0 && src[i + 1] == 0)
+            {
+                return i + 2;
+            }
+        }
+        return length;
+    }
+    const unsigned char *end = memchr(src, 0, length);
+    return end ? (size_t)(end - src) + 1 : length;
+}
+
+//Function to pick the encoding a UTF-8 text is stored with in a frame of the given encoding;
+unsigned int text_pick_encoding(unsigned int encoding, const unsigned char *utf8, size_t length)
+{
+    size_t i = 0, used;
+    if(encoding != TEXT_LATIN1 || text_is_ascii(utf8, length))
+    {
+        return encoding > TEXT_UTF8 ? TEXT_LATIN1 : encoding;
+    }
+    while(i < length)
+    {
+        if(get_utf8(utf8 + i, length - i, &used) > 0xFF)
+        {
+            return TEXT_UTF16;      // does not fit into ISO-8859-1
+        }
+        i += used;
+    }
+    return TEXT_LATIN1;
+}
+
+//Function to convert UTF-8 to ISO-8859-1 (callers checked that it fits);
+static size_t utf8_to_latin1(const unsigned char *src, size_t length, unsigned char *dst)
+{
+    size_t i = 0, out = 0, used;
+    while(i < length)
+    {
+#ifdef TEXT_SSE2
+        if(i + 16 <= length)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            if(_mm_movemask_epi8(v) == 0)
+            {
+                _mm_storeu_si128((__m128i *)(dst + out), v);
+                i += 16;
+                out += 16;
+                continue;
+            }
+        }
+#endif
+        unsigned int cp = get_utf8(src + i, length - i, &used);
+        dst[out++] = cp > 0xFF ? '?' : cp;
+        i += used;
+    }
+    return out;
+}
+
+//Function to convert UTF-8 to UTF-16 units;
+static size_t utf8_to_utf16(const unsigned char *src, size_t length, int big_endian, unsigned char *dst)
+{
+    size_t i = 0, out = 0, used;
+    while(i < length)
+    {
+#ifdef TEXT_SSE2
+        if(i + 16 <= length)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            if(_mm_movemask_epi8(v) == 0)
+            {
+                // 16 ASCII bytes: widened to 16 units
+                __m128i zero = _mm_setzero_si128();
+                __m128i low = big_endian ? _mm_unpacklo_epi8(zero, v) : _mm_unpacklo_epi8(v, zero);
+                __m128i high = big_endian ? _mm_unpackhi_epi8(zero, v) : _mm_unpackhi_epi8(v, zero);
+                _mm_storeu_si128((__m128i *)(dst + out), low);
+                _mm_storeu_si128((__m128i *)(dst + out + 16), high);
+                i += 16;
+                out += 32;
+                continue;
+            }
+        }
+#endif
+        unsigned int cp = get_utf8(src + i, length - i, &used);
+        i += used;
+        if(cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            put_unit(0xD800 + (cp >> 10), dst + out, big_endian);
+            put_unit(0xDC00 + (cp & 0x3FF), dst + out + 2, big_endian);
+            out += 4;
+        }
+        else
+        {
+            put_unit(cp, dst + out, big_endian);
+            out += 2;
+        }
+    }
+    return out;
+}
+
+//Function to convert UTF-8 into a frame encoding (UTF-16 gets a byte order mark); returns the length;
+size_t text_from_utf8(unsigned int encoding, const unsigned char *src, size_t length, unsigned char *dst)
+{
+    switch(encoding)
+    {
+        case TEXT_UTF16:
+            dst[0] = 0xFF;        // little endian byte order mark
+            dst[1] = 0xFE;
+            return 2 + utf8_to_utf16(src, length, 0, dst + 2);
+        case TEXT_UTF16BE:
+            return utf8_to_utf16(src, length, 1, dst);
+        case TEXT_UTF8:
+            memcpy(dst, src, length);
+            return length;
+        default:
+            return utf8_to_latin1(src, length, dst);
+    }
+}
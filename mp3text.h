@@ -0,0 +1,60 @@
+/*
+File        : mp3text.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for text frame encoding conversion.
+
+              Every ID3v2 text frame starts with one encoding byte:
+               0 : ISO-8859-1
+               1 : UTF-16 with a byte order mark (FF FE or FE FF)
+               2 : UTF-16BE without a byte order mark (ID3v2.4)
+               3 : UTF-8 (ID3v2.4)
+
+              Key Components:
+               - text_to_utf8()   : Frame text in any encoding to UTF-8,
+                                    up to the first terminator.
+               - text_from_utf8() : UTF-8 (command line, manifests) back
+                                    into the encoding of a frame.
+               - text_pick_encoding() : Keeps ISO-8859-1 when the new
+                                    text fits into it, otherwise UTF-16.
+
+              The ASCII parts of a text, which is most of it even in
+              non-English libraries (digits, spaces, Latin letters), are
+              converted 16 bytes or 8 UTF-16 units at a time with SSE2
+              (widening with unpack, narrowing with packus, byte swapping
+              for big endian); only blocks with other characters go
+              through the scalar code. Other architectures use the scalar
+              code only.
+
+              Buffer sizes:
+               - text_to_utf8()   needs TEXT_MAX_UTF8(length) bytes
+               - text_from_utf8() needs TEXT_MAX_ENCODED(length) bytes
+*/
+#ifndef mp3text_h
+#define mp3text_h
+#include <stddef.h>
+
+#define TEXT_LATIN1   0
+#define TEXT_UTF16    1
+#define TEXT_UTF16BE  2
+#define TEXT_UTF8     3
+
+#define TEXT_MAX_UTF8(length) (2 * (length))
+#define TEXT_MAX_ENCODED(length) (2 * (length) + 4)
+
+//Function to check whether a text is plain ASCII (nothing to convert);
+int text_is_ascii(const unsigned char *src, size_t length);
+
+//Function to convert frame text to UTF-8, stopping at the terminator; returns the UTF-8 length;
+size_t text_to_utf8(unsigned int encoding, const unsigned char *src, size_t length, unsigned char *dst);
+
+//Function to get the bytes taken by a terminated string (terminator included);
+size_t text_string_end(unsigned int encoding, const unsigned char *src, size_t length);
+
+//Function to pick the encoding a UTF-8 text is stored with in a frame of the given encoding;
+unsigned int text_pick_encoding(unsigned int encoding, const unsigned char *utf8, size_t length);
+
+//Function to convert UTF-8 into a frame encoding (UTF-16 gets a byte order mark); returns the length;
+size_t text_from_utf8(unsigned int encoding, const unsigned char *src, size_t length, unsigned char *dst);
+
+#endif
@@ -0,0 +1,418 @@
+/*
+File        : mp3uring.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the io_uring based asynchronous
+              tag reader.
+
+              This file contains the function definitions required to:
+               - Set up an io_uring instance and check that the needed
+                 operations (openat, read, close) are supported
+               - Keep up to "depth" files in flight, each one moving
+                 through open -> header read -> body read -> close
+               - Decode the tag size as soon as the header arrives and
+                 chain the body read after it
+               - Index and format the tags with the same code used by
+                 the single file view and the thread pool scan
+
+              Notes:
+               - All files are driven from one thread; the number of
+                 requests in flight is limited by the ring size only.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3scan.h"
+#include "mp3uring.h"
+#include "outbuf.h"
+#include "stats.h"
+
+//Function to set up the rings; fails when io_uring is not usable;
+status uring_init(URING *uring, unsigned int entries)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(uring, 0, sizeof(*uring));
+
+    uring -> fd = syscall(__NR_io_uring_setup, entries, &params);
+    if(uring -> fd < 0)
+    {
+        return E_FAILURE;
+    }
+
+    // every operation of the read chain must be supported by this kernel
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = calloc(1, probe_size);
+    if(probe == NULL || syscall(__NR_io_uring_register, uring -> fd, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+       probe -> last_op < IORING_OP_READ ||
+       !(probe -> ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) ||
+       !(probe -> ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) ||
+       !(probe -> ops[IORING_OP_CLOSE].flags & IO_URING_OP_SUPPORTED))
+    {
+        free(probe);
+        close(uring -> fd);
+        return E_FAILURE;
+    }
+    free(probe);
+
+    uring -> sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    uring -> cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if(uring -> cq_ring_size > uring -> sq_ring_size)
+        {
+            uring -> sq_ring_size = uring -> cq_ring_size;
+        }
+        uring -> cq_ring_size = uring -> sq_ring_size;
+    }
+    uring -> sq_ring = mmap(NULL, uring -> sq_ring_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, uring -> fd, IORING_OFF_SQ_RING);
+    if(uring -> sq_ring == MAP_FAILED)
+    {
+        close(uring -> fd);
+        return E_FAILURE;
+    }
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        uring -> cq_ring = uring -> sq_ring;
+    }
+    else
+    {
+        uring -> cq_ring = mmap(NULL, uring -> cq_ring_size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, uring -> fd, IORING_OFF_CQ_RING);
+        if(uring -> cq_ring == MAP_FAILED)
+        {
+            munmap(uring -> sq_ring, uring -> sq_ring_size);
+            close(uring -> fd);
+            return E_FAILURE;
+        }
+    }
+    uring -> sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring -> sqes = mmap(NULL, uring -> sqes_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, uring -> fd, IORING_OFF_SQES);
+    if(uring -> sqes == MAP_FAILED)
+    {
+        if(uring -> cq_ring != uring -> sq_ring)
+        {
+            munmap(uring -> cq_ring, uring -> cq_ring_size);
+        }
+        munmap(uring -> sq_ring, uring -> sq_ring_size);
+        close(uring -> fd);
+        return E_FAILURE;
+    }
+
+    char *sq = uring -> sq_ring, *cq = uring -> cq_ring;
+    uring -> sq_head = (unsigned int *)(sq + params.sq_off.head);
+    uring -> sq_tail = (unsigned int *)(sq + params.sq_off.tail);
+    uring -> sq_mask = (unsigned int *)(sq + params.sq_off.ring_mask);
+    uring -> sq_array = (unsigned int *)(sq + params.sq_off.array);
+    uring -> cq_head = (unsigned int *)(cq + params.cq_off.head);
+    uring -> cq_tail = (unsigned int *)(cq + params.cq_off.tail);
+    uring -> cq_mask = (unsigned int *)(cq + params.cq_off.ring_mask);
+    uring -> cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return E_SUCCESS;
+}
+
+//Function to tear the rings down;
+void uring_exit(URING *uring)
+{
+    munmap(uring -> sqes, uring -> sqes_size);
+    if(uring -> cq_ring != uring -> sq_ring)
+    {
+        munmap(uring -> cq_ring, uring -> cq_ring_size);
+    }
+    munmap(uring -> sq_ring, uring -> sq_ring_size);
+    close(uring -> fd);
+}
+
+//Function to get the next free submission entry;
+static struct io_uring_sqe *uring_get_sqe(URING *uring, unsigned long user_data)
+{
+    unsigned int tail = *uring -> sq_tail;
+    unsigned int index = tail & *uring -> sq_mask;
+    struct io_uring_sqe *sqe = &uring -> sqes[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe -> user_data = user_data;
+    uring -> sq_array[index] = index;
+    // the kernel sees the entry once the tail is published
+    __atomic_store_n(uring -> sq_tail, tail + 1, __ATOMIC_RELEASE);
+    uring -> to_submit++;
+    return sqe;
+}
+
+//Function to queue a read of the missing part of the slot buffer;
+static void queue_read(URING *uring, URINGSLOT *slot, unsigned long id)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(uring, id);
+    sqe -> opcode = IORING_OP_READ;
+    sqe -> fd = slot -> fd;
+    sqe -> addr = (unsigned long)(slot -> buffer + slot -> have);
+    sqe -> len = slot -> want - slot -> have;
+    sqe -> off = slot -> have;
+}
+
+//Function to queue the close of a slot's file;
+static void queue_close(URING *uring, URINGSLOT *slot, unsigned long id)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(uring, id);
+    sqe -> opcode = IORING_OP_CLOSE;
+    sqe -> fd = slot -> fd;
+    slot -> state = slot_close;
+}
+
+//Function to start the next collected file on a free slot;
+static int start_next_file(URING *uring, MP3SCAN *mp3scan, URINGSLOT *slot, unsigned long id)
+{
+    if(mp3scan -> next >= mp3scan -> count)
+    {
+        slot -> state = slot_free;
+        return 0;
+    }
+    memset(&slot -> mp3view, 0, sizeof(slot -> mp3view));
+    arena_reset(&slot -> arena);
+    slot -> mp3view.arena = &slot -> arena;
+    slot -> mp3view.sample_mp3_fname = mp3scan -> files[mp3scan -> next++];
+    slot -> fd = -1;
+    slot -> have = 0;
+    slot -> state = slot_open;
+
+    struct io_uring_sqe *sqe = uring_get_sqe(uring, id);
+    sqe -> opcode = IORING_OP_OPENAT;
+    sqe -> fd = AT_FDCWD;
+    sqe -> addr = (unsigned long)slot -> mp3view.sample_mp3_fname;
+    sqe -> open_flags = O_RDONLY | O_CLOEXEC;
+    return 1;
+}
+
+//Function to record a failed file and close it if it was opened;
+static void fail_slot(URING *uring, MP3SCAN *mp3scan, URINGSLOT *slot, unsigned long id,
+                      OUTBUF *outbuf, const char *error)
+{
+    format_error(slot -> mp3view.sample_mp3_fname, error, NULL, outbuf, mp3scan -> format);
+    mp3scan -> failed++;
+    free(slot -> buffer);
+    slot -> buffer = NULL;
+    if(slot -> fd >= 0)
+    {
+        queue_close(uring, slot, id);
+    }
+    else
+    {
+        slot -> state = slot_free;
+    }
+}
+
+//Function to index and print a slot whose tag is complete;
+static void finish_slot(URING *uring, MP3SCAN *mp3scan, URINGSLOT *slot, unsigned long id, OUTBUF *outbuf)
+{
+    MP3VIEW *mp3view = &slot -> mp3view;
+
+    mp3view -> id3tag.buffer = slot -> buffer + ID3_HEADER_SIZE;
+    mp3view -> id3tag.map = NULL;
+    if(check_for_version(mp3view) == E_SUCCESS && id3_parse_layout(&mp3view -> id3tag) == E_SUCCESS &&
+       index_tag_frames(mp3view) == E_SUCCESS)
+    {
+        format_mp3tags(mp3view, outbuf, mp3scan -> format);
+        free(slot -> buffer);
+        slot -> buffer = NULL;
+        queue_close(uring, slot, id);
+    }
+    else
+    {
+        fail_slot(uring, mp3scan, slot, id, outbuf, mp3view -> error ? mp3view -> error : "Invalid tag");
+    }
+    mp3view -> id3tag.buffer = NULL;
+    outbuf_maybe_flush(outbuf);
+}
+
+/* Function to finish a slot whose file does not start with a tag; the
+   tag locator (leading junk, appended tags) reads synchronously, which
+   is fine for these rare files */
+static void locate_slot(URING *uring, MP3SCAN *mp3scan, URINGSLOT *slot, unsigned long id, OUTBUF *outbuf)
+{
+    MP3VIEW *mp3view = &slot -> mp3view;
+    ID3TAG *id3tag = &mp3view -> id3tag;
+
+    free(slot -> buffer);
+    slot -> buffer = NULL;
+    id3tag -> arena = mp3view -> arena;
+    if(id3_read_header(slot -> fd, id3tag) != E_SUCCESS)
+    {
+        fail_slot(uring, mp3scan, slot, id, outbuf, "ID3 was not found in the file");
+        return;
+    }
+    if(check_for_version(mp3view) != E_SUCCESS)
+    {
+        fail_slot(uring, mp3scan, slot, id, outbuf, mp3view -> error);
+        return;
+    }
+    if(id3_map_body(slot -> fd, id3tag) != E_SUCCESS && id3_read_body(slot -> fd, id3tag) != E_SUCCESS)
+    {
+        fail_slot(uring, mp3scan, slot, id, outbuf, "fread function failed to read the data from a file stream");
+        return;
+    }
+    if(index_tag_frames(mp3view) == E_SUCCESS)
+    {
+        format_mp3tags(mp3view, outbuf, mp3scan -> format);
+        queue_close(uring, slot, id);
+    }
+    else
+    {
+        fail_slot(uring, mp3scan, slot, id, outbuf, mp3view -> error);
+    }
+    id3_free_tag(id3tag);
+    outbuf_maybe_flush(outbuf);
+}
+
+//Function to move a slot to its next state when its request completed;
+static void handle_completion(URING *uring, MP3SCAN *mp3scan, URINGSLOT *slot, unsigned long id,
+                              int res, OUTBUF *outbuf)
+{
+    if(res > 0 && (slot -> state == slot_head || slot -> state == slot_body))
+    {
+        STATS_COUNT(stat_bytes_read, res);
+    }
+    switch(slot -> state)
+    {
+        case slot_open:
+            if(res < 0)
+            {
+                fail_slot(uring, mp3scan, slot, id, outbuf, "Error: Unable to open The file");
+                break;
+            }
+            slot -> fd = res;
+            slot -> buffer = malloc(URING_PREFIX);
+            STATS_COUNT(stat_mallocs, 1);
+            if(slot -> buffer == NULL)
+            {
+                fail_slot(uring, mp3scan, slot, id, outbuf, "Out of memory");
+                break;
+            }
+            slot -> want = URING_PREFIX;
+            slot -> state = slot_head;
+            queue_read(uring, slot, id);
+            break;
+
+        case slot_head:
+            if(res < ID3_HEADER_SIZE || !id3_valid_header(slot -> buffer, "ID3"))
+            {
+                locate_slot(uring, mp3scan, slot, id, outbuf);
+                break;
+            }
+            // header is here: decode the size and chain the body read if needed
+            memcpy(slot -> mp3view.id3tag.header, slot -> buffer, ID3_HEADER_SIZE);
+            slot -> mp3view.id3tag.size = bigendian_to_littleendian(slot -> buffer + 6);
+            slot -> have = res;
+            slot -> want = ID3_HEADER_SIZE + slot -> mp3view.id3tag.size;
+            if(slot -> have >= slot -> want)
+            {
+                finish_slot(uring, mp3scan, slot, id, outbuf);
+                break;
+            }
+            unsigned char *buffer = realloc(slot -> buffer, slot -> want);
+            if(buffer == NULL)
+            {
+                fail_slot(uring, mp3scan, slot, id, outbuf, "Out of memory");
+                break;
+            }
+            slot -> buffer = buffer;
+            slot -> state = slot_body;
+            queue_read(uring, slot, id);
+            break;
+
+        case slot_body:
+            if(res <= 0)
+            {
+                fail_slot(uring, mp3scan, slot, id, outbuf, "fread function failed to read the data from a file stream");
+                break;
+            }
+            slot -> have += res;
+            if(slot -> have < slot -> want)
+            {
+                queue_read(uring, slot, id);     // short read, ask for the rest
+            }
+            else
+            {
+                finish_slot(uring, mp3scan, slot, id, outbuf);
+            }
+            break;
+
+        case slot_close:
+        case slot_free:
+            slot -> state = slot_free;
+            break;
+    }
+}
+
+//Function to read the tags of all collected files through io_uring;
+status uring_scan(MP3SCAN *mp3scan)
+{
+    URING uring;
+    OUTBUF outbuf;
+    unsigned int depth = mp3scan -> depth ? mp3scan -> depth : URING_DEFAULT_DEPTH;
+    unsigned int i, active = 0;
+
+    if(uring_init(&uring, depth) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    URINGSLOT *slots = calloc(depth, sizeof(URINGSLOT));
+    if(slots == NULL || outbuf_init(&outbuf, STDOUT_FILENO, OUTBUF_SIZE, NULL) != E_SUCCESS)
+    {
+        free(slots);
+        uring_exit(&uring);
+        return E_FAILURE;
+    }
+
+    for(i = 0; i < depth; i++)
+    {
+        active += start_next_file(&uring, mp3scan, &slots[i], i);
+    }
+    while(active > 0)
+    {
+        int ret = syscall(__NR_io_uring_enter, uring.fd, uring.to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        STATS_COUNT(stat_syscalls, 1);
+        if(ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            perror("io_uring_enter");
+            break;
+        }
+        if(ret > 0)
+        {
+            uring.to_submit -= ret < (int)uring.to_submit ? (unsigned int)ret : uring.to_submit;
+        }
+
+        unsigned int head = *uring.cq_head;
+        while(head != __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE))
+        {
+            struct io_uring_cqe *cqe = &uring.cqes[head & *uring.cq_mask];
+            unsigned long id = cqe -> user_data;
+            int res = cqe -> res;
+            head++;
+            __atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+
+            handle_completion(&uring, mp3scan, &slots[id], id, res, &outbuf);
+            if(slots[id].state == slot_free)
+            {
+                active -= 1 - start_next_file(&uring, mp3scan, &slots[id], id);
+            }
+        }
+    }
+
+    outbuf_free(&outbuf);
+    for(i = 0; i < depth; i++)
+    {
+        arena_free(&slots[i].arena);
+    }
+    free(slots);
+    uring_exit(&uring);
+    return E_SUCCESS;
+}
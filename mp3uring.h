@@ -0,0 +1,85 @@
+/*
+File        : mp3uring.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the io_uring based asynchronous tag reader.
+
+              This file contains the structure definitions and function
+              prototypes required to read the tags of many MP3 files with
+              hundreds of I/O requests in flight from a single thread.
+
+              Key Components:
+               - URING     : The submission/completion rings shared with
+                             the kernel (set up with raw system calls, no
+                             liburing needed).
+               - URINGSLOT : One file being read. Every slot has exactly
+                             one request in flight and walks through the
+                             states open -> head -> body -> close.
+
+              Read Chain For Every File:
+               1. IORING_OP_OPENAT
+               2. IORING_OP_READ of the first URING_PREFIX bytes; the
+                  10 byte header is decoded from them and small tags are
+                  usually complete after this read
+               3. IORING_OP_READ of the rest of the tag body, submitted
+                  only once the syncsafe size is known
+               4. IORING_OP_CLOSE
+
+              Notes:
+               - Used by the scan mode with "-a" (queue depth "-q <n>").
+               - When io_uring is not available (old kernel, seccomp, ...)
+                 the scan falls back to the worker thread pool.
+*/
+#ifndef mp3uring_h
+#define mp3uring_h
+#include <linux/io_uring.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3scan.h"
+
+#define URING_DEFAULT_DEPTH 256
+#define URING_MAX_DEPTH 4096
+#define URING_PREFIX 4096        // bytes read together with the header
+
+typedef struct uring
+{
+	int fd;                        // ring file descriptor
+	unsigned int *sq_head, *sq_tail, *sq_mask, *sq_array;
+	unsigned int *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe *sqes;     // submission queue entries
+	struct io_uring_cqe *cqes;     // completion queue entries
+	void *sq_ring, *cq_ring;       // mapped rings
+	size_t sq_ring_size, cq_ring_size, sqes_size;
+	unsigned int to_submit;        // entries queued since the last io_uring_enter
+}URING;
+
+typedef enum
+{
+	slot_free,
+	slot_open,
+	slot_head,
+	slot_body,
+	slot_close
+}SlotState;
+
+typedef struct uring_slot
+{
+	SlotState state;
+	int fd;                  // file descriptor returned by openat
+	unsigned char *buffer;   // header followed by the tag body
+	unsigned int have;       // bytes of buffer already read
+	unsigned int want;       // bytes of buffer needed (header + tag size)
+	MP3VIEW mp3view;
+	ARENA arena;             // frame table memory, reused by every file of this slot
+}URINGSLOT;
+
+//Function to set up the rings; fails when io_uring is not usable;
+status uring_init(URING *uring, unsigned int entries);
+
+//Function to tear the rings down;
+void uring_exit(URING *uring);
+
+//Function to read the tags of all collected files through io_uring;
+status uring_scan(MP3SCAN *mp3scan);
+
+#endif
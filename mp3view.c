@@ -9,8 +9,14 @@ Description : Implementation file for MP3 Tag Viewing functionality.
                - Display help menu for viewing and editing MP3 metadata
                - Validate MP3 file extension
                - Open MP3 files for reading
-               - Verify the presence of an ID3 tag and its version
-               - Read tag frames (Title, Artist, Album, Year, Genre, Comment)
+               - Verify the presence of an ID3 tag and its version (the
+                 tag may follow leading junk or be appended at the end)
+               - Map the tag region (or load it with a single pread),
+                 index every frame of the tag and pick the tag frames
+                 (Title, Artist, Album, Year, Genre, Comment) from that
+                 index as views into the tag, without copying the values
+               - Read the tag of a stream on stdin ("-") through the chunk
+                 fed parser of mp3stream.h, without seeking
                - Convert frame size from big endian to little endian
                - Display retrieved tag data in a formatted way
 
@@ -38,9 +44,17 @@ Description : Implementation file for MP3 Tag Viewing functionality.
 #include "types.h"
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include "mp3view.h"
+#include "stats.h"
+#include "mp3text.h"
+#include "mp3stream.h"
+#include "id3frames.h"
 
 char *tags[6] = {"TIT2", "TPE1", "TALB", "TYER", "TCON", "COMM"};
+static const unsigned int tag_ids[MAX_TAGS] = {FRAME_ID('T', 'I', 'T', '2'), FRAME_ID('T', 'P', 'E', '1'),
+                                               FRAME_ID('T', 'A', 'L', 'B'), FRAME_ID('T', 'Y', 'E', 'R'),
+                                               FRAME_ID('T', 'C', 'O', 'N'), FRAME_ID('C', 'O', 'M', 'M')};
 
 /*Function to check for command line arguments*/
 OperationType check_Operation_Type(int argc, char *argv[])
@@ -49,12 +63,32 @@ OperationType check_Operation_Type(int argc, char *argv[])
       {
 	    if(strcmp(argv[1], "-v") == 0)
          {
+	       if(argc >= 3 && strcmp(argv[2], "-r") == 0)
+	       {
+	             return scan_mp3tags;
+	       }
 	       return view_mp3tags;
          }
          else if(strcmp(argv[1], "-e") == 0)
          {
+	       if(argc >= 3 && strcmp(argv[2], "-b") == 0)
+	       {
+	             return batch_edit_mp3tags;
+	       }
 	       return edit_mp3tags;
          }
+         else if(strcmp(argv[1], "-w") == 0)
+         {
+	       return watch_mp3tags;
+         }
+         else if(strcmp(argv[1], "-d") == 0)
+         {
+	       return dup_mp3files;
+         }
+         else if(strcmp(argv[1], "-f") == 0)
+         {
+	       return query_mp3tags;
+         }
          else if(strcmp(argv[1], "--help") == 0)
          {
 	        return Help_menu;
@@ -77,6 +111,7 @@ void Help_Info()
 {
 	printf("----------------------------------------HELP MENU-----------------------------------------------\n");
 	printf("1. -v -> to view mp3 file contents\n");
+	printf("1.1. -v -r <dir> [-j <threads>] [-a [-q <depth>]] [-i <index>] [-o <frame|file>] -> to view all mp3 files below a directory (sorted with -o)\n");
 	printf("2. -e -> to edit mp3 file contents\n");
 	printf("2.1. -t -> to edit song title\n");
 	printf("2.2. -a -> to edit artist name\n");
@@ -84,14 +119,24 @@ void Help_Info()
 	printf("2.4. -y -> to edit year\n");
 	printf("2.5. -m -> to edit content\n");
 	printf("2.1. -c -> to edit comment\n");
+	printf("   (several options can be given at once: -e -t title -a artist file.mp3)\n");
+	printf("3. -e -b <manifest> [-j <threads>] -> to apply a CSV/TSV manifest of path,frame,value rows\n");
+	printf("4. --fields <id,id,...> -> with -v, read and show only these frames (e.g. --fields TIT2,TPE1)\n");
+	printf("5. --stats[=json] -> print per phase timings and I/O counters at exit (with any option)\n");
+	printf("6. --format=<text|jsonl|tsv> -> with -v, print one JSON Lines or TSV record per file\n");
+	printf("7. -w <dir> -s <socket> [-i <index>] -> watch a directory, answer GET/LIST/COUNT on a Unix socket\n");
+	printf("8. -d <dir> [-j <threads>] -> list files with the same audio, whatever their tags\n");
+	printf("9. -f <dir> [-j <threads>] [-i <index>] [\"TPE1=artist && TYER=1998 && TALB=prefix*\" ...] -> find files by tags\n");
+	printf("   (without a query, one query is read per line of the input)\n");
+	printf("10. - as the file name -> stream mode: -v - shows the tags of stdin, -e -t title ... - edits stdin into stdout\n");
       printf("-------------------------------------------------------------------------------------------------\n");
 }
 
 // Function to check for the file extension;
 status check_for_extension(char *argv[], MP3VIEW *mp3view)
 {
-      char *temp = strrchr(argv[2], '.');
-      if(temp != NULL && strcmp(temp, ".mp3") == 0)
+      // "-" reads the tag from stdin
+      if(has_mp3_extension(argv[2]) || strcmp(argv[2], "-") == 0)
       {
            mp3view -> sample_mp3_fname = argv[2]; 
            return E_SUCCESS;
@@ -103,8 +148,55 @@ status check_for_extension(char *argv[], MP3VIEW *mp3view)
            
 }
 
+//Function to check whether a file name ends with ".mp3";
+int has_mp3_extension(const char *fname)
+{
+      const char *temp = strrchr(fname, '.');
+      return temp != NULL && strcmp(temp, ".mp3") == 0;
+}
+
 status Mp3View(MP3VIEW *mp3view)
 {
+      status ret = parse_mp3file(mp3view);
+
+      if(mp3view -> fptr_sample_mp3 == NULL)
+      {
+            perror(mp3view -> error);
+            return E_FAILURE;
+      }
+      printf("The file was opened successfully\n");
+      if(mp3view -> error != NULL)
+      {
+            printf("%s\n", mp3view -> error);
+      }
+      if(ret == E_SUCCESS)
+      {
+            // a missing or unreadable audio part only leaves the two lines empty
+            if(mp3view -> fields == NULL && mp3view -> fptr_sample_mp3 != stdin)
+            {
+                  read_audio_info(fileno(mp3view -> fptr_sample_mp3), &mp3view -> id3tag, &mp3view -> audioinfo);
+            }
+            display_mp3tags(mp3view);
+      }
+
+      close_mp3file(mp3view);
+      return ret;
+}
+
+/* Function to open the file and index its tags; nothing is printed here,
+   the reason of a failure is left in mp3view -> error for the caller */
+status parse_mp3file(MP3VIEW *mp3view)
+{
+      mp3view -> error = NULL;
+      if(mp3view -> arena == NULL)
+      {
+            mp3view -> arena = &mp3view -> own_arena;
+      }
+      mp3view -> id3tag.arena = mp3view -> arena;
+      if(strcmp(mp3view -> sample_mp3_fname, "-") == 0)
+      {
+            return parse_mp3stream(mp3view);
+      }
       if(open_mp3file(mp3view) != E_SUCCESS)
       {
             return E_FAILURE;
@@ -120,26 +212,93 @@ status Mp3View(MP3VIEW *mp3view)
             return E_FAILURE;
       }
 
-      if(read_tag_info(mp3view) != E_SUCCESS)
+      return read_tag_info(mp3view);
+}
+
+/* Function to read the tag of the stream on stdin; only the tag is
+   read, chunk by chunk, so a pipe works and the audio information of
+   the view stays empty */
+status parse_mp3stream(MP3VIEW *mp3view)
+{
+      MP3STREAM stream;
+      size_t start, end;
+      unsigned int i;
+
+      mp3view -> fptr_sample_mp3 = stdin;
+      unsigned char *chunk = arena_alloc(mp3view -> arena, STREAM_CHUNK_SIZE);
+      if(chunk == NULL)
       {
-              return E_FAILURE;
+            mp3view -> error = "Out of memory";
+            return E_FAILURE;
+      }
+      stream_init(&stream, mp3view -> arena, STREAM_TAG_LIMIT);
+      STATS_BEGIN(read_start);
+      status ret = stream_read_tag(&stream, STDIN_FILENO, chunk, &start, &end);
+      STATS_END(phase_read_tag, read_start);
+      if(ret != E_SUCCESS)
+      {
+            mp3view -> error = stream.error;
+            return E_FAILURE;
+      }
+      if(!stream.tagged)
+      {
+            mp3view -> error = "ID3 was not found in the file";
+            return E_FAILURE;
+      }
+      mp3view -> id3tag = stream.id3tag;
+      if(check_for_version(mp3view) != E_SUCCESS)
+      {
+            return E_FAILURE;
+      }
+      if(mp3view -> fields == NULL)
+      {
+            return index_tag_frames(mp3view);
+      }
+
+      // the whole body is in memory, so --fields is served from the frame table
+      if(id3_index_frames(&mp3view -> id3tag, mp3view -> arena, &mp3view -> frametable) != E_SUCCESS)
+      {
+            mp3view -> error = "Out of memory";
+            return E_FAILURE;
+      }
+      for(i = 0; i < mp3view -> fields -> count; i++)
+      {
+            MP3VIEWINFO *info = &mp3view -> fieldinfo[i];
+            strcpy(info -> tags, mp3view -> fields -> names[i]);
+            if(decode_frame_text(mp3view, info, id3_find_frame(&mp3view -> frametable, mp3view -> fields -> ids[i])) != E_SUCCESS)
+            {
+                  return E_FAILURE;
+            }
       }
-      display_mp3tags(mp3view);
       return E_SUCCESS;
 }
 
+//Function to release the tag and close the file;
+void close_mp3file(MP3VIEW *mp3view)
+{
+      id3_free_tag(&mp3view -> id3tag);
+      arena_free(&mp3view -> own_arena);
+      if(mp3view -> fptr_sample_mp3 != NULL && mp3view -> fptr_sample_mp3 != stdin)
+      {
+            fclose(mp3view -> fptr_sample_mp3);
+            mp3view -> fptr_sample_mp3 = NULL;
+      }
+}
+
 status open_mp3file(MP3VIEW *mp3view)
 {
+      STATS_BEGIN(start);
       mp3view -> fptr_sample_mp3 = fopen(mp3view -> sample_mp3_fname, "r");
+      STATS_COUNT(stat_syscalls, 1);
+      STATS_END(phase_open, start);
 
       if(mp3view -> fptr_sample_mp3 == NULL)
       {
-              perror("Error: Unable to open The file");
+              mp3view -> error = "Error: Unable to open The file";
               return E_FAILURE;
       }
       else
       {
-            printf("The file was opened successfully\n");
             return E_SUCCESS;
       }
 
@@ -147,26 +306,19 @@ status open_mp3file(MP3VIEW *mp3view)
 
 status check_for_ID3(MP3VIEW *mp3view)
 {
-      
-      char temp_buffer[4];
-      if(fread(temp_buffer, sizeof(char), 3, mp3view -> fptr_sample_mp3) == 3)
+      /* one pread for the whole 10 byte header, the version checks work on this copy;
+         a file that does not start with a tag goes through the tag locator */
+      STATS_BEGIN(start);
+      status ret = id3_read_header(fileno(mp3view -> fptr_sample_mp3), &mp3view -> id3tag);
+      STATS_END(phase_header, start);
+      if(ret == E_SUCCESS)
       {
-            temp_buffer[3] = '\0';
-            //printf("%s\n",temp_buffer);
-            if(strcmp(temp_buffer, "ID3") == 0)
-            {
-                  return E_SUCCESS;
-            }
-            else
-            {
-                  printf("ID3 was not found in the file\n");
-                  return E_FAILURE;
-            }
-      } 
+            return E_SUCCESS;
+      }
       else
       {
-             printf("fread function failed to read the data from a file stream\n");
-             return E_FAILURE;
+            mp3view -> error = "ID3 was not found in the file";
+            return E_FAILURE;
       }
 
 }
@@ -174,73 +326,217 @@ status check_for_ID3(MP3VIEW *mp3view)
 //Function to check for version;
 status check_for_version(MP3VIEW *mp3view)
 {
-      char version[2];
-      //tempary buffer to store the version;
-      //if fread function was successfull then it will returns number of elements successfully read from the file;
-      if(fread(version, sizeof(char), 2, mp3view ->fptr_sample_mp3) == 2)
-      {
-            
-             if((unsigned char)version[0] == 3 && (unsigned char)version[1] == 0)
-             {
-                  return E_SUCCESS;
-             }
-             else
-             {
-                  printf("the correct version was not found\n");
-                  return E_FAILURE;
-
-             }
+      const unsigned char *version = mp3view -> id3tag.header + 3;
+      if(version[0] == 3 && version[1] == 0)
+      {
+            return E_SUCCESS;
       }
       else
       {
-            printf("fread function failed to read the data from a file stream\n");
-             return E_FAILURE;
+            mp3view -> error = "the correct version was not found";
+            return E_FAILURE;
       }
 }
 //Function to read all tags and titles related to tags;
 status read_tag_info(MP3VIEW *mp3view)
 {
+      /* the tag region is mapped and frames become (offset, length) views into it;
+         if the file cannot be mapped the body is pulled in with a single pread */
+      if(mp3view -> fields != NULL)
+      {
+            return read_selected_fields(mp3view);
+      }
+      int fd = fileno(mp3view -> fptr_sample_mp3);
+      STATS_BEGIN(start);
+      status ret = id3_map_body(fd, &mp3view -> id3tag);
+      if(ret != E_SUCCESS)
+      {
+            ret = id3_read_body(fd, &mp3view -> id3tag);
+      }
+      STATS_END(phase_read_tag, start);
+      if(ret != E_SUCCESS)
+      {
+            mp3view -> error = "fread function failed to read the data from a file stream";
+            return E_FAILURE;
+      }
+      return index_tag_frames(mp3view);
+}
 
-   fseek(mp3view -> fptr_sample_mp3, 5, SEEK_CUR);
-   char size_buffer[4];
-   char *data;
-   char tag[5];
-   int i;
-for(i = 0; i < 6; i++)
+/* Function to read only the frames selected with --fields; frames that
+   were not asked for are skipped by their size and nothing after the
+   last requested frame is read */
+status read_selected_fields(MP3VIEW *mp3view)
 {
-      if(fread(tag, 1, 4, mp3view -> fptr_sample_mp3) != 4)
+      const FIELDSET *fields = mp3view -> fields;
+      ID3FRAME found[MAX_FIELDS];
+      unsigned int i;
+
+      STATS_BEGIN(start);
+      status ret = id3_read_frames(fileno(mp3view -> fptr_sample_mp3), &mp3view -> id3tag, fields -> ids, fields -> count, found);
+      STATS_END(phase_read_tag, start);
+      if(ret != E_SUCCESS)
       {
+            mp3view -> error = "fread function failed to read the data from a file stream";
             return E_FAILURE;
       }
-      tag[4] = '\0';
-      if(strcmp(tags[i], tag) == 0)
+      for(i = 0; i < fields -> count; i++)
       {
-            strcpy(mp3view -> mp3viewinfo[i].tags, tag);
-           
+            MP3VIEWINFO *info = &mp3view -> fieldinfo[i];
+            strcpy(info -> tags, fields -> names[i]);
+            if(decode_frame_text(mp3view, info, found[i].size ? &found[i] : NULL) != E_SUCCESS)
+            {
+                  return E_FAILURE;
+            }
       }
-      else
+      return E_SUCCESS;
+}
+
+//Function to read --fields <id,id,...> from the arguments and remove it;
+int parse_fields_arg(int argc, char *argv[], FIELDSET *fields)
+{
+      int i, j = 1;
+      fields -> count = 0;
+      for(i = 1; i < argc; i++)
       {
-            printf("The tag not found");
-            break;
+            if(strcmp(argv[i], "--fields") != 0)
+            {
+                  argv[j++] = argv[i];
+                  continue;
+            }
+            if(i + 1 >= argc)
+            {
+                  printf("Error: --fields needs a list of frame ids (e.g. TIT2,TPE1)\n");
+                  return -1;
+            }
+            const char *id = argv[++i];
+            while(*id != '\0')
+            {
+                  size_t length = strcspn(id, ",");
+                  if(length != 4 || fields -> count == MAX_FIELDS)
+                  {
+                        printf("Error: --fields takes up to %d frame ids of 4 characters\n", MAX_FIELDS);
+                        return -1;
+                  }
+                  memcpy(fields -> names[fields -> count], id, 4);
+                  fields -> names[fields -> count][4] = '\0';
+                  fields -> ids[fields -> count] = frame_id((const unsigned char *)id);
+                  fields -> count++;
+                  id += length + (id[length] == ',');
+            }
       }
+      argv[j] = NULL;
+      return j;
+}
+
+//Function to get the display label of a frame id from the frame table;
+const char *field_label(const char *id)
+{
+      const FRAMESLOT *slot = frame_lookup(frame_id((const unsigned char *)id));
+      if(slot != NULL && frame_detail(slot) -> label != NULL)
+      {
+            return frame_detail(slot) -> label;
+      }
+      return id;
+}
 
-      if(fread(size_buffer, 1, 4, mp3view -> fptr_sample_mp3) != 4)
+/* Function to point a tag at the UTF-8 text of its frame; the encoding
+   byte is honoured, comments skip their language and description, and
+   only text that is not plain ISO-8859-1 ASCII is converted (into the
+   per-file arena), the rest stays a view into the tag body */
+status decode_frame_text(MP3VIEW *mp3view, MP3VIEWINFO *info, const ID3FRAME *frame)
+{
+      info -> text = NULL;
+      info -> offset = 0;
+      info -> length = 0;
+      info -> size = frame ? frame -> size : 0;
+      if(frame == NULL || frame -> size == 0)
       {
+            return E_SUCCESS;
+      }
+
+      // the frame table tells how the payload is laid out, unknown frames are read as text
+      const FRAMESLOT *known = frame_lookup(frame -> id);
+      const unsigned char *payload = mp3view -> id3tag.buffer + frame -> offset + FRAME_HEADER_SIZE;
+      unsigned int encoding = payload[0];
+      const unsigned char *text = payload + 1;
+      size_t length = frame -> size - 1;
+      size_t skip;
+      switch(known != NULL ? known -> kind : frame_text)
+      {
+            case frame_url:
+                  // no encoding byte, always ISO-8859-1
+                  encoding = TEXT_LATIN1;
+                  text = payload;
+                  length = frame -> size;
+                  break;
+            case frame_comment:
+                  // 3 byte language, then a terminated description
+                  skip = length < 3 ? length : 3;
+                  skip += text_string_end(encoding, text + skip, length - skip);
+                  text += skip;
+                  length -= skip;
+                  break;
+            case frame_user_text:
+            case frame_user_url:
+                  // a terminated description, then the value (an URL is ISO-8859-1)
+                  skip = text_string_end(encoding, text, length);
+                  text += skip;
+                  length -= skip;
+                  if(known -> kind == frame_user_url)
+                  {
+                        encoding = TEXT_LATIN1;
+                  }
+                  break;
+            default:
+                  break;
+      }
+
+      if(encoding == TEXT_LATIN1)
+      {
+            // the value ends at its terminator, like in the converting path
+            const unsigned char *end = memchr(text, 0, length);
+            if(end != NULL)
+            {
+                  length = end - text;
+            }
+      }
+      if(encoding == TEXT_LATIN1 && text_is_ascii(text, length))
+      {
+            info -> offset = text - mp3view -> id3tag.buffer;
+            info -> length = length;
+            return E_SUCCESS;
+      }
+      char *utf8 = arena_alloc(mp3view -> arena, TEXT_MAX_UTF8(length) + 1);
+      if(utf8 == NULL)
+      {
+            mp3view -> error = "Out of memory";
+            return E_FAILURE;
+      }
+      info -> length = text_to_utf8(encoding, text, length, (unsigned char *)utf8);
+      info -> text = utf8;
+      return E_SUCCESS;
+}
+
+/* Function to index the tags of an already loaded tag body; every frame
+   goes into the frame table first, so the six tags may appear in any order
+   and a missing one just stays empty */
+status index_tag_frames(MP3VIEW *mp3view)
+{
+      int i;
+      if(id3_index_frames(&mp3view -> id3tag, mp3view -> arena, &mp3view -> frametable) != E_SUCCESS)
+      {
+            mp3view -> error = "Out of memory";
             return E_FAILURE;
       }
-      mp3view -> mp3viewinfo[i].size = bigendian_to_littleendian(size_buffer);
-      fseek(mp3view -> fptr_sample_mp3, 2, SEEK_CUR);
-      unsigned char encoding;
-      fread(&encoding, 1, 1, mp3view -> fptr_sample_mp3);
-       // actual text size is equal to frame size - 1 byte encoding;
-       size_t text_data = mp3view -> mp3viewinfo[i].size - 1;
+for(i = 0; i < MAX_TAGS; i++)
+{
+      const ID3FRAME *frame = id3_find_frame(&mp3view -> frametable, tag_ids[i]);
 
-      if(fread(mp3view -> mp3viewinfo[i].data, text_data, 1, mp3view -> fptr_sample_mp3) != 1)
+      strcpy(mp3view -> mp3viewinfo[i].tags, tags[i]);
+      if(decode_frame_text(mp3view, &mp3view -> mp3viewinfo[i], frame) != E_SUCCESS)
       {
             return E_FAILURE;
       }
-      mp3view -> mp3viewinfo[i].data[text_data] = '\0';
-     
 }
       return E_SUCCESS;
 
@@ -256,6 +552,42 @@ unsigned int bigendian_to_littleendian(const unsigned char *ptr)
            (ptr[3] & 0x7F);
 }
 
+//Function to get the text of a tag as a pointer into the tag body;
+const char *tag_value(const MP3VIEW *mp3view, int index)
+{
+      if(mp3view -> mp3viewinfo[index].text != NULL)
+      {
+            return mp3view -> mp3viewinfo[index].text;
+      }
+      return (const char *)mp3view -> id3tag.buffer + mp3view -> mp3viewinfo[index].offset;
+}
+
+//Function to display the duration and bitrate of the audio;
+void display_audioinfo(const AUDIOINFO *audioinfo)
+{
+  if(audioinfo -> frames == 0)
+  {
+        printf("DURATION       :            \n");
+        printf("BITRATE        :            \n");
+        return;
+  }
+  unsigned long seconds = (unsigned long)(audioinfo -> duration + 0.5);
+  printf("DURATION       :            %lu:%02lu (%.2f s)\n", seconds / 60, seconds % 60, audioinfo -> duration);
+  printf("BITRATE        :            %u kbps %s, MPEG %u.%u layer %u, %u Hz (%s)\n", audioinfo -> bitrate,
+         audioinfo -> vbr ? "VBR" : "CBR", audioinfo -> version / 10, audioinfo -> version % 10,
+         audioinfo -> layer, audioinfo -> sample_rate, audioinfo -> source);
+}
+
+//Function to get the text of a selected field as a pointer into the tag body;
+const char *field_value(const MP3VIEW *mp3view, int index)
+{
+      if(mp3view -> fieldinfo[index].text != NULL)
+      {
+            return mp3view -> fieldinfo[index].text;
+      }
+      return (const char *)mp3view -> id3tag.buffer + mp3view -> fieldinfo[index].offset;
+}
+
 void display_mp3tags(MP3VIEW *mp3view)
 {
   printf("------------------------------------------SELECTED VIEW DETAILS-----------------------------------\n");
@@ -263,12 +595,24 @@ void display_mp3tags(MP3VIEW *mp3view)
   printf("----------------------------------------------------------------------------------\n");
   printf("==================MP3 TAG READER AND EDITOR FOR ID3V2===========================\n");
   printf("----------------------------------------------------------------------------------\n");
-  printf("TITLE          :            %s\n",  mp3view -> mp3viewinfo[0].data);
-  printf("ARTIST         :            %s\n",  mp3view -> mp3viewinfo[1].data);
-  printf("ALBUM          :            %s\n",  mp3view -> mp3viewinfo[2].data);
-  printf("YEAR           :            %s\n",  mp3view -> mp3viewinfo[3].data);
-  printf("MUSIC          :            %s\n",  mp3view -> mp3viewinfo[4].data);
-  printf("COMMENT        :            %s\n",  mp3view -> mp3viewinfo[5].data);
+  if(mp3view -> fields != NULL)
+  {
+        unsigned int i;
+        for(i = 0; i < mp3view -> fields -> count; i++)
+        {
+              printf("%-15s:            %.*s\n", field_label(mp3view -> fieldinfo[i].tags),
+                     (int)mp3view -> fieldinfo[i].length, field_value(mp3view, i));
+        }
+        printf("----------------------------------------------------------------------------------\n");
+        return;
+  }
+  printf("TITLE          :            %.*s\n", (int)mp3view -> mp3viewinfo[0].length, tag_value(mp3view, 0));
+  printf("ARTIST         :            %.*s\n", (int)mp3view -> mp3viewinfo[1].length, tag_value(mp3view, 1));
+  printf("ALBUM          :            %.*s\n", (int)mp3view -> mp3viewinfo[2].length, tag_value(mp3view, 2));
+  printf("YEAR           :            %.*s\n", (int)mp3view -> mp3viewinfo[3].length, tag_value(mp3view, 3));
+  printf("MUSIC          :            %.*s\n", (int)mp3view -> mp3viewinfo[4].length, tag_value(mp3view, 4));
+  printf("COMMENT        :            %.*s\n", (int)mp3view -> mp3viewinfo[5].length, tag_value(mp3view, 5));
+  display_audioinfo(&mp3view -> audioinfo);
   printf("----------------------------------------------------------------------------------\n");
 }
 
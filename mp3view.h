@@ -10,10 +10,19 @@ Description : Header file for MP3 Tag Viewing functionality.
               ID3v2 tags from an MP3 file.
 
               Key Components:
-               - MP3VIEWINFO : Holds individual tag name, size, and value.
-               - MP3VIEW     : Holds the MP3 filename, file pointer, and 
-                               an array of MP3VIEWINFO structures for all tags.
-               - Constants   : MAX_LEN (tag name length), MAX_TAGS (number of tags).
+               - MP3VIEWINFO : Holds individual tag name, size, and the
+                               (offset, length) of its value inside the
+                               tag body; ASCII values are never copied,
+                               others are converted to UTF-8 (mp3text.h).
+               - MP3VIEW     : Holds the MP3 filename, file pointer, the
+                               ID3TAG block (header read with one pread, body
+                               mmap'ed read-only) and an array of MP3VIEWINFO
+                               structures for all tags.
+               - FIELDSET    : Frames selected with --fields TIT2,TPE1; only
+                               those are read (id3_read_frames()), the
+                               walk over the tag stops once all are found.
+               - Constants   : MAX_LEN (tag name length), MAX_TAGS (number of tags),
+                               MAX_FIELDS (frames in a --fields list).
 
               Supported Operations:
                - Checking command-line operation type
@@ -22,7 +31,8 @@ Description : Header file for MP3 Tag Viewing functionality.
                - Opening MP3 file and checking ID3 header
                - Determining ID3 version
                - Reading all tag data and converting endian format
-               - Displaying all retrieved tags to the user
+               - Displaying all retrieved tags to the user, with the
+                 duration and bitrate of the audio (see mp3audio.h)
 
               Notes:
                - Only files with the ".mp3" extension are supported.
@@ -31,22 +41,44 @@ Description : Header file for MP3 Tag Viewing functionality.
 */
 #ifndef mp3view_h
 #define mp3view_h
+#include <stdio.h>
 #include "types.h"
+#include "id3tag.h"
+#include "arena.h"
+#include "mp3audio.h"
 #define MAX_LEN 5
 #define MAX_TAGS 6
+#define MAX_FIELDS 16
 
 typedef struct ViewInfo
 {
 	char tags[MAX_LEN]; //  an array of character to store different tags; 
 	unsigned int size;           // integer variable to store the size of the tag data;
-	char data[100]; // character array to store information about tags;
+	unsigned int offset;  // offset of the text inside the tag body (a view, not a copy)
+	unsigned int length;  // length of the text;
+	const char *text;     // text converted to UTF-8 (in the arena), NULL when ASCII is used in place
 }MP3VIEWINFO;
 
+typedef struct fieldset
+{
+	unsigned int count;             // number of requested frames, 0 = the six default tags
+	unsigned int ids[MAX_FIELDS];   // requested frame ids as integers
+	char names[MAX_FIELDS][MAX_LEN];
+}FIELDSET;
+
 typedef struct mp3view
 {
 	char *sample_mp3_fname; //this is a character pointer to store the base address of sample file name; 
 	FILE *fptr_sample_mp3;   // this is a file pointer to open the file and perform file operations
+    const char *error;       // reason of the last failure, printed by the caller
+    ID3TAG id3tag;           // raw tag header and the whole tag body, read in one go
+    FRAMETABLE frametable;   // every frame of the tag, looked up by frame id
+    ARENA *arena;            // per-file memory, reset by the caller between files
+    ARENA own_arena;         // used when the caller did not provide an arena
     MP3VIEWINFO mp3viewinfo[MAX_TAGS];
+    AUDIOINFO audioinfo;     // duration and bitrate, filled by the single file view only
+    const FIELDSET *fields;  // --fields: only these frames are read and shown, NULL for the six tags
+    MP3VIEWINFO fieldinfo[MAX_FIELDS];
 }MP3VIEW;
 
 // Function to check operationtype 
@@ -61,6 +93,18 @@ status check_for_extension(char *argv[], MP3VIEW *mp3view);
 //Function for mp3view;
 status Mp3View(MP3VIEW *mp3view);
 
+//Function to check whether a file name ends with ".mp3";
+int has_mp3_extension(const char *fname);
+
+//Function to open the file and index its tags without printing;
+status parse_mp3file(MP3VIEW *mp3view);
+
+//Function to read the tag of the stream on stdin ("-") without seeking;
+status parse_mp3stream(MP3VIEW *mp3view);
+
+//Function to release the tag and close the file;
+void close_mp3file(MP3VIEW *mp3view);
+
 //Function to open mp3  file;
 status open_mp3file(MP3VIEW *mp3view);
 
@@ -73,12 +117,36 @@ status check_for_version(MP3VIEW *mp3view);
 //Function to read all tags and titles related to tags;
 status read_tag_info(MP3VIEW *mp3view);
 
+//Function to read only the frames selected with --fields;
+status read_selected_fields(MP3VIEW *mp3view);
+
+//Function to read --fields <id,id,...> from the arguments and remove it;
+int parse_fields_arg(int argc, char *argv[], FIELDSET *fields);
+
+//Function to get the display label of a frame id;
+const char *field_label(const char *id);
+
+//Function to point a tag at the UTF-8 text of its frame;
+status decode_frame_text(MP3VIEW *mp3view, MP3VIEWINFO *info, const ID3FRAME *frame);
+
+//Function to index the tags of an already loaded tag body;
+status index_tag_frames(MP3VIEW *mp3view);
+
 //Function to convert big endiann to little endian;
 unsigned int bigendian_to_littleendian(const unsigned char *ptr);
 
+//Function to get the text of a tag as a pointer into the tag body;
+const char *tag_value(const MP3VIEW *mp3view, int index);
+
+//Function to get the text of a selected field as a pointer into the tag body;
+const char *field_value(const MP3VIEW *mp3view, int index);
+
 //Function to display mp3 view tags
 void display_mp3tags(MP3VIEW *mp3view);
 
+//Function to display the duration and bitrate of the audio;
+void display_audioinfo(const AUDIOINFO *audioinfo);
+
 
 
 
@@ -0,0 +1,670 @@
+/*
+File        : mp3watch.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the watch mode daemon.
+
+              This file contains the function definitions required to:
+               - Read the watch options from the command line
+               - Watch every directory of a library with inotify and
+                 index its files with the same parser as the view mode
+               - Re-parse only files that were written or moved in
+               - Answer GET / LIST / COUNT requests on a Unix socket
+
+              Notes:
+               - A poll() loop serves the inotify descriptor, the
+                 listening socket and up to WATCH_MAX_CLIENTS clients;
+                 there is no locking since nothing else touches the index.
+               - Answers are built in the OUTBUF of the client and written
+                 with non-blocking write() calls whenever the socket takes
+                 them, never waiting on a client.
+*/
+#define _GNU_SOURCE          // accept4()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "types.h"
+#include "mp3view.h"
+#include "mp3index.h"
+#include "mp3format.h"
+#include "mp3watch.h"
+#include "outbuf.h"
+#include "stats.h"
+
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR)
+
+static volatile sig_atomic_t stop_watch;
+
+//Function to ask the poll loop to stop (SIGINT, SIGTERM);
+static void on_stop_signal(int signal_number)
+{
+    (void)signal_number;
+    stop_watch = 1;
+}
+
+//Function to read the watch options (-w <dir> -s <socket> [-i <index>]);
+status check_watch_args(int argc, char *argv[], MP3WATCH *mp3watch)
+{
+    int i;
+
+    if(argc < 3)
+    {
+        printf("Error: missing directory name\n");
+        return E_FAILURE;
+    }
+    mp3watch -> root = argv[2];
+    for(i = 3; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            mp3watch -> socket_path = argv[++i];
+        }
+        else if(strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            mp3watch -> index_fname = argv[++i];
+        }
+        else
+        {
+            printf("Error: unknown watch option '%s'\n", argv[i]);
+            return E_FAILURE;
+        }
+    }
+    if(mp3watch -> socket_path == NULL)
+    {
+        printf("Error: missing socket name (-s <socket>)\n");
+        return E_FAILURE;
+    }
+    if(strlen(mp3watch -> socket_path) >= sizeof(((struct sockaddr_un *)0) -> sun_path))
+    {
+        printf("Error: socket name is too long\n");
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to join a directory and a file name into a new string;
+static char *join_path(const char *dir, const char *name)
+{
+    size_t length = strlen(dir) + strlen(name) + 2;
+    char *path = malloc(length);
+    if(path != NULL)
+    {
+        snprintf(path, length, "%s%s%s", dir, dir[strlen(dir) - 1] == '/' ? "" : "/", name);
+    }
+    return path;
+}
+
+//Function to remember the directory of a watch descriptor;
+static status set_watch(MP3WATCH *mp3watch, int wd, const char *dir)
+{
+    if((size_t)wd >= mp3watch -> nwatches)
+    {
+        size_t nwatches = mp3watch -> nwatches ? mp3watch -> nwatches : 256;
+        while(nwatches <= (size_t)wd)
+        {
+            nwatches *= 2;
+        }
+        char **watches = realloc(mp3watch -> watches, nwatches * sizeof(char *));
+        if(watches == NULL)
+        {
+            return E_FAILURE;
+        }
+        memset(watches + mp3watch -> nwatches, 0, (nwatches - mp3watch -> nwatches) * sizeof(char *));
+        mp3watch -> watches = watches;
+        mp3watch -> nwatches = nwatches;
+    }
+    // the same directory watched again (rescan) keeps its descriptor
+    free(mp3watch -> watches[wd]);
+    mp3watch -> watches[wd] = strdup(dir);
+    return mp3watch -> watches[wd] != NULL ? E_SUCCESS : E_FAILURE;
+}
+
+//Function to parse a file again unless its index entry is still current;
+void update_file(MP3WATCH *mp3watch, const char *path)
+{
+    struct stat st;
+    if(stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        index_remove(&mp3watch -> index, path);
+        return;
+    }
+    INDEXENTRY *entry = index_lookup(&mp3watch -> index, path);
+    if(entry != NULL && index_entry_matches(entry, &st))
+    {
+        entry -> seen = 1;
+        return;
+    }
+
+    MP3VIEW mp3view = {0};
+    mp3view.sample_mp3_fname = (char *)path;
+    mp3view.arena = &mp3watch -> arena;
+    status ret = parse_mp3file(&mp3view);
+    if(ret != E_SUCCESS && mp3view.error == NULL)
+    {
+        mp3view.error = "Invalid tag";
+    }
+    if(index_put(&mp3watch -> index, &mp3view, ret, &st) != E_SUCCESS)
+    {
+        fprintf(stderr, "Warning: could not index %s\n", path);
+    }
+    close_mp3file(&mp3view);
+    arena_reset(&mp3watch -> arena);
+    mp3watch -> parsed++;
+
+    entry = index_lookup(&mp3watch -> index, path);
+    if(entry != NULL)
+    {
+        entry -> seen = 1;
+    }
+}
+
+//Function to watch a directory tree and index every file in it;
+status watch_tree(MP3WATCH *mp3watch, const char *dir)
+{
+    int wd = inotify_add_watch(mp3watch -> inotify_fd, dir, WATCH_EVENTS);
+    if(wd < 0 || set_watch(mp3watch, wd, dir) != E_SUCCESS)
+    {
+        perror(dir);
+        return E_FAILURE;
+    }
+
+    // watched before it is read, so a file created meanwhile is not missed
+    DIR *dp = opendir(dir);
+    struct dirent *entry;
+    if(dp == NULL)
+    {
+        perror(dir);
+        return E_FAILURE;
+    }
+    while((entry = readdir(dp)) != NULL)
+    {
+        if(strcmp(entry -> d_name, ".") == 0 || strcmp(entry -> d_name, "..") == 0)
+        {
+            continue;
+        }
+        char *path = join_path(dir, entry -> d_name);
+        if(path == NULL)
+        {
+            closedir(dp);
+            return E_FAILURE;
+        }
+        unsigned char type = entry -> d_type;
+        if(type == DT_UNKNOWN)
+        {
+            struct stat st;
+            if(lstat(path, &st) == 0)
+            {
+                type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+        }
+        if(type == DT_DIR)
+        {
+            watch_tree(mp3watch, path);
+        }
+        else if(type == DT_REG && has_mp3_extension(entry -> d_name))
+        {
+            update_file(mp3watch, path);
+        }
+        free(path);
+    }
+    closedir(dp);
+    return E_SUCCESS;
+}
+
+//Function to drop every file and watch below a path that went away;
+void forget_tree(MP3WATCH *mp3watch, const char *path)
+{
+    size_t length = strlen(path);
+    size_t wd;
+
+    index_remove_tree(&mp3watch -> index, path, 0);
+    for(wd = 0; wd < mp3watch -> nwatches; wd++)
+    {
+        const char *dir = mp3watch -> watches[wd];
+        if(dir != NULL && strncmp(dir, path, length) == 0 && (dir[length] == '\0' || dir[length] == '/'))
+        {
+            inotify_rm_watch(mp3watch -> inotify_fd, wd);
+            free(mp3watch -> watches[wd]);
+            mp3watch -> watches[wd] = NULL;
+        }
+    }
+}
+
+//Function to apply one inotify event;
+static void apply_event(MP3WATCH *mp3watch, const struct inotify_event *event)
+{
+    if(event -> wd < 0 || (size_t)event -> wd >= mp3watch -> nwatches || mp3watch -> watches[event -> wd] == NULL)
+    {
+        return;
+    }
+    if(event -> mask & IN_IGNORED)
+    {
+        // the directory is gone (or was forgotten), its descriptor may be reused
+        free(mp3watch -> watches[event -> wd]);
+        mp3watch -> watches[event -> wd] = NULL;
+        return;
+    }
+    if(event -> len == 0)
+    {
+        return;
+    }
+    char *path = join_path(mp3watch -> watches[event -> wd], event -> name);
+    if(path == NULL)
+    {
+        return;
+    }
+    if(event -> mask & IN_ISDIR)
+    {
+        if(event -> mask & (IN_CREATE | IN_MOVED_TO))
+        {
+            watch_tree(mp3watch, path);
+        }
+        else if(event -> mask & (IN_DELETE | IN_MOVED_FROM))
+        {
+            forget_tree(mp3watch, path);
+        }
+    }
+    else if(has_mp3_extension(event -> name))
+    {
+        // a new file is indexed once its writer closes it, not when it is created
+        if(event -> mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+        {
+            update_file(mp3watch, path);
+        }
+        else if(event -> mask & (IN_DELETE | IN_MOVED_FROM))
+        {
+            index_remove(&mp3watch -> index, path);
+        }
+    }
+    free(path);
+}
+
+//Function to apply all pending inotify events;
+void handle_events(MP3WATCH *mp3watch)
+{
+    static char buffer[WATCH_EVENT_BUFFER] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int overflow = 0;
+    ssize_t length;
+
+    while((length = read(mp3watch -> inotify_fd, buffer, sizeof(buffer))) > 0)
+    {
+        char *ptr = buffer;
+        while(ptr < buffer + length)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            if(event -> mask & IN_Q_OVERFLOW)
+            {
+                overflow = 1;
+            }
+            else
+            {
+                apply_event(mp3watch, event);
+            }
+            ptr += sizeof(struct inotify_event) + event -> len;
+        }
+    }
+    if(overflow)
+    {
+        // events were lost: walk the tree again, stat() tells what changed
+        fprintf(stderr, "Warning: inotify queue overflowed, checking %s again\n", mp3watch -> root);
+        index_clear_seen(&mp3watch -> index);
+        watch_tree(mp3watch, mp3watch -> root);
+        index_remove_tree(&mp3watch -> index, mp3watch -> root, 1);
+    }
+}
+
+//Function to append the record of one index entry;
+static void format_entry(INDEXENTRY *entry, OUTBUF *outbuf)
+{
+    if(entry -> record.failed)
+    {
+        // the reason of the failure is kept as the first value
+        char error[256];
+        snprintf(error, sizeof(error), "%.*s", (int)entry -> record.value_length[0], entry -> values);
+        format_error(entry -> path, error, NULL, outbuf, format_jsonl);
+        return;
+    }
+    MP3VIEW mp3view = {0};
+    index_entry_to_view(entry, &mp3view);
+    format_mp3tags(&mp3view, outbuf, format_jsonl);
+}
+
+//Function to answer one request line;
+void answer_query(MP3WATCH *mp3watch, const char *line, OUTBUF *outbuf)
+{
+    if(strncmp(line, "GET ", 4) == 0)
+    {
+        INDEXENTRY *entry = index_lookup(&mp3watch -> index, line + 4);
+        if(entry != NULL)
+        {
+            format_entry(entry, outbuf);
+        }
+        else
+        {
+            format_error(line + 4, "not indexed", NULL, outbuf, format_jsonl);
+        }
+    }
+    else if(strcmp(line, "LIST") == 0 || strncmp(line, "LIST ", 5) == 0)
+    {
+        const char *prefix = line[4] == ' ' ? line + 5 : "";
+        size_t length = strlen(prefix);
+        size_t i;
+        INDEXENTRY *entry;
+        for(i = 0; i < mp3watch -> index.nbuckets; i++)
+        {
+            for(entry = mp3watch -> index.buckets[i]; entry != NULL; entry = entry -> next)
+            {
+                if(strncmp(entry -> path, prefix, length) == 0)
+                {
+                    format_entry(entry, outbuf);
+                }
+            }
+        }
+    }
+    else if(strcmp(line, "COUNT") == 0)
+    {
+        outbuf_printf(outbuf, "{\"files\":%zu}\n", mp3watch -> index.count);
+    }
+    else
+    {
+        outbuf_printf(outbuf, "{\"error\":\"unknown request, use GET <path>, LIST [prefix] or COUNT\"}\n");
+    }
+    // an empty line ends every answer
+    outbuf_append(outbuf, "\n", 1);
+}
+
+/* Function to answer the complete request lines of a client while its
+   unsent output is small; the other lines wait until it was sent */
+static void answer_lines(MP3WATCH *mp3watch, WATCHCLIENT *client)
+{
+    char *newline;
+    while(client -> output.length - client -> sent < OUTBUF_SIZE &&
+          (newline = memchr(client -> line, '\n', client -> length)) != NULL)
+    {
+        size_t used = newline - client -> line + 1;
+        *newline = '\0';
+        if(newline > client -> line && newline[-1] == '\r')
+        {
+            newline[-1] = '\0';
+        }
+        answer_query(mp3watch, client -> line, &client -> output);
+        memmove(client -> line, client -> line + used, client -> length - used);
+        client -> length -= used;
+    }
+    if(client -> length == WATCH_LINE_MAX && memchr(client -> line, '\n', client -> length) == NULL)
+    {
+        outbuf_printf(&client -> output, "{\"error\":\"request line too long\"}\n\n");
+        client -> length = 0;
+        client -> closing = 1;
+    }
+}
+
+//Function to write as much output as the socket takes now, E_FAILURE to close the client;
+static status send_output(WATCHCLIENT *client)
+{
+    OUTBUF *output = &client -> output;
+    while(client -> sent < output -> length)
+    {
+        ssize_t written = write(client -> fd, output -> data + client -> sent, output -> length - client -> sent);
+        STATS_IO(stat_bytes_written, written);
+        if(written < 0)
+        {
+            // a full socket is no error, the rest goes out on POLLOUT
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? E_SUCCESS : E_FAILURE;
+        }
+        client -> sent += written;
+    }
+    output -> length = 0;
+    client -> sent = 0;
+    if(output -> allocated > WATCH_OUTPUT_KEEP)
+    {
+        // give back the memory of a large LIST
+        outbuf_free(output);
+        return outbuf_init(output, client -> fd, OUTBUF_SIZE, NULL);
+    }
+    return E_SUCCESS;
+}
+
+/* Function to serve a client the poll loop found ready: read what it
+   sent, answer complete lines and send what the socket takes; nothing
+   here waits for the client. E_FAILURE to close it */
+static status serve_client(MP3WATCH *mp3watch, WATCHCLIENT *client, short revents)
+{
+    if(revents & POLLIN)
+    {
+        ssize_t bytes = read(client -> fd, client -> line + client -> length, WATCH_LINE_MAX - client -> length);
+        if(bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR))
+        {
+            return E_FAILURE;
+        }
+        if(bytes > 0)
+        {
+            client -> length += bytes;
+        }
+    }
+    else if(!(revents & POLLOUT))
+    {
+        return E_FAILURE;       // POLLERR or POLLHUP with nothing to read
+    }
+    do
+    {
+        answer_lines(mp3watch, client);
+        if(send_output(client) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+    }
+    while(client -> output.length == 0 && !client -> closing && memchr(client -> line, '\n', client -> length) != NULL);
+    if(client -> closing && client -> output.length == 0)
+    {
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to disconnect a client without waiting for its output;
+static void close_client(WATCHCLIENT *client)
+{
+    client -> output.length = 0;
+    outbuf_free(&client -> output);
+    close(client -> fd);
+}
+
+//Function to create the listening Unix socket;
+static status open_socket(MP3WATCH *mp3watch)
+{
+    struct sockaddr_un address;
+    struct stat st;
+
+    // a socket left behind by a daemon that did not exit cleanly
+    if(lstat(mp3watch -> socket_path, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+        unlink(mp3watch -> socket_path);
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, mp3watch -> socket_path);
+    mp3watch -> listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(mp3watch -> listen_fd < 0 ||
+       bind(mp3watch -> listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+       listen(mp3watch -> listen_fd, WATCH_MAX_CLIENTS) != 0)
+    {
+        perror(mp3watch -> socket_path);
+        return E_FAILURE;
+    }
+    return E_SUCCESS;
+}
+
+//Function to build the index of the whole tree before serving queries;
+static status load_library(MP3WATCH *mp3watch)
+{
+    if(mp3watch -> index_fname == NULL)
+    {
+        if(index_init(&mp3watch -> index) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+        return watch_tree(mp3watch, mp3watch -> root);
+    }
+    if(index_open(&mp3watch -> index, mp3watch -> index_fname) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    if(watch_tree(mp3watch, mp3watch -> root) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    // drop the records of files deleted while the daemon was down, then reopen the compacted file
+    index_compact(&mp3watch -> index, mp3watch -> root);
+    index_close(&mp3watch -> index);
+    return index_open(&mp3watch -> index, mp3watch -> index_fname);
+}
+
+//Function to run the daemon until it is stopped;
+status Mp3Watch(MP3WATCH *mp3watch)
+{
+    struct pollfd fds[2 + WATCH_MAX_CLIENTS];
+    struct sigaction action;
+    unsigned int i;
+
+    mp3watch -> inotify_fd = -1;
+    mp3watch -> listen_fd = -1;
+    mp3watch -> index.fd = -1;
+    char *root = realpath(mp3watch -> root, NULL);
+    if(root == NULL)
+    {
+        perror(mp3watch -> root);
+        return E_FAILURE;
+    }
+    mp3watch -> root = root;
+
+    // no SA_RESTART, so poll() returns when asked to stop
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_stop_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);       // a client that went away is only a failed write
+
+    mp3watch -> inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(mp3watch -> inotify_fd < 0)
+    {
+        perror("inotify");
+        free_watch(mp3watch);
+        return E_FAILURE;
+    }
+    if(load_library(mp3watch) != E_SUCCESS || open_socket(mp3watch) != E_SUCCESS)
+    {
+        free_watch(mp3watch);
+        return E_FAILURE;
+    }
+    printf("Watching %zu files below %s (%lu parsed), queries on %s\n", mp3watch -> index.count,
+           mp3watch -> root, mp3watch -> parsed, mp3watch -> socket_path);
+    fflush(stdout);
+
+    while(!stop_watch)
+    {
+        fds[0].fd = mp3watch -> inotify_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = mp3watch -> listen_fd;
+        fds[1].events = POLLIN;
+        for(i = 0; i < mp3watch -> nclients; i++)
+        {
+            // a client with unsent output is not read until it took it
+            fds[2 + i].fd = mp3watch -> clients[i].fd;
+            fds[2 + i].events = mp3watch -> clients[i].output.length > 0 ? POLLOUT : POLLIN;
+        }
+        unsigned int nclients = mp3watch -> nclients;
+        if(poll(fds, 2 + nclients, -1) < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+
+        if(fds[0].revents & POLLIN)
+        {
+            handle_events(mp3watch);
+        }
+        // backwards, so a closed client can be replaced by the last one
+        for(i = nclients; i-- > 0;)
+        {
+            if(fds[2 + i].revents && serve_client(mp3watch, &mp3watch -> clients[i], fds[2 + i].revents) != E_SUCCESS)
+            {
+                close_client(&mp3watch -> clients[i]);
+                mp3watch -> clients[i] = mp3watch -> clients[--mp3watch -> nclients];
+            }
+        }
+        if(fds[1].revents & POLLIN)
+        {
+            int fd = accept4(mp3watch -> listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            WATCHCLIENT *client = &mp3watch -> clients[mp3watch -> nclients];
+            if(fd >= 0 && (mp3watch -> nclients == WATCH_MAX_CLIENTS ||
+                           outbuf_init(&client -> output, fd, OUTBUF_SIZE, NULL) != E_SUCCESS))
+            {
+                close(fd);
+            }
+            else if(fd >= 0)
+            {
+                client -> fd = fd;
+                client -> length = 0;
+                client -> sent = 0;
+                client -> closing = 0;
+                mp3watch -> nclients++;
+            }
+        }
+    }
+
+    printf("Stopped watching %s, %lu files parsed\n", mp3watch -> root, mp3watch -> parsed);
+    free_watch(mp3watch);
+    return E_SUCCESS;
+}
+
+//Function to stop watching and release everything;
+void free_watch(MP3WATCH *mp3watch)
+{
+    size_t i;
+    for(i = 0; i < mp3watch -> nclients; i++)
+    {
+        close_client(&mp3watch -> clients[i]);
+    }
+    mp3watch -> nclients = 0;
+    if(mp3watch -> listen_fd >= 0)
+    {
+        close(mp3watch -> listen_fd);
+        unlink(mp3watch -> socket_path);
+        mp3watch -> listen_fd = -1;
+    }
+    if(mp3watch -> inotify_fd >= 0)
+    {
+        close(mp3watch -> inotify_fd);
+        mp3watch -> inotify_fd = -1;
+    }
+    for(i = 0; i < mp3watch -> nwatches; i++)
+    {
+        free(mp3watch -> watches[i]);
+    }
+    free(mp3watch -> watches);
+    mp3watch -> watches = NULL;
+    mp3watch -> nwatches = 0;
+    if(mp3watch -> index.buckets != NULL)
+    {
+        index_close(&mp3watch -> index);
+    }
+    arena_free(&mp3watch -> arena);
+    free(mp3watch -> root);
+    mp3watch -> root = NULL;
+}
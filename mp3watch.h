@@ -0,0 +1,113 @@
+/*
+File        : mp3watch.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the watch mode daemon.
+
+              This file contains the structure definitions and function
+              prototypes required to keep the tags of a whole library in
+              memory, follow changes with inotify and answer lookups over
+              a local Unix socket.
+
+              Key Components:
+               - WATCHCLIENT : One connected client, its partial request
+                               line and the answers the socket did not
+                               take yet.
+               - MP3WATCH    : The library root, the in-memory MP3INDEX,
+                               the inotify descriptor with the directory
+                               of every watch and the listening socket.
+
+              Watch Workflow:
+               1. User runs "./a.out -w <dir> -s <socket> [-i <index>]".
+               2. Every directory below <dir> gets an inotify watch and
+                  every ".mp3" file is parsed once (parse_mp3file()), or
+                  taken from the index file when it did not change.
+               3. A file is parsed again only when it is closed after a
+                  write or moved in; deleted and moved away files are
+                  dropped, new directories are watched and indexed. On a
+                  queue overflow the tree is checked again with stat().
+               4. Clients send one request per line and get JSON Lines
+                  records (see mp3format.h) followed by an empty line:
+                     GET <path>     the record of one file
+                     LIST [prefix]  every file whose path starts with prefix
+                     COUNT          {"files":<n>}
+
+              Notes:
+               - Paths are absolute (the root is resolved with realpath()).
+               - Everything runs on one thread around poll(); a lookup is
+                 a hash table probe, so answers take microseconds.
+               - Client sockets are non-blocking. What a client does not
+                 read stays in its output and is sent on POLLOUT; until
+                 it is sent no further request of that client is read or
+                 answered. A slow or stuck client holds at most one answer
+                 in memory and never stops the inotify events or the
+                 other clients.
+               - With -i the index file is kept up to date as well, so a
+                 restart only parses what changed while it was down.
+               - SIGINT / SIGTERM stop the daemon and remove the socket.
+*/
+#ifndef mp3watch_h
+#define mp3watch_h
+#include <stddef.h>
+#include "types.h"
+#include "arena.h"
+#include "mp3view.h"
+#include "mp3index.h"
+#include "outbuf.h"
+
+#define WATCH_MAX_CLIENTS 64
+#define WATCH_LINE_MAX 4096              // longest request line
+#define WATCH_EVENT_BUFFER (64 * 1024)   // bytes of inotify events read at a time
+#define WATCH_OUTPUT_KEEP (1024 * 1024)  // output buffer kept by a client after a large answer
+
+typedef struct watch_client
+{
+	int fd;                      // connected socket, non-blocking
+	size_t length;               // bytes of the request line read so far
+	char line[WATCH_LINE_MAX];
+	OUTBUF output;               // answers not yet taken by the socket, never flushed blocking
+	size_t sent;                 // bytes of output already written
+	int closing;                 // close once output is sent (request line too long)
+}WATCHCLIENT;
+
+typedef struct mp3watch
+{
+	char *root;                  // watched directory, absolute
+	char *socket_path;           // Unix socket the queries arrive on
+	char *index_fname;           // -i: index file kept in sync, NULL for memory only
+	MP3INDEX index;              // every file below root by path
+	int inotify_fd;
+	int listen_fd;
+	char **watches;              // directory of every watch descriptor, by descriptor
+	size_t nwatches;             // allocated entries in watches
+	WATCHCLIENT clients[WATCH_MAX_CLIENTS];
+	unsigned int nclients;
+	ARENA arena;                 // per-file memory of the parser
+	unsigned long parsed;        // files parsed since the start
+}MP3WATCH;
+
+//Function to read the watch options (-w <dir> -s <socket> [-i <index>]);
+status check_watch_args(int argc, char *argv[], MP3WATCH *mp3watch);
+
+//Function to run the daemon until it is stopped;
+status Mp3Watch(MP3WATCH *mp3watch);
+
+//Function to watch a directory tree and index every file in it;
+status watch_tree(MP3WATCH *mp3watch, const char *dir);
+
+//Function to parse a file again unless its index entry is still current;
+void update_file(MP3WATCH *mp3watch, const char *path);
+
+//Function to drop every file and watch below a path that went away;
+void forget_tree(MP3WATCH *mp3watch, const char *path);
+
+//Function to apply all pending inotify events;
+void handle_events(MP3WATCH *mp3watch);
+
+//Function to answer one request line;
+void answer_query(MP3WATCH *mp3watch, const char *line, OUTBUF *outbuf);
+
+//Function to stop watching and release everything;
+void free_watch(MP3WATCH *mp3watch);
+
+#endif
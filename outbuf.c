@@ -0,0 +1,289 @@
+/*
+File        : outbuf.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the buffered output writer.
+
+              This file contains the function definitions required to:
+               - Grow a per-writer buffer as records are appended
+               - Format text directly into the buffer
+               - Escape values for JSON strings and TSV fields; an SSE2
+                 loop finds the next byte that needs escaping, the runs
+                 in between are copied with one memcpy
+               - Write the buffer to its file descriptor under the
+                 shared lock, retrying short writes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include "outbuf.h"
+#include "stats.h"
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define OUTBUF_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const char hex_digits[] = "0123456789abcdef";
+
+//Function to make room for at least length more bytes;
+static status outbuf_reserve(OUTBUF *outbuf, size_t length)
+{
+    if(outbuf -> length + length <= outbuf -> allocated)
+    {
+        return E_SUCCESS;
+    }
+    size_t allocated = outbuf -> allocated ? outbuf -> allocated : 4096;
+    while(allocated < outbuf -> length + length)
+    {
+        allocated *= 2;
+    }
+    char *data = realloc(outbuf -> data, allocated);
+    if(data == NULL)
+    {
+        return E_FAILURE;
+    }
+    outbuf -> data = data;
+    outbuf -> allocated = allocated;
+    return E_SUCCESS;
+}
+
+//Function to set up a writer for a file descriptor;
+status outbuf_init(OUTBUF *outbuf, int fd, size_t capacity, pthread_mutex_t *lock)
+{
+    outbuf -> data = NULL;
+    outbuf -> length = 0;
+    outbuf -> allocated = 0;
+    outbuf -> capacity = capacity;
+    outbuf -> fd = fd;
+    outbuf -> lock = lock;
+    return outbuf_reserve(outbuf, capacity + capacity / 4);
+}
+
+//Function to append raw bytes;
+status outbuf_append(OUTBUF *outbuf, const char *data, size_t length)
+{
+    if(outbuf_reserve(outbuf, length) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    memcpy(outbuf -> data + outbuf -> length, data, length);
+    outbuf -> length += length;
+    return E_SUCCESS;
+}
+
+//Function to append formatted text;
+status outbuf_printf(OUTBUF *outbuf, const char *format, ...)
+{
+    va_list args;
+    size_t room = outbuf -> allocated - outbuf -> length;
+
+    va_start(args, format);
+    int length = vsnprintf(outbuf -> data + outbuf -> length, room, format, args);
+    va_end(args);
+    if(length < 0)
+    {
+        return E_FAILURE;
+    }
+    if((size_t)length >= room)
+    {
+        // did not fit: grow and format again
+        if(outbuf_reserve(outbuf, (size_t)length + 1) != E_SUCCESS)
+        {
+            return E_FAILURE;
+        }
+        va_start(args, format);
+        vsnprintf(outbuf -> data + outbuf -> length, (size_t)length + 1, format, args);
+        va_end(args);
+    }
+    outbuf -> length += length;
+    return E_SUCCESS;
+}
+
+//Function to count the leading bytes that can go into a JSON string as they are;
+static size_t json_span(const unsigned char *data, size_t length)
+{
+    size_t i = 0;
+#ifdef OUTBUF_SSE2
+    const __m128i control = _mm_set1_epi8(0x1F);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for(; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        // control characters are the bytes not above 0x1F (unsigned)
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(block, control), block),
+                                       _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+        int mask = _mm_movemask_epi8(special);
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while(i < length && data[i] >= 0x20 && data[i] != '"' && data[i] != '\\')
+    {
+        i++;
+    }
+    return i;
+}
+
+//Function to count the leading bytes that can go into a TSV field as they are;
+static size_t tsv_span(const unsigned char *data, size_t length)
+{
+    size_t i = 0;
+#ifdef OUTBUF_SSE2
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for(; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, tab), _mm_cmpeq_epi8(block, newline)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, backslash)));
+        int mask = _mm_movemask_epi8(special);
+        if(mask != 0)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while(i < length && data[i] != '\t' && data[i] != '\n' && data[i] != '\r' && data[i] != '\\')
+    {
+        i++;
+    }
+    return i;
+}
+
+/* Function to append text as the inside of a JSON string; room for the
+   worst case (every byte as \u00XX) is reserved once up front */
+status outbuf_append_json(OUTBUF *outbuf, const char *data, size_t length)
+{
+    const unsigned char *src = (const unsigned char *)data;
+    size_t i = 0;
+
+    if(outbuf_reserve(outbuf, 6 * length) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    char *dst = outbuf -> data + outbuf -> length;
+    while(i < length)
+    {
+        size_t run = json_span(src + i, length - i);
+        memcpy(dst, src + i, run);
+        dst += run;
+        i += run;
+        if(i == length)
+        {
+            break;
+        }
+        unsigned char c = src[i++];
+        *dst++ = '\\';
+        switch(c)
+        {
+            case '"':  *dst++ = '"';  break;
+            case '\\': *dst++ = '\\'; break;
+            case '\n': *dst++ = 'n';  break;
+            case '\r': *dst++ = 'r';  break;
+            case '\t': *dst++ = 't';  break;
+            default:
+                *dst++ = 'u';
+                *dst++ = '0';
+                *dst++ = '0';
+                *dst++ = hex_digits[c >> 4];
+                *dst++ = hex_digits[c & 0xF];
+        }
+    }
+    outbuf -> length = dst - outbuf -> data;
+    return E_SUCCESS;
+}
+
+//Function to append text as a TSV field with tab, newline, CR and backslash escaped;
+status outbuf_append_tsv(OUTBUF *outbuf, const char *data, size_t length)
+{
+    const unsigned char *src = (const unsigned char *)data;
+    size_t i = 0;
+
+    if(outbuf_reserve(outbuf, 2 * length) != E_SUCCESS)
+    {
+        return E_FAILURE;
+    }
+    char *dst = outbuf -> data + outbuf -> length;
+    while(i < length)
+    {
+        size_t run = tsv_span(src + i, length - i);
+        memcpy(dst, src + i, run);
+        dst += run;
+        i += run;
+        if(i == length)
+        {
+            break;
+        }
+        unsigned char c = src[i++];
+        *dst++ = '\\';
+        *dst++ = c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\';
+    }
+    outbuf -> length = dst - outbuf -> data;
+    return E_SUCCESS;
+}
+
+//Function to write the buffer out once it reached its capacity;
+status outbuf_maybe_flush(OUTBUF *outbuf)
+{
+    if(outbuf -> length < outbuf -> capacity)
+    {
+        return E_SUCCESS;
+    }
+    return outbuf_flush(outbuf);
+}
+
+//Function to write the buffered bytes to the file descriptor;
+status outbuf_flush(OUTBUF *outbuf)
+{
+    status ret = E_SUCCESS;
+    size_t done = 0;
+
+    if(outbuf -> length == 0)
+    {
+        return E_SUCCESS;
+    }
+    if(outbuf -> lock != NULL)
+    {
+        pthread_mutex_lock(outbuf -> lock);
+    }
+    while(done < outbuf -> length)
+    {
+        ssize_t bytes = write(outbuf -> fd, outbuf -> data + done, outbuf -> length - done);
+        STATS_IO(stat_bytes_written, bytes);
+        if(bytes < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            ret = E_FAILURE;
+            break;
+        }
+        done += bytes;
+    }
+    if(outbuf -> lock != NULL)
+    {
+        pthread_mutex_unlock(outbuf -> lock);
+    }
+    outbuf -> length = 0;
+    return ret;
+}
+
+//Function to flush and release the writer;
+status outbuf_free(OUTBUF *outbuf)
+{
+    status ret = outbuf_flush(outbuf);
+    free(outbuf -> data);
+    outbuf -> data = NULL;
+    outbuf -> allocated = 0;
+    return ret;
+}
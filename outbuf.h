@@ -0,0 +1,65 @@
+/*
+File        : outbuf.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the buffered output writer.
+
+              Worker threads format their results into their own OUTBUF
+              and only take the shared lock when a full buffer is written
+              out, so records from different threads never interleave and
+              threads do not contend on stdout for every line.
+
+              Key Components:
+               - OUTBUF : growable byte buffer bound to a file descriptor
+                          and an optional lock shared by all writers of
+                          that descriptor.
+
+              Notes:
+               - A record is always appended completely before the buffer
+                 is flushed, so one write() never splits a record.
+               - outbuf_append_json() and outbuf_append_tsv() escape a
+                 whole value in one call, copying clean runs in bulk.
+*/
+#ifndef outbuf_h
+#define outbuf_h
+#include <stddef.h>
+#include <pthread.h>
+#include "types.h"
+
+#define OUTBUF_SIZE (64 * 1024)   // flush threshold of a writer
+
+typedef struct outbuf
+{
+	char *data;              // buffered bytes
+	size_t length;           // number of bytes in data
+	size_t allocated;        // size of the data allocation
+	size_t capacity;         // flush once length reaches this
+	int fd;                  // destination file descriptor
+	pthread_mutex_t *lock;   // shared by every writer of fd, may be NULL
+}OUTBUF;
+
+//Function to set up a writer for a file descriptor;
+status outbuf_init(OUTBUF *outbuf, int fd, size_t capacity, pthread_mutex_t *lock);
+
+//Function to append raw bytes;
+status outbuf_append(OUTBUF *outbuf, const char *data, size_t length);
+
+//Function to append formatted text;
+status outbuf_printf(OUTBUF *outbuf, const char *format, ...);
+
+//Function to append text as the inside of a JSON string;
+status outbuf_append_json(OUTBUF *outbuf, const char *data, size_t length);
+
+//Function to append text as a TSV field with tab, newline, CR and backslash escaped;
+status outbuf_append_tsv(OUTBUF *outbuf, const char *data, size_t length);
+
+//Function to write the buffer out once it reached its capacity;
+status outbuf_maybe_flush(OUTBUF *outbuf);
+
+//Function to write the buffered bytes to the file descriptor;
+status outbuf_flush(OUTBUF *outbuf);
+
+//Function to flush and release the writer;
+status outbuf_free(OUTBUF *outbuf);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+File        : stats.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Implementation file for the built-in instrumentation.
+
+              This file contains the function definitions required to:
+               - Record phase latencies in log-linear histograms
+               - Add to the syscall, byte and allocation counters
+               - Read the --stats option
+               - Compute p50/p99 from the histograms and print them as a
+                 table or as JSON
+*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "stats.h"
+
+typedef struct
+{
+	unsigned long long buckets[STATS_BUCKETS];
+	unsigned long long count;
+	unsigned long long total;
+	unsigned long long max;
+}HISTOGRAM;
+
+StatsMode stats_mode = stats_off;
+
+static HISTOGRAM histograms[MAX_PHASES];
+static unsigned long long counters[MAX_COUNTERS];
+
+static const char *phase_names[MAX_PHASES] = {"open", "header", "read_tag", "write", "copy", "rename", "sync"};
+static const char *counter_names[MAX_COUNTERS] = {"syscalls", "bytes_read", "bytes_written", "mallocs", "arena_allocs"};
+
+//Function to read the monotonic clock in nanoseconds;
+unsigned long long stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Function to find the bucket of a value: values below 16 have their own
+   bucket, above that every power of two is split into 8 buckets */
+static unsigned int bucket_index(unsigned long long value)
+{
+    if(value < 16)
+    {
+        return (unsigned int)value;
+    }
+    unsigned int exponent = 63 - __builtin_clzll(value);
+    unsigned int sub = (value >> (exponent - 3)) & 7;
+    return 16 + (exponent - 4) * 8 + sub;
+}
+
+//Function to get the smallest value of a bucket;
+static unsigned long long bucket_value(unsigned int index)
+{
+    if(index < 16)
+    {
+        return index;
+    }
+    unsigned int exponent = (index - 16) / 8 + 4;
+    unsigned int sub = (index - 16) % 8;
+    return (8ULL + sub) << (exponent - 3);
+}
+
+//Function to record the latency of a phase that started at start;
+void stats_record(StatPhase phase, unsigned long long start)
+{
+    HISTOGRAM *histogram = &histograms[phase];
+    unsigned long long elapsed = stats_now() - start;
+    unsigned long long max = __atomic_load_n(&histogram -> max, __ATOMIC_RELAXED);
+
+    __atomic_fetch_add(&histogram -> buckets[bucket_index(elapsed)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram -> count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram -> total, elapsed, __ATOMIC_RELAXED);
+    while(elapsed > max &&
+          !__atomic_compare_exchange_n(&histogram -> max, &max, elapsed, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+//Function to add to a counter;
+void stats_add(StatCounter counter, unsigned long long value)
+{
+    __atomic_fetch_add(&counters[counter], value, __ATOMIC_RELAXED);
+}
+
+//Function to read --stats / --stats=json from the arguments and remove it;
+int stats_parse_args(int argc, char *argv[])
+{
+    int i, j = 1;
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--stats") == 0)
+        {
+            stats_mode = stats_summary;
+        }
+        else if(strcmp(argv[i], "--stats=json") == 0)
+        {
+            stats_mode = stats_json;
+        }
+        else
+        {
+            argv[j++] = argv[i];
+        }
+    }
+    argv[j] = NULL;
+    return j;
+}
+
+//Function to get the value below which a fraction of the samples fall;
+static unsigned long long percentile(const HISTOGRAM *histogram, double fraction)
+{
+    unsigned long long rank = (unsigned long long)(histogram -> count * fraction);
+    unsigned long long seen = 0;
+    unsigned int i;
+
+    if(rank >= histogram -> count)
+    {
+        rank = histogram -> count - 1;
+    }
+    for(i = 0; i < STATS_BUCKETS; i++)
+    {
+        seen += histogram -> buckets[i];
+        if(seen > rank)
+        {
+            unsigned long long value = bucket_value(i);
+            return value < histogram -> max ? value : histogram -> max;
+        }
+    }
+    return histogram -> max;
+}
+
+//Function to print all phases and counters;
+void stats_report(FILE *fptr, StatsMode mode)
+{
+    unsigned int i;
+
+    if(mode == stats_json)
+    {
+        fprintf(fptr, "{\"phases\":{");
+        for(i = 0; i < MAX_PHASES; i++)
+        {
+            const HISTOGRAM *histogram = &histograms[i];
+            fprintf(fptr, "%s\"%s\":{\"count\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"total_ns\":%llu}",
+                    i ? "," : "", phase_names[i], histogram -> count,
+                    histogram -> count ? percentile(histogram, 0.50) : 0,
+                    histogram -> count ? percentile(histogram, 0.99) : 0,
+                    histogram -> max, histogram -> total);
+        }
+        fprintf(fptr, "},\"counters\":{");
+        for(i = 0; i < MAX_COUNTERS; i++)
+        {
+            fprintf(fptr, "%s\"%s\":%llu", i ? "," : "", counter_names[i], counters[i]);
+        }
+        fprintf(fptr, "}}\n");
+        return;
+    }
+
+    fprintf(fptr, "------------------------------------------STATISTICS----------------------------------------------\n");
+    fprintf(fptr, "%-10s %10s %12s %12s %12s %12s\n", "phase", "count", "p50 (us)", "p99 (us)", "max (us)", "total (ms)");
+    for(i = 0; i < MAX_PHASES; i++)
+    {
+        const HISTOGRAM *histogram = &histograms[i];
+        if(histogram -> count == 0)
+        {
+            continue;
+        }
+        fprintf(fptr, "%-10s %10llu %12.1f %12.1f %12.1f %12.1f\n", phase_names[i], histogram -> count,
+                percentile(histogram, 0.50) / 1e3, percentile(histogram, 0.99) / 1e3,
+                histogram -> max / 1e3, histogram -> total / 1e6);
+    }
+    for(i = 0; i < MAX_COUNTERS; i++)
+    {
+        fprintf(fptr, "%-15s: %llu\n", counter_names[i], counters[i]);
+    }
+    fprintf(fptr, "-------------------------------------------------------------------------------------------------\n");
+}
+
+//Function to print the report to stderr at exit;
+void stats_print_at_exit(void)
+{
+    fflush(stdout);
+    stats_report(stderr, stats_mode);
+}
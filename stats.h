@@ -0,0 +1,91 @@
+/*
+File        : stats.h
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Header file for the built-in instrumentation (--stats).
+
+              Key Components:
+               - StatPhase  : Timed steps of viewing and editing a file:
+                              opening it, the ID3 header check, reading
+                              the tag, writing the tag, copying the audio
+                              and the final rename().
+               - StatCounter: Syscalls, bytes read and written, heap
+                              allocations and arena allocations.
+               - Histogram  : Every phase keeps a log-linear histogram of
+                              its latencies (8 sub buckets per power of
+                              two, so any percentile is within 12.5%),
+                              its count, total and maximum.
+
+              Usage:
+               - STATS_BEGIN(t) / STATS_END(phase, t) time a phase,
+                 STATS_IO() counts one syscall and its bytes and
+                 STATS_COUNT() adds to any counter.
+               - All updates are relaxed atomics, so worker threads share
+                 the same tables.
+               - When --stats is not given every macro is a single test
+                 of stats_mode, no clock is read and nothing is counted.
+               - stats_report() prints p50/p99/max per phase and the
+                 counters, as a table or as one JSON object.
+*/
+#ifndef stats_h
+#define stats_h
+#include <stdio.h>
+
+#define STATS_BUCKETS 512
+
+typedef enum
+{
+	phase_open,          // fopen() of the input file
+	phase_header,        // reading and checking the ID3 header
+	phase_read_tag,      // mapping or reading the tag body
+	phase_write,         // writing the new tag
+	phase_copy,          // copying the audio data (tag grew)
+	phase_rename,        // replacing the original file
+	phase_sync,          // fsync/fdatasync/syncfs of edited files
+	MAX_PHASES
+}StatPhase;
+
+typedef enum
+{
+	stat_syscalls,       // I/O and file system syscalls
+	stat_bytes_read,
+	stat_bytes_written,
+	stat_mallocs,        // heap allocations
+	stat_arena_allocs,   // allocations served by an arena
+	MAX_COUNTERS
+}StatCounter;
+
+typedef enum
+{
+	stats_off,
+	stats_summary,       // --stats
+	stats_json           // --stats=json
+}StatsMode;
+
+extern StatsMode stats_mode;
+
+#define STATS_BEGIN(name) unsigned long long name = stats_mode != stats_off ? stats_now() : 0
+#define STATS_END(phase, name) do { if(stats_mode != stats_off) stats_record(phase, name); } while(0)
+#define STATS_COUNT(counter, value) do { if(stats_mode != stats_off) stats_add(counter, value); } while(0)
+#define STATS_IO(counter, bytes) do { if(stats_mode != stats_off) { stats_add(stat_syscalls, 1); \
+                                      if((long long)(bytes) > 0) stats_add(counter, bytes); } } while(0)
+
+//Function to read the monotonic clock in nanoseconds;
+unsigned long long stats_now(void);
+
+//Function to record the latency of a phase that started at start;
+void stats_record(StatPhase phase, unsigned long long start);
+
+//Function to add to a counter;
+void stats_add(StatCounter counter, unsigned long long value);
+
+//Function to read --stats / --stats=json from the arguments and remove it;
+int stats_parse_args(int argc, char *argv[]);
+
+//Function to print all phases and counters;
+void stats_report(FILE *fptr, StatsMode mode);
+
+//Function to print the report to stderr at exit;
+void stats_print_at_exit(void);
+
+#endif
@@ -0,0 +1,386 @@
+/*
+File        : genframes.c
+Author      : G C Phaneendra
+Roll No     : 25008_031
+Description : Generator of the frame id table (id3frametable.h).
+
+              Holds the list of every ID3v2.2, v2.3 and v2.4 frame id the
+              program knows, with the versions that define it, the way
+              its payload is decoded and its v2.3/v2.4 equivalent, and
+              writes them as a perfect hash table for id3frames.c.
+
+              Perfect Hash:
+               slot = (id * multiplier) >> (32 - bits)
+               The smallest table (bits) for which a multiplier puts every
+               id into its own slot is searched, multipliers are drawn
+               from a fixed seeded xorshift generator so the output is
+               the same on every run. A lookup is then one multiply, one
+               load and one compare, whatever the number of ids.
+
+              Usage:
+                  genframes > id3frametable.h
+                  (run by make when this file changes)
+
+              Notes:
+               - v2.2 ids have 3 characters; as integers they are the 3
+                 characters followed by a zero byte, so they never clash
+                 with a 4 character id.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define V22 0x01
+#define V23 0x02
+#define V24 0x04
+#define MAX_BITS 16
+#define MAX_TRIES (1U << 22)
+
+typedef struct frame_def
+{
+    const char *id;         // 3 or 4 characters
+    unsigned int versions;  // V22 | V23 | V24
+    const char *kind;       // FrameKind name in id3frames.h
+    const char *canonical;  // v2.3/v2.4 id of a v2.2 frame, NULL if it is the same or has none
+    const char *label;      // label of the viewer, NULL to show the id
+}FRAMEDEF;
+
+static const FRAMEDEF frames[] =
+{
+    // v2.3 and v2.4
+    {"AENC", V23 | V24, "frame_binary", NULL, NULL},
+    {"APIC", V23 | V24, "frame_binary", NULL, NULL},
+    {"COMM", V23 | V24, "frame_comment", NULL, "COMMENT"},
+    {"COMR", V23 | V24, "frame_binary", NULL, NULL},
+    {"ENCR", V23 | V24, "frame_binary", NULL, NULL},
+    {"ETCO", V23 | V24, "frame_binary", NULL, NULL},
+    {"GEOB", V23 | V24, "frame_binary", NULL, NULL},
+    {"GRID", V23 | V24, "frame_binary", NULL, NULL},
+    {"LINK", V23 | V24, "frame_binary", NULL, NULL},
+    {"MCDI", V23 | V24, "frame_binary", NULL, NULL},
+    {"MLLT", V23 | V24, "frame_binary", NULL, NULL},
+    {"OWNE", V23 | V24, "frame_binary", NULL, NULL},
+    {"PCNT", V23 | V24, "frame_binary", NULL, NULL},
+    {"POPM", V23 | V24, "frame_binary", NULL, NULL},
+    {"POSS", V23 | V24, "frame_binary", NULL, NULL},
+    {"PRIV", V23 | V24, "frame_binary", NULL, NULL},
+    {"RBUF", V23 | V24, "frame_binary", NULL, NULL},
+    {"RVRB", V23 | V24, "frame_binary", NULL, NULL},
+    {"SYLT", V23 | V24, "frame_binary", NULL, NULL},
+    {"SYTC", V23 | V24, "frame_binary", NULL, NULL},
+    {"TALB", V23 | V24, "frame_text", NULL, "ALBUM"},
+    {"TBPM", V23 | V24, "frame_text", NULL, NULL},
+    {"TCOM", V23 | V24, "frame_text", NULL, NULL},
+    {"TCON", V23 | V24, "frame_text", NULL, "MUSIC"},
+    {"TCOP", V23 | V24, "frame_text", NULL, NULL},
+    {"TDLY", V23 | V24, "frame_text", NULL, NULL},
+    {"TENC", V23 | V24, "frame_text", NULL, NULL},
+    {"TEXT", V23 | V24, "frame_text", NULL, NULL},
+    {"TFLT", V23 | V24, "frame_text", NULL, NULL},
+    {"TIT1", V23 | V24, "frame_text", NULL, NULL},
+    {"TIT2", V23 | V24, "frame_text", NULL, "TITLE"},
+    {"TIT3", V23 | V24, "frame_text", NULL, NULL},
+    {"TKEY", V23 | V24, "frame_text", NULL, NULL},
+    {"TLAN", V23 | V24, "frame_text", NULL, NULL},
+    {"TLEN", V23 | V24, "frame_text", NULL, NULL},
+    {"TMED", V23 | V24, "frame_text", NULL, NULL},
+    {"TOAL", V23 | V24, "frame_text", NULL, NULL},
+    {"TOFN", V23 | V24, "frame_text", NULL, NULL},
+    {"TOLY", V23 | V24, "frame_text", NULL, NULL},
+    {"TOPE", V23 | V24, "frame_text", NULL, NULL},
+    {"TOWN", V23 | V24, "frame_text", NULL, NULL},
+    {"TPE1", V23 | V24, "frame_text", NULL, "ARTIST"},
+    {"TPE2", V23 | V24, "frame_text", NULL, NULL},
+    {"TPE3", V23 | V24, "frame_text", NULL, NULL},
+    {"TPE4", V23 | V24, "frame_text", NULL, NULL},
+    {"TPOS", V23 | V24, "frame_text", NULL, NULL},
+    {"TPUB", V23 | V24, "frame_text", NULL, NULL},
+    {"TRCK", V23 | V24, "frame_text", NULL, NULL},
+    {"TRSN", V23 | V24, "frame_text", NULL, NULL},
+    {"TRSO", V23 | V24, "frame_text", NULL, NULL},
+    {"TSRC", V23 | V24, "frame_text", NULL, NULL},
+    {"TSSE", V23 | V24, "frame_text", NULL, NULL},
+    {"TXXX", V23 | V24, "frame_user_text", NULL, NULL},
+    {"UFID", V23 | V24, "frame_binary", NULL, NULL},
+    {"USER", V23 | V24, "frame_binary", NULL, NULL},
+    {"USLT", V23 | V24, "frame_comment", NULL, NULL},
+    {"WCOM", V23 | V24, "frame_url", NULL, NULL},
+    {"WCOP", V23 | V24, "frame_url", NULL, NULL},
+    {"WOAF", V23 | V24, "frame_url", NULL, NULL},
+    {"WOAR", V23 | V24, "frame_url", NULL, NULL},
+    {"WOAS", V23 | V24, "frame_url", NULL, NULL},
+    {"WORS", V23 | V24, "frame_url", NULL, NULL},
+    {"WPAY", V23 | V24, "frame_url", NULL, NULL},
+    {"WPUB", V23 | V24, "frame_url", NULL, NULL},
+    {"WXXX", V23 | V24, "frame_user_url", NULL, NULL},
+
+    // v2.3 only
+    {"EQUA", V23, "frame_binary", NULL, NULL},
+    {"IPLS", V23, "frame_text", NULL, NULL},
+    {"RVAD", V23, "frame_binary", NULL, NULL},
+    {"TDAT", V23, "frame_text", NULL, NULL},
+    {"TIME", V23, "frame_text", NULL, NULL},
+    {"TORY", V23, "frame_text", NULL, NULL},
+    {"TRDA", V23, "frame_text", NULL, NULL},
+    {"TSIZ", V23, "frame_text", NULL, NULL},
+    {"TYER", V23, "frame_text", NULL, "YEAR"},
+
+    // v2.4 only
+    {"ASPI", V24, "frame_binary", NULL, NULL},
+    {"EQU2", V24, "frame_binary", NULL, NULL},
+    {"RVA2", V24, "frame_binary", NULL, NULL},
+    {"SEEK", V24, "frame_binary", NULL, NULL},
+    {"SIGN", V24, "frame_binary", NULL, NULL},
+    {"TDEN", V24, "frame_text", NULL, NULL},
+    {"TDOR", V24, "frame_text", NULL, NULL},
+    {"TDRC", V24, "frame_text", NULL, NULL},
+    {"TDRL", V24, "frame_text", NULL, NULL},
+    {"TDTG", V24, "frame_text", NULL, NULL},
+    {"TIPL", V24, "frame_text", NULL, NULL},
+    {"TMCL", V24, "frame_text", NULL, NULL},
+    {"TMOO", V24, "frame_text", NULL, NULL},
+    {"TPRO", V24, "frame_text", NULL, NULL},
+    {"TSOA", V24, "frame_text", NULL, NULL},
+    {"TSOP", V24, "frame_text", NULL, NULL},
+    {"TSOT", V24, "frame_text", NULL, NULL},
+    {"TSST", V24, "frame_text", NULL, NULL},
+
+    // not in the standard but written by common taggers
+    {"GRP1", V23 | V24, "frame_text", NULL, NULL},
+    {"MVIN", V23 | V24, "frame_text", NULL, NULL},
+    {"MVNM", V23 | V24, "frame_text", NULL, NULL},
+    {"PCST", V23 | V24, "frame_binary", NULL, NULL},
+    {"TCAT", V23 | V24, "frame_text", NULL, NULL},
+    {"TCMP", V23 | V24, "frame_text", NULL, NULL},
+    {"TDES", V23 | V24, "frame_text", NULL, NULL},
+    {"TGID", V23 | V24, "frame_text", NULL, NULL},
+    {"TKWD", V23 | V24, "frame_text", NULL, NULL},
+    {"TSO2", V23 | V24, "frame_text", NULL, NULL},
+    {"TSOC", V23 | V24, "frame_text", NULL, NULL},
+    {"WFED", V23 | V24, "frame_url", NULL, NULL},
+
+    // v2.2
+    {"BUF", V22, "frame_binary", "RBUF", NULL},
+    {"CNT", V22, "frame_binary", "PCNT", NULL},
+    {"COM", V22, "frame_comment", "COMM", NULL},
+    {"CRA", V22, "frame_binary", "AENC", NULL},
+    {"CRM", V22, "frame_binary", NULL, NULL},
+    {"EQU", V22, "frame_binary", "EQUA", NULL},
+    {"ETC", V22, "frame_binary", "ETCO", NULL},
+    {"GEO", V22, "frame_binary", "GEOB", NULL},
+    {"IPL", V22, "frame_text", "IPLS", NULL},
+    {"LNK", V22, "frame_binary", "LINK", NULL},
+    {"MCI", V22, "frame_binary", "MCDI", NULL},
+    {"MLL", V22, "frame_binary", "MLLT", NULL},
+    {"PIC", V22, "frame_binary", "APIC", NULL},
+    {"POP", V22, "frame_binary", "POPM", NULL},
+    {"REV", V22, "frame_binary", "RVRB", NULL},
+    {"RVA", V22, "frame_binary", "RVAD", NULL},
+    {"SLT", V22, "frame_binary", "SYLT", NULL},
+    {"STC", V22, "frame_binary", "SYTC", NULL},
+    {"TAL", V22, "frame_text", "TALB", NULL},
+    {"TBP", V22, "frame_text", "TBPM", NULL},
+    {"TCM", V22, "frame_text", "TCOM", NULL},
+    {"TCO", V22, "frame_text", "TCON", NULL},
+    {"TCP", V22, "frame_text", "TCMP", NULL},
+    {"TCR", V22, "frame_text", "TCOP", NULL},
+    {"TDA", V22, "frame_text", "TDAT", NULL},
+    {"TDY", V22, "frame_text", "TDLY", NULL},
+    {"TEN", V22, "frame_text", "TENC", NULL},
+    {"TFT", V22, "frame_text", "TFLT", NULL},
+    {"TIM", V22, "frame_text", "TIME", NULL},
+    {"TKE", V22, "frame_text", "TKEY", NULL},
+    {"TLA", V22, "frame_text", "TLAN", NULL},
+    {"TLE", V22, "frame_text", "TLEN", NULL},
+    {"TMT", V22, "frame_text", "TMED", NULL},
+    {"TOA", V22, "frame_text", "TOPE", NULL},
+    {"TOF", V22, "frame_text", "TOFN", NULL},
+    {"TOL", V22, "frame_text", "TOLY", NULL},
+    {"TOR", V22, "frame_text", "TORY", NULL},
+    {"TOT", V22, "frame_text", "TOAL", NULL},
+    {"TP1", V22, "frame_text", "TPE1", NULL},
+    {"TP2", V22, "frame_text", "TPE2", NULL},
+    {"TP3", V22, "frame_text", "TPE3", NULL},
+    {"TP4", V22, "frame_text", "TPE4", NULL},
+    {"TPA", V22, "frame_text", "TPOS", NULL},
+    {"TPB", V22, "frame_text", "TPUB", NULL},
+    {"TRC", V22, "frame_text", "TSRC", NULL},
+    {"TRD", V22, "frame_text", "TRDA", NULL},
+    {"TRK", V22, "frame_text", "TRCK", NULL},
+    {"TS2", V22, "frame_text", "TSO2", NULL},
+    {"TSA", V22, "frame_text", "TSOA", NULL},
+    {"TSC", V22, "frame_text", "TSOC", NULL},
+    {"TSI", V22, "frame_text", "TSIZ", NULL},
+    {"TSP", V22, "frame_text", "TSOP", NULL},
+    {"TSS", V22, "frame_text", "TSSE", NULL},
+    {"TST", V22, "frame_text", "TSOT", NULL},
+    {"TT1", V22, "frame_text", "TIT1", NULL},
+    {"TT2", V22, "frame_text", "TIT2", NULL},
+    {"TT3", V22, "frame_text", "TIT3", NULL},
+    {"TXT", V22, "frame_text", "TEXT", NULL},
+    {"TXX", V22, "frame_user_text", "TXXX", NULL},
+    {"TYE", V22, "frame_text", "TYER", NULL},
+    {"UFI", V22, "frame_binary", "UFID", NULL},
+    {"ULT", V22, "frame_comment", "USLT", NULL},
+    {"WAF", V22, "frame_url", "WOAF", NULL},
+    {"WAR", V22, "frame_url", "WOAR", NULL},
+    {"WAS", V22, "frame_url", "WOAS", NULL},
+    {"WCM", V22, "frame_url", "WCOM", NULL},
+    {"WCP", V22, "frame_url", "WCOP", NULL},
+    {"WPB", V22, "frame_url", "WPUB", NULL},
+    {"WXX", V22, "frame_user_url", "WXXX", NULL},
+};
+
+#define NFRAMES (sizeof(frames) / sizeof(frames[0]))
+
+static unsigned int rng_state = 2463534242U;
+
+//Function to get the next pseudo random number;
+static unsigned int next_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+//Function to turn 3 or 4 characters into the frame id integer;
+static unsigned int id_value(const char *id)
+{
+    return (unsigned int)(unsigned char)id[0] << 24 | (unsigned int)(unsigned char)id[1] << 16 |
+           (unsigned int)(unsigned char)id[2] << 8 | (unsigned int)(unsigned char)id[3];
+}
+
+//Function to print a frame id as a FRAME_ID() expression;
+static void print_id(const char *id)
+{
+    if(strlen(id) == 3)
+    {
+        printf("FRAME_ID('%c', '%c', '%c', 0)", id[0], id[1], id[2]);
+    }
+    else
+    {
+        printf("FRAME_ID('%c', '%c', '%c', '%c')", id[0], id[1], id[2], id[3]);
+    }
+}
+
+//Function to check that a multiplier gives every id its own slot;
+static int is_perfect(unsigned int multiplier, unsigned int bits, unsigned int *slots, unsigned char *used)
+{
+    unsigned int i;
+    memset(used, 0, 1U << bits);
+    for(i = 0; i < NFRAMES; i++)
+    {
+        unsigned int slot = (id_value(frames[i].id) * multiplier) >> (32 - bits);
+        if(used[slot])
+        {
+            return 0;
+        }
+        used[slot] = 1;
+        slots[i] = slot;
+    }
+    return 1;
+}
+
+int main(void)
+{
+    unsigned int slots[NFRAMES], multiplier = 0, bits, tries, i, j;
+    unsigned char *used = malloc(1U << MAX_BITS);
+    int found = 0;
+
+    if(used == NULL)
+    {
+        return 1;
+    }
+    // duplicate ids would never hash apart
+    for(i = 0; i < NFRAMES; i++)
+    {
+        for(j = i + 1; j < NFRAMES; j++)
+        {
+            if(strcmp(frames[i].id, frames[j].id) == 0)
+            {
+                fprintf(stderr, "genframes: %s is listed twice\n", frames[i].id);
+                return 1;
+            }
+        }
+    }
+    for(bits = 1; (1U << bits) < NFRAMES; bits++)
+    {
+    }
+    for(; bits <= MAX_BITS && !found; bits++)
+    {
+        for(tries = 0; tries < MAX_TRIES && !found; tries++)
+        {
+            multiplier = next_random() | 1;
+            found = is_perfect(multiplier, bits, slots, used);
+        }
+    }
+    free(used);
+    if(!found)
+    {
+        fprintf(stderr, "genframes: no perfect hash found\n");
+        return 1;
+    }
+    bits--;
+
+    printf("/*\n");
+    printf("File        : id3frametable.h\n");
+    printf("Author      : G C Phaneendra\n");
+    printf("Roll No     : 25008_031\n");
+    printf("Description : Frame id table, generated by tools/genframes.c; do not edit.\n");
+    printf("\n");
+    printf("              %u frame ids in a perfect hash of %u slots:\n", (unsigned int)NFRAMES, 1U << bits);
+    printf("               slot = (id * FRAME_HASH_MULTIPLIER) >> FRAME_HASH_SHIFT\n");
+    printf("              Included by id3frames.c only.\n");
+    printf("*/\n");
+    printf("#ifndef id3frametable_h\n");
+    printf("#define id3frametable_h\n\n");
+    printf("#define FRAME_HASH_MULTIPLIER 0x%08XU\n", multiplier);
+    printf("#define FRAME_HASH_SHIFT %u\n", 32 - bits);
+    printf("#define FRAME_HASH_SIZE %u\n\n", 1U << bits);
+
+    printf("static const FRAMEDETAIL frame_details[%u] =\n{\n", (unsigned int)NFRAMES);
+    for(i = 0; i < NFRAMES; i++)
+    {
+        printf("    {\"%s\", ", frames[i].id);
+        if(frames[i].canonical != NULL)
+        {
+            print_id(frames[i].canonical);
+        }
+        else
+        {
+            print_id(frames[i].id);
+        }
+        if(frames[i].label != NULL)
+        {
+            printf(", \"%s\"},\n", frames[i].label);
+        }
+        else
+        {
+            printf(", NULL},\n");
+        }
+    }
+    printf("};\n\n");
+
+    printf("static const FRAMESLOT frame_slots[FRAME_HASH_SIZE] =\n{\n");
+    for(i = 0; i < (1U << bits); i++)
+    {
+        for(j = 0; j < NFRAMES && slots[j] != i; j++)
+        {
+        }
+        if(j == NFRAMES)
+        {
+            continue;
+        }
+        printf("    [%u] = {", i);
+        print_id(frames[j].id);
+        printf(", %s%s%s, %s, %u},\n",
+               frames[j].versions & V22 ? "ID3_V22" : "",
+               frames[j].versions & V23 ? (frames[j].versions & V22 ? " | ID3_V23" : "ID3_V23") : "",
+               frames[j].versions & V24 ? (frames[j].versions & (V22 | V23) ? " | ID3_V24" : "ID3_V24") : "",
+               frames[j].kind, j);
+    }
+    printf("};\n\n");
+    printf("#endif\n");
+    return 0;
+}
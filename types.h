@@ -13,7 +13,17 @@ Description : Common type definitions and enumerations used across
                2. OperationType
                   - Enumerates the types of operations the program can perform:
                       view_mp3tags  : View existing ID3v2 tags in the MP3 file
+                      scan_mp3tags  : View the tags of every MP3 file below
+                                      a directory using worker threads
                       edit_mp3tags  : Edit specific ID3v2 tags in the MP3 file
+                      batch_edit_mp3tags : Apply a CSV/TSV manifest of edits
+                                      to many files with worker threads
+                      watch_mp3tags : Keep the tags of a directory tree in
+                                      memory and answer socket queries
+                      dup_mp3files  : Find files below a directory that hold
+                                      the same audio, ignoring their tags
+                      query_mp3tags : Answer exact, prefix and AND queries
+                                      on artist, album, genre and year
                       Help_menu     : Display usage/help instructions
                       unsupported   : Invalid or unrecognized command
 
@@ -33,7 +43,12 @@ typedef enum
 typedef enum
 {
 	view_mp3tags,
+	scan_mp3tags,
 	edit_mp3tags,
+	batch_edit_mp3tags,
+	watch_mp3tags,
+	dup_mp3files,
+	query_mp3tags,
 	Help_menu,
 	unsupported
 } OperationType;